@@ -0,0 +1,118 @@
+#include "lanimation.hpp"
+
+#include <gsl/gsl_util>
+
+namespace {
+
+/*
+pre-conditions:
+    * length is positive
+post-conditions:
+    * returns t wrapped into [0, length), negative t counting back from
+      length
+side-effects: n/a
+*/
+GLfloat
+wrap(GLfloat t, GLfloat length)
+{
+    // truncation keeps the loop vectorized, the selects fix up negative t
+    // and rounding at either end
+    const auto laps = static_cast<GLint>(t / length);
+    t -= length * static_cast<GLfloat>(laps);
+    t = t < 0.f ? t + length : t;
+    return t < length ? t : 0.f;
+}
+
+} // namespace
+
+GLuint
+lanimation_set::add_animation(const lanimation& animation)
+{
+    _first_clip.push_back(gsl::narrow<GLint>(_clips.size()));
+    _frame_count.push_back(gsl::narrow<GLfloat>(animation.frames.size()));
+    _frame_rate.push_back(animation.frames_per_second);
+
+    _clips.insert(
+        std::end(_clips),
+        std::begin(animation.frames),
+        std::end(animation.frames));
+
+    return gsl::narrow<GLuint>(_first_clip.size() - 1);
+}
+
+std::size_t
+lanimation_set::add_instance(
+    GLuint animation, GLfloat speed, GLfloat phase)
+{
+    const GLfloat t = wrap(phase, _frame_count[animation]);
+    _time.push_back(t);
+    _rate.push_back(_frame_rate[animation] * speed);
+    _length.push_back(_frame_count[animation]);
+    _first.push_back(_first_clip[animation]);
+    _clip.push_back(_first_clip[animation] + static_cast<GLint>(t));
+
+    return _time.size() - 1;
+}
+
+void
+lanimation_set::reserve(std::size_t count)
+{
+    _time.reserve(count);
+    _rate.reserve(count);
+    _length.reserve(count);
+    _first.reserve(count);
+    _clip.reserve(count);
+}
+
+void
+lanimation_set::clear_instances()
+{
+    _time.clear();
+    _rate.clear();
+    _length.clear();
+    _first.clear();
+    _clip.clear();
+}
+
+std::size_t
+lanimation_set::size() const
+{
+    return _time.size();
+}
+
+const lfrect&
+lanimation_set::clip(std::size_t instance) const
+{
+    return _clips[gsl::narrow_cast<std::size_t>(_clip[instance])];
+}
+
+GLuint
+lanimation_set::frame(std::size_t instance) const
+{
+    return gsl::narrow_cast<GLuint>(_clip[instance] - _first[instance]);
+}
+
+void
+lanimation_set::update(GLfloat dt)
+{
+    update(dt, 0, size());
+}
+
+void
+lanimation_set::update(GLfloat dt, std::size_t begin, std::size_t end)
+{
+    // hoist storage out of the loop so it compiles to a vectorized loop
+    GLfloat* const       time   = _time.data();
+    const GLfloat* const rate   = _rate.data();
+    const GLfloat* const length = _length.data();
+    const GLint* const   first  = _first.data();
+    GLint* const         clip   = _clip.data();
+
+    for (std::size_t i = begin; i < end; ++i) {
+        // advance and wrap around sequence length, either way
+        const GLfloat t = wrap(time[i] + dt * rate[i], length[i]);
+
+        time[i] = t;
+        clip[i] = first[i] + static_cast<GLint>(t);
+    }
+}
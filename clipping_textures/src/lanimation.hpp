@@ -0,0 +1,129 @@
+#ifndef LANIMATION_HPP
+#define LANIMATION_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "lopengl.hpp"
+#include "lrect.hpp"
+
+/*
+A frame sequence: clips within a sprite sheet which are played back in order
+and looped.
+*/
+struct lanimation {
+    // frame clips, {x, y, w, h} in pixels
+    std::vector<lfrect> frames;
+
+    // playback speed
+    GLfloat frames_per_second = {1.f};
+};
+
+/*
+Plays back many animated sprites sharing one sprite sheet. Playback state is
+kept as a structure of arrays, so the bulk update touches only contiguous
+values and compiles to a vectorized loop. Positions and drawing belong to the
+scene, which takes each instance's clip or frame.
+*/
+class lanimation_set {
+    // clips of all added animations, flattened
+    std::vector<lfrect> _clips;
+
+    // per-animation data
+    std::vector<GLint>   _first_clip;
+    std::vector<GLfloat> _frame_count;
+    std::vector<GLfloat> _frame_rate;
+
+    // per-instance data
+    std::vector<GLfloat> _time;   // playback position in frames
+    std::vector<GLfloat> _rate;   // frames per second
+    std::vector<GLfloat> _length; // frames in sequence
+    std::vector<GLint>   _first;  // first clip of sequence
+    std::vector<GLint>   _clip;   // current clip
+
+public:
+    /*
+    pre-conditions:
+        * animation has at least one frame
+    post-conditions:
+        * stores frame clips of the animation
+        * returns animation index to create instances with
+    side-effects: n/a
+    */
+    GLuint add_animation(const lanimation&);
+
+    /*
+    pre-conditions:
+        * animation index was returned by add_animation
+    post-conditions:
+        * adds an instance starting at the given frame
+          wrapped into the animation
+        * speed multiplies the animation frame rate, negative speeds play
+          the animation backwards
+        * returns instance index
+    side-effects: n/a
+    */
+    std::size_t add_instance(
+        GLuint animation, GLfloat speed = 1.f, GLfloat phase = 0.f);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * reserves storage for the given number of instances
+    side-effects: n/a
+    */
+    void reserve(std::size_t);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * removes all instances, keeps animations
+    side-effects: n/a
+    */
+    void clear_instances();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of instances
+    side-effects: n/a
+    */
+    std::size_t size() const;
+
+    /*
+    pre-conditions:
+        * valid instance index
+    post-conditions: returns current clip of the instance
+    side-effects: n/a
+    */
+    const lfrect& clip(std::size_t) const;
+
+    /*
+    pre-conditions:
+        * valid instance index
+    post-conditions:
+        * returns current frame of the instance within its animation, the
+          layer to draw when the frames are layers of a texture array
+    side-effects: n/a
+    */
+    GLuint frame(std::size_t) const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * advances all instances by given seconds and picks their clips
+    side-effects: n/a
+    */
+    void update(GLfloat dt);
+
+    /*
+    pre-conditions:
+        * begin <= end <= size()
+    post-conditions:
+        * advances instances [begin, end) by given seconds
+        * disjoint ranges may be updated concurrently
+    side-effects: n/a
+    */
+    void update(GLfloat dt, std::size_t begin, std::size_t end);
+};
+
+#endif // LANIMATION_HPP
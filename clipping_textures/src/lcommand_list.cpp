@@ -0,0 +1,101 @@
+#include "lcommand_list.hpp"
+
+#include <gsl/gsl_util>
+
+#include "ltexture_array.hpp"
+
+void
+lcommand_list::reset(std::size_t quads)
+{
+    _vertices.resize(quads * 8);
+    _texcoords.resize(quads * 12);
+    _colors.resize(quads * 16);
+    _draws.clear();
+}
+
+std::size_t
+lcommand_list::quads() const
+{
+    return _vertices.size() / 8;
+}
+
+GLfloat*
+lcommand_list::vertices(std::size_t quad)
+{
+    return &_vertices[quad * 8];
+}
+
+GLfloat*
+lcommand_list::texcoords(std::size_t quad)
+{
+    return &_texcoords[quad * 12];
+}
+
+GLfloat*
+lcommand_list::colors(std::size_t quad)
+{
+    return &_colors[quad * 16];
+}
+
+void
+lcommand_list::draw(
+    GLuint texture, std::size_t first, std::size_t count, GLenum target)
+{
+    if (!_draws.empty()) {
+        auto& last = _draws.back();
+        if (last.texture == texture && last.target == target &&
+            last.first + last.count == first) {
+            last.count += count;
+            return;
+        }
+    }
+
+    _draws.push_back({texture, first, count, target});
+}
+
+std::size_t
+lcommand_list::draws() const
+{
+    return _draws.size();
+}
+
+void
+lcommand_list::replay() const
+{
+    if (_draws.empty()) return;
+
+    // remove any previous transformations
+    glLoadIdentity();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, _vertices.data());
+    glTexCoordPointer(3, GL_FLOAT, 0, _texcoords.data());
+    glColorPointer(4, GL_FLOAT, 0, _colors.data());
+
+    GLenum target = GL_TEXTURE_2D;
+    for (const auto& draw : _draws) {
+        // switch to the array program and back as needed
+        if (draw.target == GL_TEXTURE_2D_ARRAY) {
+            ltexture_array::bind(draw.texture);
+        } else {
+            if (target == GL_TEXTURE_2D_ARRAY) ltexture_array::unbind();
+            glBindTexture(GL_TEXTURE_2D, draw.texture);
+        }
+        target = draw.target;
+
+        glDrawArrays(
+            GL_QUADS,
+            gsl::narrow<GLint>(draw.first * 4),
+            gsl::narrow<GLsizei>(draw.count * 4));
+    }
+    if (target == GL_TEXTURE_2D_ARRAY) ltexture_array::unbind();
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    // color array leaves current color undefined
+    glColor4f(1.f, 1.f, 1.f, 1.f);
+}
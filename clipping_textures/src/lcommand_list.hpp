@@ -0,0 +1,99 @@
+#ifndef LCOMMAND_LIST_HPP
+#define LCOMMAND_LIST_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "lopengl.hpp"
+
+/*
+Draws a range of quads with a texture, either a GL_TEXTURE_2D or a
+GL_TEXTURE_2D_ARRAY whose layers the quads select.
+*/
+struct ldraw_command {
+    GLuint      texture = {0};
+    std::size_t first   = {0};
+    std::size_t count   = {0};
+    GLenum      target  = {GL_TEXTURE_2D};
+};
+
+/*
+Recorded render commands of a frame: textured, tinted quads in screen space
+plus the draw commands referencing them. Recording touches no GL state, so it
+can happen on any thread; only replay needs the GL context.
+*/
+class lcommand_list {
+    // 4 vertices per quad, texture coordinates hold the array layer
+    std::vector<GLfloat> _vertices;
+    std::vector<GLfloat> _texcoords;
+    std::vector<GLfloat> _colors;
+
+    std::vector<ldraw_command> _draws;
+
+public:
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * sizes vertex data for given number of quads
+        * removes all draw commands
+    side-effects: n/a
+    */
+    void reset(std::size_t quads);
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of quads
+    side-effects: n/a
+    */
+    std::size_t quads() const;
+
+    /*
+    pre-conditions:
+        * quad < quads()
+    post-conditions:
+        * return 8 positions, 12 texture coordinates (s, t, layer) and 16
+          color components of the quad respectively
+    side-effects: n/a
+    */
+    GLfloat* vertices(std::size_t quad);
+    GLfloat* texcoords(std::size_t quad);
+    GLfloat* colors(std::size_t quad);
+
+    /*
+    pre-conditions:
+        * first + count <= quads()
+    post-conditions:
+        * appends a draw command, merged into the previous one if it uses
+          the same texture and ends at first
+    side-effects: n/a
+    */
+    void draw(
+        GLuint      texture,
+        std::size_t first,
+        std::size_t count,
+        GLenum      target = GL_TEXTURE_2D);
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of draw commands
+    side-effects: n/a
+    */
+    std::size_t draws() const;
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * active modelview matrix
+    post-conditions:
+        * issues recorded draw commands
+    side-effects:
+        * modelview matrix is set to identity matrix
+        * binds recorded textures
+        * array textures are drawn with the array program, which is
+          unbound afterwards
+        * sets current color to white
+    */
+    void replay() const;
+};
+
+#endif // LCOMMAND_LIST_HPP
@@ -0,0 +1,236 @@
+#include "lfont.hpp"
+
+#include <algorithm> // for std::max
+#include <cctype>    // for std::tolower
+
+#include <gsl/gsl_util>
+
+namespace {
+
+// characters of a font sheet, in 16 rows of 16 cells
+constexpr GLuint SHEET_CELLS = 16;
+
+// built-in glyphs are 3x5 pixels, cells add a transparent border
+constexpr GLuint GLYPH_WIDTH  = 3;
+constexpr GLuint GLYPH_HEIGHT = 5;
+constexpr GLuint CELL_WIDTH   = GLYPH_WIDTH + 1;
+constexpr GLuint CELL_HEIGHT  = GLYPH_HEIGHT + 1;
+
+// shaped strings kept before the cache starts over
+constexpr std::size_t CACHE_SIZE = 256;
+
+constexpr GLuint OPAQUE_WHITE      = 0xffffffff;
+constexpr GLuint TRANSPARENT_WHITE = 0x00ffffff;
+
+struct lglyph_bitmap {
+    char        character;
+    const char* rows; // GLYPH_HEIGHT rows of GLYPH_WIDTH pixels, '#' is set
+};
+
+// clang-format off
+constexpr lglyph_bitmap BUILTIN_GLYPHS[] = {
+    {'0', "###" "#.#" "#.#" "#.#" "###"}, {'1', ".#." "##." ".#." ".#." "###"},
+    {'2', "###" "..#" "###" "#.." "###"}, {'3', "###" "..#" ".##" "..#" "###"},
+    {'4', "#.#" "#.#" "###" "..#" "..#"}, {'5', "###" "#.." "###" "..#" "###"},
+    {'6', "###" "#.." "###" "#.#" "###"}, {'7', "###" "..#" "..#" ".#." ".#."},
+    {'8', "###" "#.#" "###" "#.#" "###"}, {'9', "###" "#.#" "###" "..#" "###"},
+    {'A', ".#." "#.#" "###" "#.#" "#.#"}, {'B', "##." "#.#" "##." "#.#" "##."},
+    {'C', ".##" "#.." "#.." "#.." ".##"}, {'D', "##." "#.#" "#.#" "#.#" "##."},
+    {'E', "###" "#.." "##." "#.." "###"}, {'F', "###" "#.." "##." "#.." "#.."},
+    {'G', ".##" "#.." "#.#" "#.#" ".##"}, {'H', "#.#" "#.#" "###" "#.#" "#.#"},
+    {'I', "###" ".#." ".#." ".#." "###"}, {'J', "..#" "..#" "..#" "#.#" ".#."},
+    {'K', "#.#" "#.#" "##." "#.#" "#.#"}, {'L', "#.." "#.." "#.." "#.." "###"},
+    {'M', "#.#" "###" "###" "#.#" "#.#"}, {'N', "##." "#.#" "#.#" "#.#" "#.#"},
+    {'O', ".#." "#.#" "#.#" "#.#" ".#."}, {'P', "##." "#.#" "##." "#.." "#.."},
+    {'Q', ".#." "#.#" "#.#" "##." ".##"}, {'R', "##." "#.#" "##." "#.#" "#.#"},
+    {'S', ".##" "#.." ".#." "..#" "##."}, {'T', "###" ".#." ".#." ".#." ".#."},
+    {'U', "#.#" "#.#" "#.#" "#.#" "###"}, {'V', "#.#" "#.#" "#.#" "#.#" ".#."},
+    {'W', "#.#" "#.#" "###" "###" "#.#"}, {'X', "#.#" "#.#" ".#." "#.#" "#.#"},
+    {'Y', "#.#" "#.#" ".#." ".#." ".#."}, {'Z', "###" "..#" ".#." "#.." "###"},
+    {'.', "..." "..." "..." "..." ".#."}, {',', "..." "..." "..." ".#." "#.."},
+    {':', "..." ".#." "..." ".#." "..."}, {'-', "..." "..." "###" "..." "..."},
+    {'+', "..." ".#." "###" ".#." "..."}, {'=', "..." "###" "..." "###" "..."},
+    {'/', "..#" "..#" ".#." "#.." "#.."}, {'%', "#.#" "..#" ".#." "#.." "#.#"},
+    {'(', ".#." "#.." "#.." "#.." ".#."}, {')', ".#." "..#" "..#" "..#" ".#."},
+    {'!', ".#." ".#." ".#." "..." ".#."}, {'?', "##." "..#" ".#." "..." ".#."},
+    {'_', "..." "..." "..." "..." "###"}, {'\'', ".#." ".#." "..." "..." "..."},
+};
+// clang-format on
+
+} // namespace
+
+bool
+lfont::load_builtin(GLfloat scale)
+{
+    constexpr GLuint width  = SHEET_CELLS * CELL_WIDTH;
+    constexpr GLuint height = SHEET_CELLS * CELL_HEIGHT;
+
+    // rasterize glyphs into their cells, lowercase cells get uppercase
+    // glyphs
+    std::vector<GLuint> pixels(width * height, TRANSPARENT_WHITE);
+    _clips = {};
+    for (const auto& glyph : BUILTIN_GLYPHS) {
+        auto characters = std::array{
+            static_cast<unsigned char>(glyph.character),
+            static_cast<unsigned char>(std::tolower(glyph.character))};
+
+        for (const auto c : characters) {
+            const GLuint left = c % SHEET_CELLS * CELL_WIDTH;
+            const GLuint top  = c / SHEET_CELLS * CELL_HEIGHT;
+            for (GLuint y = 0; y < GLYPH_HEIGHT; ++y) {
+                for (GLuint x = 0; x < GLYPH_WIDTH; ++x) {
+                    if (glyph.rows[y * GLYPH_WIDTH + x] != '#') continue;
+                    pixels[(top + y) * width + left + x] = OPAQUE_WHITE;
+                }
+            }
+
+            _clips[c] = {gsl::narrow<GLfloat>(left),
+                         gsl::narrow<GLfloat>(top),
+                         gsl::narrow<GLfloat>(GLYPH_WIDTH),
+                         gsl::narrow<GLfloat>(GLYPH_HEIGHT)};
+        }
+    }
+
+    if (!_sheet.load_from_pixels32(pixels.data(), {width, height})) {
+        return false;
+    }
+
+    _cell_width  = gsl::narrow<GLfloat>(GLYPH_WIDTH);
+    _line_height = gsl::narrow<GLfloat>(CELL_HEIGHT);
+    _spacing     = 1.f;
+    _scale       = scale;
+    _cache.clear();
+
+    // pixel font, keep its edges sharp when scaled up
+    glBindTexture(GL_TEXTURE_2D, _sheet.get_texture_id());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return true;
+}
+
+bool
+lfont::load_sheet(std::string_view path, GLfloat scale)
+{
+    if (!_sheet.load_from_file(path)) {
+        std::cerr << "unable to load font sheet " << path << '\n';
+        return false;
+    }
+
+    // every cell is a glyph
+    const auto dims   = _sheet.get_dimensions();
+    const auto cell_w = gsl::narrow<GLfloat>(dims[0] / SHEET_CELLS);
+    const auto cell_h = gsl::narrow<GLfloat>(dims[1] / SHEET_CELLS);
+    for (GLuint c = 0; c < _clips.size(); ++c) {
+        _clips[c] = {gsl::narrow<GLfloat>(c % SHEET_CELLS) * cell_w,
+                     gsl::narrow<GLfloat>(c / SHEET_CELLS) * cell_h,
+                     cell_w,
+                     cell_h};
+    }
+
+    _cell_width  = cell_w;
+    _line_height = cell_h;
+    _spacing     = 0.f;
+    _scale       = scale;
+    _cache.clear();
+
+    return true;
+}
+
+void
+lfont::layout(std::string_view text, ltext_layout& out) const
+{
+    const auto dims  = _sheet.get_dimensions();
+    const auto tex_w = gsl::narrow<GLfloat>(dims[0]);
+    const auto tex_h = gsl::narrow<GLfloat>(dims[1]);
+
+    out.vertices.clear();
+    out.texcoords.clear();
+    out.vertices.reserve(text.size() * 8);
+    out.texcoords.reserve(text.size() * 8);
+
+    GLfloat x = 0.f;
+    GLfloat y = 0.f;
+    out.size  = {0.f, text.empty() ? 0.f : _line_height * _scale};
+
+    for (const char character : text) {
+        if (character == '\n') {
+            x = 0.f;
+            y += _line_height * _scale;
+            out.size[1] = y + _line_height * _scale;
+            continue;
+        }
+
+        const auto& clip    = _clips[static_cast<unsigned char>(character)];
+        const auto  advance = (_cell_width + _spacing) * _scale;
+
+        // blanks only move the pen
+        if (clip[2] > 0.f) {
+            const auto w = clip[2] * _scale;
+            const auto h = clip[3] * _scale;
+            out.vertices.insert(
+                out.vertices.end(),
+                {x, y, x + w, y, x + w, y + h, x, y + h});
+
+            const auto l = clip[0] / tex_w;
+            const auto r = (clip[0] + clip[2]) / tex_w;
+            const auto t = clip[1] / tex_h;
+            const auto b = (clip[1] + clip[3]) / tex_h;
+            out.texcoords.insert(out.texcoords.end(), {l, t, r, t, r, b, l, b});
+        }
+
+        x += advance;
+        out.size[0] = std::max(out.size[0], x - _spacing * _scale);
+    }
+}
+
+const ltext_layout&
+lfont::shape(std::string_view text)
+{
+    auto found = _cache.find(std::string(text));
+    if (found != _cache.end()) return found->second;
+
+    // changing text would grow the cache forever, start over instead
+    if (_cache.size() >= CACHE_SIZE) _cache.clear();
+
+    auto& shaped = _cache[std::string(text)];
+    layout(text, shaped);
+    return shaped;
+}
+
+void
+lfont::render(std::array<GLfloat, 2> point, std::string_view text)
+{
+    const auto& shaped = shape(text);
+    if (!_sheet.get_texture_id() || shaped.glyphs() == 0) return;
+
+    // move to rendering point
+    glLoadIdentity();
+    glTranslatef(point[0], point[1], 0.f);
+
+    // set texture id
+    glBindTexture(GL_TEXTURE_2D, _sheet.get_texture_id());
+
+    // glyph cells are transparent around the glyphs
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // render all glyphs at once
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, shaped.vertices.data());
+    glTexCoordPointer(2, GL_FLOAT, 0, shaped.texcoords.data());
+    glDrawArrays(GL_QUADS, 0, gsl::narrow<GLsizei>(shaped.glyphs() * 4));
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glPopAttrib();
+}
+
+std::array<GLfloat, 2>
+lfont::measure(std::string_view text)
+{
+    return shape(text).size;
+}
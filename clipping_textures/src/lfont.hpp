@@ -0,0 +1,118 @@
+#ifndef LFONT_HPP
+#define LFONT_HPP
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "lopengl.hpp"
+#include "lrect.hpp"
+#include "ltexture.hpp"
+
+/*
+Glyph quads of a laid out string, relative to the point it is drawn at.
+Layout touches no GL state, so strings can be shaped on any thread.
+*/
+struct ltext_layout {
+    // 4 vertices per glyph
+    std::vector<GLfloat> vertices;
+    std::vector<GLfloat> texcoords;
+
+    // extent of the text
+    std::array<GLfloat, 2> size = {0.f, 0.f};
+
+    std::size_t glyphs() const { return vertices.size() / 8; }
+};
+
+/*
+Bitmap font. Glyphs are clips {x, y, w, h} into a font sheet holding 16x16
+cells in character order; a string is drawn as one batch of glyph quads.
+Shaped strings are cached, so text which does not change between frames is
+laid out once.
+*/
+class lfont {
+    // font sheet and glyph clips, empty clips are drawn as blanks
+    ltexture                _sheet;
+    std::array<lfrect, 256> _clips = {};
+
+    // metrics in sheet pixels
+    GLfloat _cell_width  = {0.f};
+    GLfloat _line_height = {0.f};
+    GLfloat _spacing     = {0.f};
+
+    // sheet pixels to screen pixels
+    GLfloat _scale = {1.f};
+
+    std::unordered_map<std::string, ltext_layout> _cache;
+
+public:
+    /*
+    pre-conditions:
+        * valid GL context
+    post-conditions:
+        * creates the built-in 3x5 pixel font covering digits, letters
+          (lowercase drawn as uppercase) and common punctuation
+        * glyphs are drawn at given scale
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_builtin(GLfloat scale = 1.f);
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * initialized DevIL
+        * sheet is a grid of 16x16 equally sized cells in character order
+    post-conditions:
+        * loads the sheet, every cell is a glyph
+        * glyphs are drawn at given scale
+        * reports error to console if sheet could not be loaded
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_sheet(std::string_view path, GLfloat scale = 1.f);
+
+    /*
+    pre-conditions:
+        * font is loaded
+    post-conditions:
+        * lays out the text into given layout, '\n' starts a new line
+    side-effects: n/a
+    */
+    void layout(std::string_view text, ltext_layout&) const;
+
+    /*
+    pre-conditions:
+        * font is loaded
+    post-conditions:
+        * returns layout of the text, laid out on first use
+        * reference is invalidated by the next call
+    side-effects: n/a
+    */
+    const ltext_layout& shape(std::string_view text);
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * active modelview matrix
+    post-conditions:
+        * renders the text with its top left corner at given point in
+          current color, all glyphs in one draw call
+    side-effects:
+        * modelview matrix is translated to given point
+        * binds font sheet
+    */
+    void render(std::array<GLfloat, 2> point, std::string_view text);
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns extent of the text when rendered
+    side-effects: n/a
+    */
+    std::array<GLfloat, 2> measure(std::string_view text);
+};
+
+#endif // LFONT_HPP
@@ -0,0 +1,84 @@
+#include "lframe_pipeline.hpp"
+
+#include <chrono>
+#include <utility>
+
+namespace {
+
+using lclock = std::chrono::steady_clock;
+
+double
+elapsed_ms(lclock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(lclock::now() - since)
+        .count();
+}
+
+} // namespace
+
+lframe_pipeline::lframe_pipeline(
+    ljob_system& jobs, std::function<void(lcommand_list&)> build)
+    : _jobs(jobs), _build(std::move(build))
+{
+}
+
+lframe_pipeline::~lframe_pipeline()
+{
+    // the job references this pipeline
+    _jobs.wait(_building);
+}
+
+void
+lframe_pipeline::run_build(void* data, std::size_t, std::size_t)
+{
+    auto&      pipeline = *static_cast<lframe_pipeline*>(data);
+    const auto start    = lclock::now();
+
+    pipeline._build(pipeline._lists[pipeline._front ^ 1]);
+
+    pipeline._build_ms = elapsed_ms(start);
+}
+
+void
+lframe_pipeline::start_build()
+{
+    ljob job;
+    job.function = run_build;
+    job.data     = this;
+    job.counter  = &_building;
+    _jobs.submit(job);
+}
+
+void
+lframe_pipeline::advance()
+{
+    // the very first frame has nothing in flight yet
+    if (!_started) {
+        _started = true;
+        start_build();
+    }
+
+    // wait for the back list, runs queued jobs meanwhile
+    const auto start = lclock::now();
+    _jobs.wait(_building);
+    _timings.stall_ms = elapsed_ms(start);
+    _timings.build_ms = _build_ms;
+
+    // hand over and record the next frame
+    _front ^= 1;
+    start_build();
+}
+
+void
+lframe_pipeline::submit()
+{
+    const auto start = lclock::now();
+    _lists[_front].replay();
+    _timings.submit_ms = elapsed_ms(start);
+}
+
+const lframe_timings&
+lframe_pipeline::timings() const
+{
+    return _timings;
+}
@@ -0,0 +1,90 @@
+#ifndef LFRAME_PIPELINE_HPP
+#define LFRAME_PIPELINE_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+
+#include "lcommand_list.hpp"
+#include "ljob_system.hpp"
+
+/*
+Per-frame profiler data of the pipeline in milliseconds. Build time that does
+not show up as stall time was hidden behind GL submission.
+*/
+struct lframe_timings {
+    // worker time spent recording the frame
+    double build_ms = {0.0};
+
+    // main thread time spent waiting for the recording to finish
+    double stall_ms = {0.0};
+
+    // main thread time spent replaying the previous frame to GL
+    double submit_ms = {0.0};
+};
+
+/*
+Double-buffered frame pipeline. While the main thread replays frame N to GL,
+a job records frame N+1 into the other command list. The lists swap once the
+job's counter drops to zero, so the hand-off takes no locks.
+*/
+class lframe_pipeline {
+    ljob_system&                        _jobs;
+    std::function<void(lcommand_list&)> _build;
+
+    std::array<lcommand_list, 2> _lists;
+    std::size_t                  _front    = {0};
+    ljob_counter                 _building = {0};
+    bool                         _started  = {false};
+
+    // written by the build job, read after waiting on its counter
+    double         _build_ms = {0.0};
+    lframe_timings _timings;
+
+    static void run_build(void*, std::size_t, std::size_t);
+    void        start_build();
+
+public:
+    /*
+    pre-conditions:
+        * build records a frame into the given list, it runs on a worker
+          and may not call GL
+    post-conditions: n/a
+    side-effects: n/a
+    */
+    lframe_pipeline(ljob_system&, std::function<void(lcommand_list&)> build);
+    ~lframe_pipeline();
+
+    lframe_pipeline(const lframe_pipeline&) = delete;
+    lframe_pipeline& operator=(const lframe_pipeline&) = delete;
+
+    /*
+    pre-conditions:
+        * called from the thread which created the job system
+    post-conditions:
+        * waits for the frame being recorded and makes it the front list
+        * starts recording the next frame into the back list
+    side-effects: n/a
+    */
+    void advance();
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * active modelview matrix
+    post-conditions:
+        * replays the front list
+    side-effects:
+        * see lcommand_list::replay
+    */
+    void submit();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns timings of the last advanced frame
+    side-effects: n/a
+    */
+    const lframe_timings& timings() const;
+};
+
+#endif // LFRAME_PIPELINE_HPP
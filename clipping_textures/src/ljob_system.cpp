@@ -0,0 +1,138 @@
+#include "ljob_system.hpp"
+
+namespace {
+
+// job system and worker index of the current thread
+thread_local const ljob_system* t_system = nullptr;
+thread_local std::size_t        t_worker = 0;
+
+} // namespace
+
+ljob_system::ljob_system(std::size_t workers)
+{
+    if (workers == 0) { workers = std::thread::hardware_concurrency(); }
+    if (workers == 0) { workers = 1; }
+
+    for (std::size_t i = 0; i < workers; ++i) {
+        _queues.push_back(std::make_unique<lworker_queue>());
+    }
+
+    // the creating thread is worker 0
+    t_system = this;
+    t_worker = 0;
+
+    for (std::size_t i = 1; i < workers; ++i) {
+        _threads.emplace_back([this, i]() { run_worker(i); });
+    }
+}
+
+ljob_system::~ljob_system()
+{
+    // wake everybody up and let them leave
+    _quit = true;
+    { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+    _wake.notify_all();
+
+    for (auto& thread : _threads) { thread.join(); }
+
+    if (t_system == this) { t_system = nullptr; }
+}
+
+std::size_t
+ljob_system::size() const
+{
+    return _queues.size();
+}
+
+std::size_t
+ljob_system::current_worker() const
+{
+    // foreign threads share the creating thread's queue
+    return t_system == this ? t_worker : 0;
+}
+
+void
+ljob_system::submit(const ljob& job)
+{
+    if (job.counter) { job.counter->fetch_add(1, std::memory_order_relaxed); }
+
+    // counted before it can be taken, or a thief's decrement could wrap
+    // the count around
+    auto& queue = *_queues[current_worker()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        ++_queued;
+        queue.jobs.push_back(job);
+    }
+
+    // taking the lock orders this against a worker about to sleep
+    { std::lock_guard<std::mutex> lock(_sleep_mutex); }
+    _wake.notify_one();
+}
+
+void
+ljob_system::wait(const ljob_counter& counter)
+{
+    const auto worker = current_worker();
+    while (counter.load(std::memory_order_acquire) != 0) {
+        if (!run_one(worker)) { std::this_thread::yield(); }
+    }
+}
+
+void
+ljob_system::run_worker(std::size_t worker)
+{
+    t_system = this;
+    t_worker = worker;
+
+    while (!_quit) {
+        if (run_one(worker)) continue;
+
+        // nothing to do or steal, sleep until jobs are queued
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _wake.wait(lock, [this]() { return _queued != 0 || _quit; });
+    }
+}
+
+bool
+ljob_system::run_one(std::size_t worker)
+{
+    ljob job;
+    if (!pop(worker, job) && !steal(worker, job)) return false;
+
+    --_queued;
+    job.function(job.data, job.first, job.last);
+    if (job.counter) { job.counter->fetch_sub(1, std::memory_order_release); }
+
+    return true;
+}
+
+bool
+ljob_system::pop(std::size_t worker, ljob& job)
+{
+    // own jobs are taken from the back, they are most likely still in cache
+    auto&                       queue = *_queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    job = queue.jobs.back();
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool
+ljob_system::steal(std::size_t worker, ljob& job)
+{
+    // other workers' jobs are taken from the front
+    for (std::size_t i = 1; i < _queues.size(); ++i) {
+        auto&                       queue = *_queues[(worker + i) % size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+
+        job = queue.jobs.front();
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,141 @@
+#ifndef LJOB_SYSTEM_HPP
+#define LJOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+Counts unfinished jobs. Submitting a job with a counter increments it, the
+job decrements it when done, and waiting on the counter blocks until all of
+them are done. Jobs depending on other jobs wait on their counter.
+*/
+using ljob_counter = std::atomic<std::size_t>;
+
+/*
+A job runs a function over the index range [first, last).
+*/
+struct ljob {
+    void (*function)(void*, std::size_t, std::size_t) = {nullptr};
+    void*         data                                = {nullptr};
+    std::size_t   first                               = {0};
+    std::size_t   last                                = {0};
+    ljob_counter* counter                             = {nullptr};
+};
+
+/*
+Work-stealing job system. Every worker owns a deque: it pushes and pops its
+own jobs at the back and steals from the front of other deques when it runs
+out. The thread which created the job system is worker 0; it does not sleep
+but runs jobs while it waits on a counter. GL calls must stay on that thread.
+*/
+class ljob_system {
+    struct lworker_queue {
+        std::mutex       mutex;
+        std::deque<ljob> jobs;
+    };
+
+    // one queue per worker, the creating thread included
+    std::vector<std::unique_ptr<lworker_queue>> _queues;
+    std::vector<std::thread>                    _threads;
+
+    // sleeping workers wake up when jobs are queued
+    std::mutex               _sleep_mutex;
+    std::condition_variable  _wake;
+    std::atomic<std::size_t> _queued = {0};
+    std::atomic<bool>        _quit   = {false};
+
+    void run_worker(std::size_t);
+    bool run_one(std::size_t);
+    bool pop(std::size_t, ljob&);
+    bool steal(std::size_t, ljob&);
+    std::size_t current_worker() const;
+
+public:
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * starts given number of workers including the calling thread
+        * zero picks one worker per hardware thread
+    side-effects:
+        * spawns worker threads
+    */
+    explicit ljob_system(std::size_t workers = 0);
+    ~ljob_system();
+
+    ljob_system(const ljob_system&) = delete;
+    ljob_system& operator=(const ljob_system&) = delete;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of workers including the calling thread
+    side-effects: n/a
+    */
+    std::size_t size() const;
+
+    /*
+    pre-conditions:
+        * job data outlives the job
+    post-conditions:
+        * queues the job on the calling worker's deque
+        * increments job counter if given
+    side-effects:
+        * may wake a sleeping worker
+    */
+    void submit(const ljob&);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * runs queued jobs until counter drops to zero
+    side-effects: n/a
+    */
+    void wait(const ljob_counter&);
+
+    /*
+    pre-conditions:
+        * function is callable as function(first, last)
+    post-conditions:
+        * splits [0, count) into chunks of at most grain indices, runs
+          them on all workers and returns when all chunks are done
+    side-effects: n/a
+    */
+    template <typename Function>
+    void parallel_for(std::size_t count, std::size_t grain, Function&& function)
+    {
+        using function_type = std::remove_reference_t<Function>;
+
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+
+        // a single chunk is not worth a trip through the queues
+        if (count <= grain || size() == 1) {
+            function(std::size_t{0}, count);
+            return;
+        }
+
+        ljob_counter counter = {0};
+        for (std::size_t first = 0; first < count; first += grain) {
+            ljob job;
+            job.function = [](void* data, std::size_t f, std::size_t l) {
+                (*static_cast<function_type*>(data))(f, l);
+            };
+            job.data =
+                const_cast<void*>(static_cast<const void*>(&function));
+            job.first   = first;
+            job.last    = first + grain < count ? first + grain : count;
+            job.counter = &counter;
+            submit(job);
+        }
+
+        wait(counter);
+    }
+};
+
+#endif // LJOB_SYSTEM_HPP
@@ -0,0 +1,250 @@
+#include "lscene.hpp"
+
+#include <gsl/gsl_util>
+
+#include "ltexture.hpp"
+#include "ltexture_array.hpp"
+
+GLuint
+lscene::add_texture(const ltexture& texture)
+{
+    _textures.push_back({&texture, nullptr});
+    return gsl::narrow<GLuint>(_textures.size() - 1);
+}
+
+GLuint
+lscene::add_texture(const ltexture_array& array)
+{
+    _textures.push_back({nullptr, &array});
+    return gsl::narrow<GLuint>(_textures.size() - 1);
+}
+
+lentity
+lscene::create(
+    GLuint                 texture,
+    std::array<GLfloat, 2> point,
+    const lfrect&          clip,
+    const lcolor&          tint,
+    GLuint                 layer)
+{
+    // reuse a free slot or open a new one
+    GLuint slot = 0;
+    if (!_free_slots.empty()) {
+        slot = _free_slots.back();
+        _free_slots.pop_back();
+    } else {
+        slot = gsl::narrow<GLuint>(_slot_index.size());
+        _slot_index.push_back(0);
+        _slot_generation.push_back(0);
+    }
+
+    // append components
+    _slot_index[slot] = gsl::narrow<GLuint>(_slot.size());
+    _slot.push_back(slot);
+    _x.push_back(point[0]);
+    _y.push_back(point[1]);
+    _clip.push_back(clip);
+    _texture.push_back(texture);
+    _layer.push_back(layer);
+    _tint.push_back(tint);
+
+    return {slot, _slot_generation[slot]};
+}
+
+void
+lscene::create(
+    std::size_t           count,
+    GLuint                texture,
+    const lfrect&         clip,
+    std::vector<lentity>& entities)
+{
+    const auto total = _slot.size() + count;
+    _slot.reserve(total);
+    _x.reserve(total);
+    _y.reserve(total);
+    _clip.reserve(total);
+    _texture.reserve(total);
+    _layer.reserve(total);
+    _tint.reserve(total);
+    entities.reserve(entities.size() + count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        entities.push_back(create(texture, {0.f, 0.f}, clip));
+    }
+}
+
+void
+lscene::destroy(lentity entity)
+{
+    if (!alive(entity)) return;
+
+    // move last entity into the hole
+    const auto index = _slot_index[entity.slot];
+    const auto last  = gsl::narrow<GLuint>(_slot.size() - 1);
+    if (index != last) {
+        _slot[index]              = _slot[last];
+        _x[index]                 = _x[last];
+        _y[index]                 = _y[last];
+        _clip[index]              = _clip[last];
+        _texture[index]           = _texture[last];
+        _layer[index]             = _layer[last];
+        _tint[index]              = _tint[last];
+        _slot_index[_slot[index]] = index;
+    }
+
+    _slot.pop_back();
+    _x.pop_back();
+    _y.pop_back();
+    _clip.pop_back();
+    _texture.pop_back();
+    _layer.pop_back();
+    _tint.pop_back();
+
+    // invalidate outstanding handles
+    ++_slot_generation[entity.slot];
+    _free_slots.push_back(entity.slot);
+}
+
+void
+lscene::destroy(const std::vector<lentity>& entities)
+{
+    for (const auto& entity : entities) { destroy(entity); }
+}
+
+bool
+lscene::alive(lentity entity) const
+{
+    return entity.slot < _slot_generation.size() &&
+           _slot_generation[entity.slot] == entity.generation;
+}
+
+std::size_t
+lscene::index(lentity entity) const
+{
+    return _slot_index[entity.slot];
+}
+
+std::size_t
+lscene::size() const
+{
+    return _slot.size();
+}
+
+GLfloat*
+lscene::x()
+{
+    return _x.data();
+}
+
+GLfloat*
+lscene::y()
+{
+    return _y.data();
+}
+
+lfrect*
+lscene::clips()
+{
+    return _clip.data();
+}
+
+GLuint*
+lscene::layers()
+{
+    return _layer.data();
+}
+
+lcolor*
+lscene::tints()
+{
+    return _tint.data();
+}
+
+void
+lscene::translate(std::array<GLfloat, 2> offset)
+{
+    GLfloat* const    x     = _x.data();
+    GLfloat* const    y     = _y.data();
+    const std::size_t count = _x.size();
+
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] += offset[0];
+        y[i] += offset[1];
+    }
+}
+
+void
+lscene::begin_batch(lcommand_list& list) const
+{
+    const auto count = size();
+    list.reset(count);
+
+    // one draw command per run of entities sharing a texture
+    std::size_t first = 0;
+    while (first != count) {
+        std::size_t last = first + 1;
+        while (last != count && _texture[last] == _texture[first]) { ++last; }
+
+        const auto& texture = _textures[_texture[first]];
+        if (texture.array) {
+            list.draw(
+                texture.array->get_texture_id(),
+                first,
+                last - first,
+                GL_TEXTURE_2D_ARRAY);
+        } else {
+            list.draw(
+                texture.texture->get_texture_id(), first, last - first);
+        }
+
+        first = last;
+    }
+}
+
+void
+lscene::build_batch(
+    lcommand_list& list, std::size_t begin, std::size_t end) const
+{
+    for (std::size_t i = begin; i < end; ++i) {
+        const auto& clip    = _clip[i];
+        const auto& texture = _textures[_texture[i]];
+        const auto  dims    = texture.array ? texture.array->get_dimensions()
+                                            : texture.texture->get_dimensions();
+        const auto  layer =
+            texture.array ? gsl::narrow<GLfloat>(_layer[i]) : 0.f;
+        const auto  w    = gsl::narrow<GLfloat>(dims[0]);
+        const auto  h    = gsl::narrow<GLfloat>(dims[1]);
+
+        GLfloat* v = list.vertices(i);
+        v[0]       = _x[i];
+        v[1]       = _y[i];
+        v[2]       = _x[i] + clip[2];
+        v[3]       = _y[i];
+        v[4]       = _x[i] + clip[2];
+        v[5]       = _y[i] + clip[3];
+        v[6]       = _x[i];
+        v[7]       = _y[i] + clip[3];
+
+        const auto l = clip[0] / w;
+        const auto r = (clip[0] + clip[2]) / w;
+        const auto t = clip[1] / h;
+        const auto b = (clip[1] + clip[3]) / h;
+
+        GLfloat* tc = list.texcoords(i);
+        tc[0]       = l;
+        tc[1]       = t;
+        tc[2]       = layer;
+        tc[3]       = r;
+        tc[4]       = t;
+        tc[5]       = layer;
+        tc[6]       = r;
+        tc[7]       = b;
+        tc[8]       = layer;
+        tc[9]       = l;
+        tc[10]      = b;
+        tc[11]      = layer;
+
+        GLfloat* c = list.colors(i);
+        for (std::size_t k = 0; k < 16; ++k) { c[k] = _tint[i][k % 4]; }
+    }
+}
@@ -0,0 +1,188 @@
+#ifndef LSCENE_HPP
+#define LSCENE_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "lcommand_list.hpp"
+#include "lopengl.hpp"
+#include "lrect.hpp"
+
+class ltexture;
+class ltexture_array;
+
+using lcolor = std::array<GLfloat, 4>;
+
+/*
+Stable entity handle. The generation tells a handle to a destroyed entity
+apart from a handle to a newer entity which reuses the same slot.
+*/
+struct lentity {
+    GLuint slot       = {0};
+    GLuint generation = {0};
+};
+
+/*
+Scene objects stored as a structure of arrays. Components of alive entities
+are kept packed in contiguous arrays (destroying swaps the last entity into
+the hole), so update and render passes walk plain arrays instead of chasing
+objects.
+*/
+class lscene {
+    // handle slots
+    std::vector<GLuint> _slot_index;
+    std::vector<GLuint> _slot_generation;
+    std::vector<GLuint> _free_slots;
+
+    // packed components
+    std::vector<GLuint>  _slot;
+    std::vector<GLfloat> _x;
+    std::vector<GLfloat> _y;
+    std::vector<lfrect>  _clip;
+    std::vector<GLuint>  _texture;
+    std::vector<GLuint>  _layer;
+    std::vector<lcolor>  _tint;
+
+    // textures referenced by entities, one of the two is set
+    struct lscene_texture {
+        const ltexture*       texture = {nullptr};
+        const ltexture_array* array   = {nullptr};
+    };
+    std::vector<lscene_texture> _textures;
+
+public:
+    /*
+    pre-conditions:
+        * texture outlives the scene
+    post-conditions:
+        * returns texture handle to create entities with
+    side-effects: n/a
+    */
+    GLuint add_texture(const ltexture&);
+
+    /*
+    pre-conditions:
+        * texture outlives the scene
+    post-conditions:
+        * returns texture handle to create entities with, entities clip
+          within their layer
+    side-effects: n/a
+    */
+    GLuint add_texture(const ltexture_array&);
+
+    /*
+    pre-conditions:
+        * texture handle was returned by add_texture
+    post-conditions:
+        * creates an entity drawing given clip {x, y, w, h} at given point
+        * layer is ignored unless the texture is an array
+        * returns entity handle
+    side-effects: n/a
+    */
+    lentity create(
+        GLuint                 texture,
+        std::array<GLfloat, 2> point,
+        const lfrect&          clip,
+        const lcolor&          tint  = {1.f, 1.f, 1.f, 1.f},
+        GLuint                 layer = 0);
+
+    /*
+    pre-conditions:
+        * texture handle was returned by add_texture
+    post-conditions:
+        * creates given number of entities at the origin
+        * appends their handles to the given vector
+    side-effects: n/a
+    */
+    void create(
+        std::size_t           count,
+        GLuint                texture,
+        const lfrect&         clip,
+        std::vector<lentity>& entities);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * destroys the entity if it is alive
+        * packed index of another entity may change
+    side-effects: n/a
+    */
+    void destroy(lentity);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * destroys all given entities which are alive
+    side-effects: n/a
+    */
+    void destroy(const std::vector<lentity>&);
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns true if handle refers to an alive entity
+    side-effects: n/a
+    */
+    bool alive(lentity) const;
+
+    /*
+    pre-conditions:
+        * alive entity
+    post-conditions:
+        * returns packed index of the entity into component arrays
+    side-effects: n/a
+    */
+    std::size_t index(lentity) const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of alive entities
+    side-effects: n/a
+    */
+    std::size_t size() const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * return packed component arrays of size() elements
+        * pointers are invalidated by create and destroy
+    side-effects: n/a
+    */
+    GLfloat* x();
+    GLfloat* y();
+    lfrect*  clips();
+    GLuint*  layers();
+    lcolor*  tints();
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * moves all entities by given offset
+    side-effects: n/a
+    */
+    void translate(std::array<GLfloat, 2>);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * sizes given command list for all entities
+        * records draw commands, one per run of entities sharing a texture,
+          entities of an array texture share it whatever their layer
+    side-effects: n/a
+    */
+    void begin_batch(lcommand_list&) const;
+
+    /*
+    pre-conditions:
+        * begin_batch was called on the list since entities were last
+          created/destroyed
+        * begin <= end <= size()
+    post-conditions:
+        * records quads of entities [begin, end) into given command list
+        * disjoint ranges may be recorded concurrently
+    side-effects: n/a
+    */
+    void build_batch(lcommand_list&, std::size_t begin, std::size_t end) const;
+};
+
+#endif // LSCENE_HPP
@@ -160,7 +160,7 @@ void ltexture::render(std::array<GLfloat, 2> point, std::optional<lfrect> clip)
     glEnd();
 }
 
-inline GLuint
+GLuint
 ltexture::get_texture_id() const
 {
     return _texture_id;
@@ -0,0 +1,345 @@
+#include "ltexture_array.hpp"
+
+#include <algorithm>
+#include <cstdio>  // for std::sscanf
+#include <cstring> // for std::strstr
+
+#include <IL/il.h>
+#include <gsl/gsl_util>
+
+namespace {
+
+constexpr const char* VERTEX_SHADER = R"(
+#version 120
+
+varying vec3 texcoord;
+
+void main()
+{
+    gl_Position   = ftransform();
+    gl_FrontColor = gl_Color;
+    texcoord      = gl_MultiTexCoord0.xyz;
+}
+)";
+
+constexpr const char* FRAGMENT_SHADER = R"(
+#version 120
+#extension GL_EXT_texture_array : require
+
+uniform sampler2DArray layers;
+
+varying vec3 texcoord;
+
+void main()
+{
+    gl_FragColor = texture2DArray(layers, texcoord) * gl_Color;
+}
+)";
+
+// program shared by all arrays, alive while any array is loaded
+static GLuint      g_program = 0;
+static std::size_t g_arrays  = 0;
+
+bool
+version_at_least(GLenum name, int major_version, int minor_version)
+{
+    auto version = reinterpret_cast<const char*>(glGetString(name));
+    int  major   = 0;
+    int  minor   = 0;
+    return version && std::sscanf(version, "%d.%d", &major, &minor) == 2 &&
+           (major > major_version ||
+            (major == major_version && minor >= minor_version));
+}
+
+GLuint
+compile_shader(GLenum type, const char* source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        GLchar log[1024] = {};
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "unable to compile texture array shader:\n"
+                  << log << '\n';
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+GLuint
+create_program()
+{
+    GLuint vertex_shader = compile_shader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragment_shader =
+        compile_shader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    auto _ = gsl::finally([vertex_shader, fragment_shader]() {
+        // shaders are kept alive by the program
+        if (vertex_shader) glDeleteShader(vertex_shader);
+        if (fragment_shader) glDeleteShader(fragment_shader);
+    });
+    if (!vertex_shader || !fragment_shader) return 0;
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+    glLinkProgram(program);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        GLchar log[1024] = {};
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "unable to link texture array program:\n" << log << '\n';
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    // layers are sampled from texture unit 0
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "layers"), 0);
+    glUseProgram(0);
+
+    return program;
+}
+
+/*
+pre-condition:
+    * DevIL is initialized
+post-condition:
+    * decodes image at given path to RGBA and appends its pixels
+    * returns false if the image could not be loaded
+side-effects: n/a
+*/
+bool
+append_image(
+    std::string_view       path,
+    std::array<GLuint, 2>& dimensions,
+    std::vector<GLuint>&   pixels)
+{
+    ILuint img_id = 0;
+    ilGenImages(1, &img_id);
+    ilBindImage(img_id);
+    auto _ = gsl::finally([&img_id]() { ilDeleteImages(1, &img_id); });
+
+    if (ilLoadImage(path.data()) != IL_TRUE ||
+        ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE) != IL_TRUE) {
+        return false;
+    }
+
+    dimensions = {static_cast<GLuint>(ilGetInteger(IL_IMAGE_WIDTH)),
+                  static_cast<GLuint>(ilGetInteger(IL_IMAGE_HEIGHT))};
+
+    const auto data = reinterpret_cast<const GLuint*>(ilGetData());
+    pixels.insert(
+        pixels.end(), data, data + std::size_t{dimensions[0]} * dimensions[1]);
+    return true;
+}
+
+} // namespace
+
+ltexture_array::ltexture_array() = default;
+
+ltexture_array::~ltexture_array()
+{
+    // free texture data if needed
+    free_texture();
+}
+
+bool
+ltexture_array::supported()
+{
+    auto extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    return version_at_least(GL_SHADING_LANGUAGE_VERSION, 1, 20) &&
+           (version_at_least(GL_VERSION, 3, 0) ||
+            (extensions && std::strstr(extensions, "GL_EXT_texture_array")));
+}
+
+bool
+ltexture_array::load_from_pixels32(
+    const GLuint* pixels, std::array<GLuint, 2> dimensions, GLuint layers)
+{
+    // free texture if it exists
+    free_texture();
+
+    if (!supported()) {
+        std::cerr << "array textures are not supported\n";
+        return false;
+    }
+
+    // the first array creates the program
+    if (!g_program && !(g_program = create_program())) return false;
+
+    _dimensions = dimensions;
+    _layers     = layers;
+    ++g_arrays;
+
+    // generate texture id
+    glGenTextures(1, &_texture_id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, _texture_id);
+
+    // all layers in one upload
+    glTexImage3D(
+        GL_TEXTURE_2D_ARRAY,
+        0,
+        GL_RGBA,
+        gsl::narrow<GLsizei>(_dimensions[0]),
+        gsl::narrow<GLsizei>(_dimensions[1]),
+        gsl::narrow<GLsizei>(_layers),
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        pixels);
+
+    // clamp at the layer edges, neighboring sprites cannot bleed in
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // unbind texture
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    // check for error
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "error loading texture array from "
+                  << static_cast<const void*>(pixels) << gluErrorString(error)
+                  << '\n';
+        free_texture();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+ltexture_array::load_from_files(const std::vector<std::string_view>& paths)
+{
+    if (paths.empty()) {
+        std::cerr << "texture array needs at least one layer\n";
+        return false;
+    }
+
+    std::array<GLuint, 2> dimensions = {0, 0};
+    std::vector<GLuint>   pixels;
+
+    for (const auto path : paths) {
+        std::array<GLuint, 2> image_dimensions = {0, 0};
+        if (!append_image(path, image_dimensions, pixels)) {
+            std::cerr << "unable to load " << path << '\n';
+            return false;
+        }
+
+        // layers share their dimensions
+        if (dimensions[0] == 0) dimensions = image_dimensions;
+        if (image_dimensions != dimensions) {
+            std::cerr << path << " differs in size from " << paths.front()
+                      << '\n';
+            return false;
+        }
+    }
+
+    return load_from_pixels32(
+        pixels.data(), dimensions, gsl::narrow<GLuint>(paths.size()));
+}
+
+bool
+ltexture_array::load_from_sheet(
+    std::string_view path, std::array<GLuint, 2> dimensions)
+{
+    std::array<GLuint, 2> sheet_dimensions = {0, 0};
+    std::vector<GLuint>   sheet;
+    if (!append_image(path, sheet_dimensions, sheet)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+
+    if (!dimensions[0] || !dimensions[1] ||
+        sheet_dimensions[0] % dimensions[0] ||
+        sheet_dimensions[1] % dimensions[1]) {
+        std::cerr << "unable to slice " << path << " into " << dimensions[0]
+                  << 'x' << dimensions[1] << " layers\n";
+        return false;
+    }
+
+    // copy every slice into its layer
+    const std::size_t columns = sheet_dimensions[0] / dimensions[0];
+    const std::size_t rows    = sheet_dimensions[1] / dimensions[1];
+    const std::size_t width   = dimensions[0];
+    const std::size_t height  = dimensions[1];
+
+    std::vector<GLuint> layers(sheet.size());
+    auto                out = layers.begin();
+    for (std::size_t row = 0; row < rows; ++row) {
+        for (std::size_t column = 0; column < columns; ++column) {
+            for (std::size_t y = 0; y < height; ++y) {
+                const auto in = sheet.begin() +
+                                gsl::narrow<std::ptrdiff_t>(
+                                    (row * height + y) * sheet_dimensions[0] +
+                                    column * width);
+                out = std::copy(
+                    in, in + gsl::narrow<std::ptrdiff_t>(width), out);
+            }
+        }
+    }
+
+    return load_from_pixels32(
+        layers.data(), dimensions, gsl::narrow<GLuint>(rows * columns));
+}
+
+void
+ltexture_array::free_texture()
+{
+    // delete texture
+    if (_texture_id != 0) {
+        glDeleteTextures(1, &_texture_id);
+        _texture_id = 0;
+    }
+
+    // the last array deletes the program
+    if (_layers != 0 && --g_arrays == 0) {
+        glDeleteProgram(g_program);
+        g_program = 0;
+    }
+
+    _dimensions = {0, 0};
+    _layers     = 0;
+}
+
+void
+ltexture_array::bind(GLuint texture_id)
+{
+    glUseProgram(g_program);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_id);
+}
+
+void
+ltexture_array::unbind()
+{
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glUseProgram(0);
+}
+
+GLuint
+ltexture_array::get_texture_id() const
+{
+    return _texture_id;
+}
+
+std::array<GLuint, 2>
+ltexture_array::get_dimensions() const
+{
+    return _dimensions;
+}
+
+GLuint
+ltexture_array::get_layers() const
+{
+    return _layers;
+}
@@ -0,0 +1,134 @@
+#ifndef LTEXTURE_ARRAY_HPP
+#define LTEXTURE_ARRAY_HPP
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include "lopengl.hpp"
+
+/*
+Same sized sprites stored as the layers of a GL_TEXTURE_2D_ARRAY. Every layer
+is addressed by its own texture coordinates, so sprites of different layers
+draw together without rebinding and filtering never bleeds across sprite
+edges the way it does between the clips of an atlas. Array textures cannot
+be sampled by the fixed-function pipeline; quads drawn with them go through a
+small GLSL 1.20 program shared by all arrays.
+*/
+class ltexture_array {
+    // texture name
+    GLuint _texture_id = {0};
+
+    // dimensions of one layer
+    std::array<GLuint, 2> _dimensions = {0, 0};
+
+    // number of layers
+    GLuint _layers = {0};
+
+public:
+    ltexture_array();
+    ~ltexture_array();
+
+    ltexture_array(const ltexture_array&) = delete;
+    ltexture_array& operator=(const ltexture_array&) = delete;
+
+    /*
+    pre-condition: valid GL context
+    post-condition:
+        * returns true if the context has array textures and the program to
+          draw them compiles, OpenGL 3.0 or EXT_texture_array
+    side-effects: n/a
+    */
+    static bool supported();
+
+    /*
+    pre-condition: valid GL context
+    post-condition:
+        * creates an array texture from given layers of given dimensions,
+          stored one after another
+        * reports error to console if texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_from_pixels32(
+        const GLuint*, std::array<GLuint, 2> dimensions, GLuint layers);
+
+    /*
+    pre-condition: valid GL context
+    post-condition:
+        * creates an array texture with one layer per file, in order
+        * fails if the images are not all the same size
+        * reports error to console if texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_from_files(const std::vector<std::string_view>&);
+
+    /*
+    pre-condition:
+        * valid GL context
+        * sheet dimensions are multiples of given layer dimensions
+    post-condition:
+        * slices the sprite sheet at given path into layers of given
+          dimensions, left to right then top to bottom
+        * reports error to console if texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_from_sheet(std::string_view, std::array<GLuint, 2> dimensions);
+
+    /*
+    pre-condition: valid GL context
+    post-condition:
+        * deletes texture if it exists
+        * sets texture id to 0
+    side-effects: n/a
+    */
+    void free_texture();
+
+    /*
+    pre-condition:
+        * valid GL context
+        * a texture array loaded
+    post-condition:
+        * binds given array texture and makes the array program current,
+          quads then take their layer from the third texture coordinate
+    side-effects:
+        * changes the current program
+    */
+    static void bind(GLuint texture_id);
+
+    /*
+    pre-condition: valid GL context
+    post-condition:
+        * binds a null array texture and restores the fixed-function
+          pipeline
+    side-effects:
+        * changes the current program
+    */
+    static void unbind();
+
+    /*
+    pre-condition: n/a
+    post-condition:
+        * returns texture name/id
+    side-effects: n/a
+    */
+    GLuint get_texture_id() const;
+
+    /*
+    pre-condition: n/a
+    post-condition: returns dimensions of one layer
+    side-effects: n/a
+    */
+    std::array<GLuint, 2> get_dimensions() const;
+
+    /*
+    pre-condition: n/a
+    post-condition: returns number of layers
+    side-effects: n/a
+    */
+    GLuint get_layers() const;
+};
+
+#endif // LTEXTURE_ARRAY_HPP
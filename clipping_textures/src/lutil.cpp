@@ -1,22 +1,136 @@
 #include "lutil.hpp"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdio> // for std::snprintf
 #include <cstring>
 #include <gsl/gsl_util>
+#include <optional>
+#include <string>
+#include <vector>
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#include "lanimation.hpp"
+#include "lcommand_list.hpp"
+#include "lfont.hpp"
+#include "lframe_pipeline.hpp"
+#include "ljob_system.hpp"
 #include "lrect.hpp"
+#include "lscene.hpp"
 #include "ltexture.hpp"
+#include "ltexture_array.hpp"
 
 namespace {
 
+// fixed frame step in seconds
+constexpr GLfloat FRAME_TIME = 1.f / SCREEN_FPS;
+
+// sprites handled per job
+constexpr std::size_t JOB_GRAIN = 4096;
+
+// frame work fans out to these, GL calls stay on the main thread; started by
+// load_media, so benchmarks and static initialization run without them
+static std::optional<ljob_system> g_jobs;
+
 // sprite texture
 static ltexture g_arrow_texture;
 
-// sprite area
-static std::array<lfrect, 4> g_arrow_clips;
+// the arrows sliced into layers, used where array textures are supported
+static ltexture_array g_arrow_layers;
+static bool           g_arrows_layered = false;
+
+// size of one arrow in the sheet
+constexpr std::array<GLuint, 2> ARROW_SIZE = {128, 128};
+
+// arrows and frames drawn by benchmark_texture_array
+constexpr std::size_t BENCHMARK_ARROWS = 10000;
+constexpr int         BENCHMARK_FRAMES = 100;
+
+// sprites animated by benchmark_animation, each size advanced for about
+// the same number of sprite updates
+constexpr std::array<std::size_t, 3> ANIMATION_BENCHMARK_SIZES = {
+    10000, 100000, 1000000};
+constexpr std::size_t ANIMATION_BENCHMARK_UPDATES = 20000000;
+
+// entities and passes over them of benchmark_scene
+constexpr std::size_t SCENE_BENCHMARK_ENTITIES = 1000000;
+constexpr int         SCENE_BENCHMARK_PASSES   = 20;
+
+// sprites and frames of benchmark_jobs
+constexpr std::size_t JOBS_BENCHMARK_SPRITES = 1000000;
+constexpr int         JOBS_BENCHMARK_FRAMES  = 20;
+
+// text lengths laid out by benchmark_font, each for about the same number of
+// glyphs, lines as long as the longest the window fits at the report scale
+constexpr std::array<std::size_t, 3> FONT_BENCHMARK_LENGTHS = {
+    1024, 65536, 1048576};
+constexpr std::size_t FONT_BENCHMARK_GLYPHS = 20000000;
+constexpr std::size_t FONT_BENCHMARK_LINE   = 80;
+
+// an entity as one object, the layout benchmark_scene compares against
+struct lobject {
+    GLfloat x       = {0};
+    GLfloat y       = {0};
+    lfrect  clip    = {0.f, 0.f, 0.f, 0.f};
+    GLuint  texture = {0};
+    GLuint  layer   = {0};
+    lcolor  tint    = {1.f, 1.f, 1.f, 1.f};
+};
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * runs given pass over the entities of benchmark_scene the benchmark
+      number of times, returns nanoseconds per entity
+side-effects: n/a
+*/
+template <typename Pass>
+double
+time_entity_passes(Pass pass)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < SCENE_BENCHMARK_PASSES; ++i) { pass(); }
+    const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(SCENE_BENCHMARK_ENTITIES) /
+           SCENE_BENCHMARK_PASSES;
+}
+
+// animated arrows
+static lanimation_set g_arrows;
+
+// scene objects
+static lscene g_scene;
+
+// arrow entities, in animation instance order
+static std::vector<lentity> g_arrow_entities;
+
+/*
+pre-conditions:
+    * runs on a job system worker
+post-conditions:
+    * advances the scene by one frame and records it into given list
+side-effects: n/a
+*/
+void build_frame(lcommand_list&);
+
+// frame N+1 is recorded on the workers while frame N is submitted, created
+// with the jobs and declared after them, so it is destroyed first
+static std::optional<lframe_pipeline> g_pipeline;
+
+// profiler data accumulated since last report
+static lframe_timings g_timings_sum;
+static int            g_timed_frames = 0;
+
+// in-window profiler report, between the top arrows
+static lfont       g_font;
+static std::string g_report = "FRAME MS: MEASURING";
+constexpr GLfloat  REPORT_SCALE = 2.f;
+constexpr GLfloat  REPORT_X     = 136.f;
+constexpr GLfloat  REPORT_Y     = 8.f;
 
 } // namespace
 
@@ -68,10 +182,13 @@ bool
 load_media(std::string_view path)
 {
     // set clip rectangles
-    g_arrow_clips = {lfrect{0.f, 0.f, 128.f, 128.f},
-                     lfrect{128.f, 0.f, 128.f, 128.f},
-                     lfrect{0.f, 128.f, 128.f, 128.f},
-                     lfrect{128.f, 128.f, 128.f, 128.f}};
+    const auto arrow_clips = std::array{lfrect{0.f, 0.f, 128.f, 128.f},
+                                        lfrect{128.f, 0.f, 128.f, 128.f},
+                                        lfrect{0.f, 128.f, 128.f, 128.f},
+                                        lfrect{128.f, 128.f, 128.f, 128.f}};
+
+    // a whole layer of the texture array
+    const auto layer_clip = lfrect{0.f, 0.f, 128.f, 128.f};
 
     // load texture
     if (!g_arrow_texture.load_from_file(path)) {
@@ -79,13 +196,83 @@ load_media(std::string_view path)
         return false;
     }
 
+    // load font
+    if (!g_font.load_builtin(REPORT_SCALE)) {
+        std::cerr << "unable to load font\n";
+        return false;
+    }
+
+    // arrows spin through all clips, each corner starting at its own clip
+    const auto spin = g_arrows.add_animation(
+        {{std::begin(arrow_clips), std::end(arrow_clips)}, 4.f});
+
+    // arrows of all frames draw together from array layers, the sheet is
+    // clipped otherwise
+    g_arrows_layered = ltexture_array::supported() &&
+                       g_arrow_layers.load_from_sheet(path, ARROW_SIZE);
+    std::cout << "arrows are drawn from "
+              << (g_arrows_layered ? "texture array layers" : "sheet clips")
+              << '\n';
+
+    // place arrows in the corners
+    const auto arrow_texture = g_arrows_layered
+                                   ? g_scene.add_texture(g_arrow_layers)
+                                   : g_scene.add_texture(g_arrow_texture);
+    const auto corners       = std::array{
+        std::array{0.f, 0.f},
+        std::array{SCREEN_WIDTH - arrow_clips[1][2], 0.f},
+        std::array{0.f, SCREEN_HEIGHT - arrow_clips[2][3]},
+        std::array{
+            SCREEN_WIDTH - arrow_clips[3][2],
+            SCREEN_HEIGHT - arrow_clips[3][3]}};
+
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+        g_arrows.add_instance(spin, 1.f, gsl::narrow<GLfloat>(i));
+        g_arrow_entities.push_back(
+            g_arrows_layered
+                ? g_scene.create(
+                      arrow_texture,
+                      corners[i],
+                      layer_clip,
+                      {1.f, 1.f, 1.f, 1.f},
+                      gsl::narrow<GLuint>(i))
+                : g_scene.create(arrow_texture, corners[i], arrow_clips[i]));
+    }
+
+    // start the workers and the frame pipeline, on the thread which
+    // submits to GL
+    g_jobs.emplace();
+    g_pipeline.emplace(*g_jobs, build_frame);
+
     return true;
 }
 
 void
 update()
 {
-    // TBD
+    // pick up the recorded frame and start the next one
+    g_pipeline->advance();
+
+    // show averages in the window every five seconds
+    const auto& timings = g_pipeline->timings();
+    g_timings_sum.build_ms += timings.build_ms;
+    g_timings_sum.stall_ms += timings.stall_ms;
+    g_timings_sum.submit_ms += timings.submit_ms;
+    if (++g_timed_frames == SCREEN_FPS * 5) {
+        const double frames = g_timed_frames;
+        char report[128];
+        std::snprintf(
+            report,
+            sizeof(report),
+            "FRAME MS\nBUILD  %.3f\nSTALL  %.3f\nSUBMIT %.3f",
+            g_timings_sum.build_ms / frames,
+            g_timings_sum.stall_ms / frames,
+            g_timings_sum.submit_ms / frames);
+        g_report = report;
+
+        g_timings_sum  = {};
+        g_timed_frames = 0;
+    }
 }
 
 void
@@ -94,17 +281,369 @@ render()
     // clear color buffer
     glClear(GL_COLOR_BUFFER_BIT);
 
-    // render arrows
-    g_arrow_texture.render({0.f, 0.f}, g_arrow_clips[0]);
-    g_arrow_texture.render(
-        {SCREEN_WIDTH - g_arrow_clips[1][2], 0.f}, g_arrow_clips[1]);
-    g_arrow_texture.render(
-        {0.f, SCREEN_HEIGHT - g_arrow_clips[2][2]}, g_arrow_clips[2]);
-    g_arrow_texture.render(
-        {SCREEN_WIDTH - g_arrow_clips[3][2],
-         SCREEN_HEIGHT - g_arrow_clips[3][3]},
-        g_arrow_clips[3]);
+    // replay the recorded frame
+    g_pipeline->submit();
+
+    // render profiler report
+    g_font.render({REPORT_X, REPORT_Y}, g_report);
 
     // update screen
     glutSwapBuffers();
 }
+
+bool
+benchmark_animation(std::string_view path)
+{
+    ltexture sheet;
+    if (!sheet.load_from_file(path)) return false;
+
+    const auto arrow_clips = std::array{lfrect{0.f, 0.f, 128.f, 128.f},
+                                        lfrect{128.f, 0.f, 128.f, 128.f},
+                                        lfrect{0.f, 128.f, 128.f, 128.f},
+                                        lfrect{128.f, 128.f, 128.f, 128.f}};
+
+    for (const auto count : ANIMATION_BENCHMARK_SIZES) {
+        // arrows spinning at different speeds and phases, both directions
+        lanimation_set animations;
+        const auto     spin = animations.add_animation(
+            {{std::begin(arrow_clips), std::end(arrow_clips)}, 4.f});
+        animations.reserve(count);
+
+        lscene               scene;
+        std::vector<lentity> entities;
+        scene.create(count, scene.add_texture(sheet), arrow_clips[0], entities);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto point = std::array{
+                gsl::narrow<GLfloat>(i * 37 % SCREEN_WIDTH),
+                gsl::narrow<GLfloat>(i * 53 % SCREEN_HEIGHT)};
+            const auto speed = gsl::narrow<GLfloat>(i % 7) * .5f - 1.f;
+            animations.add_instance(spin, speed, gsl::narrow<GLfloat>(i % 4));
+            scene.x()[i] = point[0];
+            scene.y()[i] = point[1];
+        }
+
+        const auto frames = std::max<std::size_t>(
+            ANIMATION_BENCHMARK_UPDATES / count, 1);
+
+        // bulk update alone
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            animations.update(FRAME_TIME);
+        }
+        const std::chrono::duration<double, std::nano> update =
+            std::chrono::steady_clock::now() - start;
+
+        // update, hand clips to the scene and record the batch drawing them
+        lcommand_list list;
+        scene.begin_batch(list);
+        start = std::chrono::steady_clock::now();
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            animations.update(FRAME_TIME);
+            lfrect* clips = scene.clips();
+            for (std::size_t i = 0; i < entities.size(); ++i) {
+                clips[scene.index(entities[i])] = animations.clip(i);
+            }
+            scene.build_batch(list, 0, scene.size());
+        }
+        const std::chrono::duration<double, std::nano> batched =
+            std::chrono::steady_clock::now() - start;
+
+        const double sprite_frames = static_cast<double>(count * frames);
+        std::cout << count << " animated sprites over " << frames
+                  << " frames: update " << update.count() / sprite_frames
+                  << " ns per sprite (" << sprite_frames * 1e3 / update.count()
+                  << " M sprites/s), with batch "
+                  << batched.count() / sprite_frames << " ns per sprite ("
+                  << sprite_frames * 1e3 / batched.count()
+                  << " M sprites/s)\n";
+    }
+
+    return true;
+}
+
+bool
+benchmark_scene()
+{
+    // the same entities in the scene store and as an array of objects
+    const auto           clip = lfrect{0.f, 0.f, 16.f, 16.f};
+    ltexture             texture;
+    lscene               scene;
+    std::vector<lentity> entities;
+    scene.create(
+        SCENE_BENCHMARK_ENTITIES, scene.add_texture(texture), clip, entities);
+
+    std::vector<lobject> objects(SCENE_BENCHMARK_ENTITIES);
+    for (std::size_t i = 0; i < SCENE_BENCHMARK_ENTITIES; ++i) {
+        const auto x = gsl::narrow<GLfloat>(i * 37 % (SCREEN_WIDTH * 2));
+        const auto y = gsl::narrow<GLfloat>(i * 53 % (SCREEN_HEIGHT * 2));
+        scene.x()[i]    = x;
+        scene.y()[i]    = y;
+        objects[i].x    = x;
+        objects[i].y    = y;
+        objects[i].clip = clip;
+    }
+
+    // update pass, both layouts drift the same way
+    const double soa_move =
+        time_entity_passes([&]() { scene.translate({1.f, -1.f}); });
+    const double aos_move = time_entity_passes([&]() {
+        for (auto& object : objects) {
+            object.x += 1.f;
+            object.y -= 1.f;
+        }
+    });
+
+    // render pass, entities overlapping the screen are counted as drawn
+    // without branching on each test
+    std::size_t soa_visible = 0;
+    std::size_t aos_visible = 0;
+    const double soa_cull = time_entity_passes([&]() {
+        const GLfloat* x     = scene.x();
+        const GLfloat* y     = scene.y();
+        const lfrect*  clips = scene.clips();
+        for (std::size_t i = 0; i < scene.size(); ++i) {
+            soa_visible += (x[i] < SCREEN_WIDTH) & (x[i] + clips[i][2] > 0.f) &
+                           (y[i] < SCREEN_HEIGHT) & (y[i] + clips[i][3] > 0.f);
+        }
+    });
+    const double aos_cull = time_entity_passes([&]() {
+        for (const auto& object : objects) {
+            aos_visible += (object.x < SCREEN_WIDTH) &
+                           (object.x + object.clip[2] > 0.f) &
+                           (object.y < SCREEN_HEIGHT) &
+                           (object.y + object.clip[3] > 0.f);
+        }
+    });
+
+    std::cout << SCENE_BENCHMARK_ENTITIES << " entities, " << sizeof(lobject)
+              << " byte objects\n"
+              << "move: scene " << soa_move << " ns per entity, objects "
+              << aos_move << " ns per entity\n"
+              << "cull: scene " << soa_cull << " ns per entity, objects "
+              << aos_cull << " ns per entity, "
+              << soa_visible / SCENE_BENCHMARK_PASSES << " and "
+              << aos_visible / SCENE_BENCHMARK_PASSES << " visible\n";
+
+    return true;
+}
+
+bool
+benchmark_jobs(std::string_view path, std::size_t max_workers)
+{
+    ltexture sheet;
+    if (!sheet.load_from_file(path)) return false;
+
+    const auto arrow_clips = std::array{lfrect{0.f, 0.f, 128.f, 128.f},
+                                        lfrect{128.f, 0.f, 128.f, 128.f},
+                                        lfrect{0.f, 128.f, 128.f, 128.f},
+                                        lfrect{128.f, 128.f, 128.f, 128.f}};
+
+    // animated arrows as the demo sets them up, only many more
+    lanimation_set animations;
+    const auto     spin = animations.add_animation(
+        {{std::begin(arrow_clips), std::end(arrow_clips)}, 4.f});
+    animations.reserve(JOBS_BENCHMARK_SPRITES);
+    for (std::size_t i = 0; i < JOBS_BENCHMARK_SPRITES; ++i) {
+        animations.add_instance(spin, 1.f, gsl::narrow<GLfloat>(i % 4));
+    }
+
+    lscene               scene;
+    std::vector<lentity> entities;
+    scene.create(
+        JOBS_BENCHMARK_SPRITES,
+        scene.add_texture(sheet),
+        arrow_clips[0],
+        entities);
+
+    double single_ms = 0.0;
+    for (std::size_t workers = 1; workers <= max_workers; ++workers) {
+        ljob_system   jobs(workers);
+        lcommand_list list;
+        scene.begin_batch(list);
+
+        // the frame work of build_frame, clips handed over inside the jobs
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < JOBS_BENCHMARK_FRAMES; ++frame) {
+            jobs.parallel_for(
+                animations.size(),
+                JOB_GRAIN,
+                [&](std::size_t begin, std::size_t end) {
+                    animations.update(FRAME_TIME, begin, end);
+                    lfrect* clips = scene.clips();
+                    for (std::size_t i = begin; i < end; ++i) {
+                        clips[scene.index(entities[i])] = animations.clip(i);
+                    }
+                });
+            jobs.parallel_for(
+                scene.size(),
+                JOB_GRAIN,
+                [&](std::size_t begin, std::size_t end) {
+                    scene.build_batch(list, begin, end);
+                });
+        }
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        const double frame_ms = elapsed.count() / JOBS_BENCHMARK_FRAMES;
+        if (workers == 1) single_ms = frame_ms;
+        std::cout << "workers " << workers << ": " << frame_ms
+                  << " ms per frame of " << JOBS_BENCHMARK_SPRITES
+                  << " sprites, speedup "
+                  << single_ms / frame_ms << '\n';
+    }
+
+    return true;
+}
+
+bool
+benchmark_font()
+{
+    lfont font;
+    if (!font.load_builtin(REPORT_SCALE)) return false;
+
+    for (const auto length : FONT_BENCHMARK_LENGTHS) {
+        // the characters of the profiler report, in lines
+        constexpr std::string_view characters = "FRAME MS BUILD STALL 0.123";
+        std::string                text(length, ' ');
+        for (std::size_t i = 0; i < length; ++i) {
+            text[i] = (i + 1) % FONT_BENCHMARK_LINE == 0
+                          ? '\n'
+                          : characters[i % characters.size()];
+        }
+
+        const auto passes =
+            std::max<std::size_t>(FONT_BENCHMARK_GLYPHS / length, 1);
+
+        // laid out every pass, as text changing every frame is
+        ltext_layout layout;
+        auto         start = std::chrono::steady_clock::now();
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            font.layout(text, layout);
+        }
+        const std::chrono::duration<double> uncached =
+            std::chrono::steady_clock::now() - start;
+
+        // laid out once, then found in the cache
+        std::size_t glyphs = font.shape(text).glyphs();
+        start              = std::chrono::steady_clock::now();
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            glyphs = font.shape(text).glyphs();
+        }
+        const std::chrono::duration<double> cached =
+            std::chrono::steady_clock::now() - start;
+
+        // blanks and line breaks are laid out too, so all characters count
+        const double laid_out = static_cast<double>(length * passes);
+        std::cout << length << " characters (" << glyphs
+                  << " glyph quads) over " << passes
+                  << " passes: uncached " << laid_out / uncached.count() / 1e6
+                  << " M glyphs/s, cached " << laid_out / cached.count() / 1e6
+                  << " M glyphs/s\n";
+    }
+
+    return true;
+}
+
+bool
+benchmark_texture_array(std::string_view path)
+{
+    ltexture_array layers;
+    if (!layers.load_from_sheet(path, ARROW_SIZE)) return false;
+
+    // the same arrows as one texture each, copied out of the layers
+    const auto          dims       = layers.get_dimensions();
+    const std::size_t   layer_size = std::size_t{dims[0]} * dims[1];
+    std::vector<GLuint> pixels(layer_size * layers.get_layers());
+    glBindTexture(GL_TEXTURE_2D_ARRAY, layers.get_texture_id());
+    glGetTexImage(
+        GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    std::vector<ltexture> textures(layers.get_layers());
+    for (std::size_t layer = 0; layer < textures.size(); ++layer) {
+        if (!textures[layer].load_from_pixels32(
+                &pixels[layer * layer_size], dims)) {
+            return false;
+        }
+    }
+
+    // arrows scattered over the screen with interleaved frames, the order
+    // animations leave them in
+    lscene per_texture;
+    lscene layered;
+    std::vector<GLuint> texture_handles;
+    for (const auto& texture : textures) {
+        texture_handles.push_back(per_texture.add_texture(texture));
+    }
+    const auto layers_handle = layered.add_texture(layers);
+
+    const auto clip = lfrect{
+        0.f, 0.f, gsl::narrow<GLfloat>(dims[0]), gsl::narrow<GLfloat>(dims[1])};
+    for (std::size_t i = 0; i < BENCHMARK_ARROWS; ++i) {
+        const auto point = std::array{
+            gsl::narrow<GLfloat>(i * 37 % (SCREEN_WIDTH - dims[0])),
+            gsl::narrow<GLfloat>(i * 53 % (SCREEN_HEIGHT - dims[1]))};
+        const auto layer = gsl::narrow<GLuint>(i % textures.size());
+        per_texture.create(texture_handles[layer], point, clip);
+        layered.create(layers_handle, point, clip, {1.f, 1.f, 1.f, 1.f}, layer);
+    }
+
+    for (auto [name, scene] : {std::pair{"per-texture", &per_texture},
+                               std::pair{"texture array", &layered}}) {
+        lcommand_list list;
+        scene->begin_batch(list);
+        scene->build_batch(list, 0, scene->size());
+
+        glFinish();
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < BENCHMARK_FRAMES; ++frame) {
+            glClear(GL_COLOR_BUFFER_BIT);
+            list.replay();
+            glFinish();
+        }
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        // every draw command binds its texture
+        std::cout << name << ": " << scene->size() << " arrows, "
+                  << list.draws() << " draw calls and texture binds, "
+                  << elapsed.count() / BENCHMARK_FRAMES << " ms per frame\n";
+    }
+
+    return true;
+}
+
+namespace {
+
+void
+build_frame(lcommand_list& list)
+{
+    // advance arrow animations
+    g_jobs->parallel_for(
+        g_arrows.size(), JOB_GRAIN, [](std::size_t begin, std::size_t end) {
+            g_arrows.update(FRAME_TIME, begin, end);
+        });
+
+    // hand current frames to the scene, as layers or clips
+    lfrect* clips  = g_scene.clips();
+    GLuint* layers = g_scene.layers();
+    for (std::size_t i = 0; i < g_arrow_entities.size(); ++i) {
+        const auto index = g_scene.index(g_arrow_entities[i]);
+        if (g_arrows_layered) {
+            layers[index] = g_arrows.frame(i);
+        } else {
+            clips[index] = g_arrows.clip(i);
+        }
+    }
+
+    // generate scene vertices
+    g_scene.begin_batch(list);
+    g_jobs->parallel_for(
+        g_scene.size(),
+        JOB_GRAIN,
+        [&list](std::size_t begin, std::size_t end) {
+            g_scene.build_batch(list, begin, end);
+        });
+}
+
+} // namespace
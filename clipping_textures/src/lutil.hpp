@@ -3,6 +3,7 @@
 
 #include "lopengl.hpp"
 
+#include <cstddef>
 #include <string_view>
 
 // screen constants
@@ -33,12 +34,14 @@ post-conditions:
     * loads media to use in the program
     * reports to console if there was an error in loading the media
     * returns true if the media loaded successfully
-side-effects: n/a
+side-effects:
+    * starts the job system workers and the frame pipeline
 */
 bool load_media(std::string_view path);
 
 /*
-pre-conditions: n/a
+pre-conditions:
+    * load_media succeeded
 post-conditions:
     * does per frame logic
 side-effects: n/a
@@ -49,6 +52,7 @@ void update();
 pre-conditions:
     * a valid OpenGL context
     * active modelview matrix
+    * load_media succeeded
 post-conditions:
     * renders the scene
 side-effects:
@@ -57,4 +61,68 @@ side-effects:
 */
 void render();
 
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initGL succeeded
+post-conditions:
+    * animates 10k to 1M arrows of the sheet at given path, forward and
+      backward, with and without recording the batch drawing them
+    * reports update times and sprites per second to console
+    * returns false if the sheet could not be loaded
+side-effects: n/a
+*/
+bool benchmark_animation(std::string_view path);
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * moves and culls 1M entities stored in a scene, then stored as an
+      array of objects
+    * reports times per entity of both to console
+    * returns true
+side-effects: n/a
+*/
+bool benchmark_scene();
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initGL succeeded
+post-conditions:
+    * animates 1M arrows of the sheet at given path and records their batch
+      with job systems of one up to given number of workers
+    * reports frame times and speedups over one worker to console
+    * returns false if the sheet could not be loaded
+side-effects: n/a
+*/
+bool benchmark_jobs(std::string_view path, std::size_t max_workers);
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initGL succeeded
+post-conditions:
+    * draws many arrows of the sheet at given path with one texture per
+      arrow, then with one texture array
+    * reports draw calls, texture binds and frame times of both to console
+    * returns false if the textures could not be loaded
+side-effects:
+    * clears the color buffer
+*/
+bool benchmark_texture_array(std::string_view path);
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+post-conditions:
+    * lays out strings of 1K to 1M characters with the built-in font, once
+      every pass and once through the shaped string cache
+    * reports glyphs per second of both to console
+    * returns false if the font could not be loaded
+side-effects:
+    * binds a null-texture
+*/
+bool benchmark_font();
+
 #endif // LUTIL_HPP
@@ -1,6 +1,9 @@
 #include "lutil.hpp"
 
-#include <cstdlib> // for EXIT_SUCCESS and EXIT_FAILURE
+#include <algorithm>
+#include <cstdlib> // for EXIT_SUCCESS, EXIT_FAILURE and std::strtoul
+#include <string_view>
+#include <thread>
 
 /*
 pre-condition:
@@ -33,6 +36,44 @@ main(int argc, char** args)
         return EXIT_FAILURE;
     }
 
+    // --texture-array-benchmark compares drawing arrows from separate
+    // textures and from a texture array, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--texture-array-benchmark") {
+        return benchmark_texture_array("../textures/clip.png") ? EXIT_SUCCESS
+                                                              : EXIT_FAILURE;
+    }
+
+    // --animation-benchmark advances 10k to 1M animated arrows, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--animation-benchmark") {
+        return benchmark_animation("../textures/clip.png") ? EXIT_SUCCESS
+                                                          : EXIT_FAILURE;
+    }
+
+    // --scene-benchmark compares iterating 1M entities of the scene store
+    // against an array of objects, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--scene-benchmark") {
+        return benchmark_scene() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --font-benchmark lays out long strings with and without the shaped
+    // string cache, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--font-benchmark") {
+        return benchmark_font() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --jobs-benchmark [workers] times the frame work of 1M arrows from one
+    // worker up to given workers, one per hardware thread by default, then
+    // exits
+    if ((argc == 2 || argc == 3) &&
+        std::string_view(args[1]) == "--jobs-benchmark") {
+        std::size_t workers = std::thread::hardware_concurrency();
+        if (argc == 3) workers = std::strtoul(args[2], nullptr, 10);
+        return benchmark_jobs(
+                   "../textures/clip.png", std::max<std::size_t>(workers, 1))
+                   ? EXIT_SUCCESS
+                   : EXIT_FAILURE;
+    }
+
     auto image_file = argc > 1 ? args[1] : "../textures/clip.png";
 
     // load media
@@ -0,0 +1,326 @@
+#include "lasset_pack.hpp"
+
+#include <algorithm>
+#include <cstdio>  // for std::fopen and std::fwrite
+#include <cstring> // for std::memcmp and std::strncpy
+
+#include <fcntl.h>    // for ::open
+#include <sys/mman.h> // for mmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for ::close
+
+#include <gsl/gsl_util> // for gsl::finally and gsl::narrow
+
+namespace {
+
+constexpr char ASSET_PACK_MAGIC[4] = {'L', 'P', 'A', 'K'};
+
+// encoded sizes, fields are stored in declaration order without padding
+constexpr std::size_t HEADER_SIZE = 16;
+constexpr std::size_t ENTRY_SIZE  = ASSET_NAME_SIZE + 4 * 4 + 2 * 8;
+
+// integers are little-endian whatever the host order
+std::uint32_t
+load_u32(const GLubyte* bytes)
+{
+    return std::uint32_t{bytes[0]} | std::uint32_t{bytes[1]} << 8 |
+           std::uint32_t{bytes[2]} << 16 | std::uint32_t{bytes[3]} << 24;
+}
+
+std::uint64_t
+load_u64(const GLubyte* bytes)
+{
+    return load_u32(bytes) | std::uint64_t{load_u32(bytes + 4)} << 32;
+}
+
+GLubyte*
+store_u32(GLubyte* bytes, std::uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        *bytes++ = static_cast<GLubyte>(value >> (i * 8));
+    }
+    return bytes;
+}
+
+GLubyte*
+store_u64(GLubyte* bytes, std::uint64_t value)
+{
+    bytes = store_u32(bytes, static_cast<std::uint32_t>(value));
+    return store_u32(bytes, static_cast<std::uint32_t>(value >> 32));
+}
+
+lasset_pack_header
+decode_header(const GLubyte* bytes)
+{
+    lasset_pack_header header;
+    std::memcpy(header.magic, bytes, 4);
+    header.version  = load_u32(bytes + 4);
+    header.count    = load_u32(bytes + 8);
+    header.reserved = load_u32(bytes + 12);
+    return header;
+}
+
+void
+encode_header(const lasset_pack_header& header, GLubyte* bytes)
+{
+    std::memcpy(bytes, header.magic, 4);
+    bytes = store_u32(bytes + 4, header.version);
+    bytes = store_u32(bytes, header.count);
+    store_u32(bytes, header.reserved);
+}
+
+lasset_pack_entry
+decode_entry(const GLubyte* bytes)
+{
+    lasset_pack_entry entry;
+    std::memcpy(entry.name, bytes, ASSET_NAME_SIZE);
+    bytes += ASSET_NAME_SIZE;
+    entry.format   = load_u32(bytes);
+    entry.width    = load_u32(bytes + 4);
+    entry.height   = load_u32(bytes + 8);
+    entry.reserved = load_u32(bytes + 12);
+    entry.offset   = load_u64(bytes + 16);
+    entry.size     = load_u64(bytes + 24);
+    return entry;
+}
+
+void
+encode_entry(const lasset_pack_entry& entry, GLubyte* bytes)
+{
+    std::memcpy(bytes, entry.name, ASSET_NAME_SIZE);
+    bytes = store_u32(bytes + ASSET_NAME_SIZE, entry.format);
+    bytes = store_u32(bytes, entry.width);
+    bytes = store_u32(bytes, entry.height);
+    bytes = store_u32(bytes, entry.reserved);
+    bytes = store_u64(bytes, entry.offset);
+    store_u64(bytes, entry.size);
+}
+
+constexpr std::size_t
+aligned(std::size_t offset)
+{
+    return (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT *
+           ASSET_PACK_ALIGNMENT;
+}
+
+std::string_view
+entry_name(const lasset_pack_entry& entry)
+{
+    return {entry.name, strnlen(entry.name, ASSET_NAME_SIZE)};
+}
+
+bool
+valid_entry(const lasset_pack_entry& entry, std::size_t pack_size)
+{
+    if (entry_name(entry).size() == ASSET_NAME_SIZE) return false;
+    if (entry.format > PIXEL_FORMAT_RGBA16F) return false;
+    if (entry.offset % ASSET_PACK_ALIGNMENT != 0) return false;
+    if (entry.offset > pack_size || entry.size > pack_size - entry.offset) {
+        return false;
+    }
+
+    const auto format = static_cast<lpixel_format>(entry.format);
+    return entry.size == std::uint64_t{entry.width} * entry.height *
+                             pixel_format_info(format).bytes_per_pixel;
+}
+
+} // namespace
+
+lasset_pack::~lasset_pack()
+{
+    close();
+}
+
+bool
+lasset_pack::open(std::string_view path)
+{
+    close();
+
+    int file = ::open(path.data(), O_RDONLY);
+    if (file < 0) {
+        std::cerr << "unable to open asset pack " << path << '\n';
+        return false;
+    }
+    auto _ = gsl::finally([file]() { ::close(file); });
+
+    struct stat status;
+    if (fstat(file, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < HEADER_SIZE) {
+        std::cerr << "asset pack " << path << " is too small\n";
+        return false;
+    }
+
+    // one mapping for the whole pack, the mapping outlives the descriptor
+    const auto size = static_cast<std::size_t>(status.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "unable to map asset pack " << path << '\n';
+        return false;
+    }
+
+    // assets are usually all loaded, read the file ahead sequentially
+    madvise(data, size, MADV_WILLNEED);
+
+    _data = static_cast<const GLubyte*>(data);
+    _size = size;
+
+    // validate header and index
+    const auto header = decode_header(_data);
+    if (std::memcmp(header.magic, ASSET_PACK_MAGIC, 4) != 0 ||
+        header.version != ASSET_PACK_VERSION ||
+        header.count > (_size - HEADER_SIZE) / ENTRY_SIZE) {
+        std::cerr << path << " is not a valid asset pack\n";
+        close();
+        return false;
+    }
+
+    _entries.reserve(header.count);
+    for (std::size_t i = 0; i < header.count; ++i) {
+        _entries.push_back(decode_entry(_data + HEADER_SIZE + i * ENTRY_SIZE));
+        if (!valid_entry(_entries[i], _size)) {
+            std::cerr << "asset " << i << " of " << path << " is corrupt\n";
+            close();
+            return false;
+        }
+
+        // find() searches the index, it needs names sorted and unique
+        if (i > 0 && !(entry_name(_entries[i - 1]) < entry_name(_entries[i]))) {
+            std::cerr << "asset " << i << " of " << path
+                      << " is out of order or a duplicate\n";
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+lasset_pack::close()
+{
+    if (_data) munmap(const_cast<GLubyte*>(_data), _size);
+
+    _data = nullptr;
+    _size = 0;
+    _entries.clear();
+}
+
+std::size_t
+lasset_pack::size() const
+{
+    return _entries.size();
+}
+
+lasset
+lasset_pack::at(std::size_t index) const
+{
+    const auto& entry = _entries[index];
+
+    lasset asset;
+    asset.name       = entry_name(entry);
+    asset.format     = static_cast<lpixel_format>(entry.format);
+    asset.dimensions = {entry.width, entry.height};
+    asset.pixels     = _data + entry.offset;
+    asset.size       = static_cast<std::size_t>(entry.size);
+    return asset;
+}
+
+std::optional<lasset>
+lasset_pack::find(std::string_view name) const
+{
+    // index is sorted by name, open() checked
+    const auto entry = std::lower_bound(
+        _entries.begin(),
+        _entries.end(),
+        name,
+        [](const lasset_pack_entry& e, std::string_view n) {
+            return entry_name(e) < n;
+        });
+
+    if (entry == _entries.end() || entry_name(*entry) != name) {
+        return std::nullopt;
+    }
+
+    return at(static_cast<std::size_t>(entry - _entries.begin()));
+}
+
+bool
+write_asset_pack(std::string_view path, std::vector<lasset_source> sources)
+{
+    std::sort(sources.begin(), sources.end(), [](const auto& a, const auto& b) {
+        return a.name < b.name;
+    });
+
+    // find() could only ever return one of them
+    const auto duplicate = std::adjacent_find(
+        sources.begin(), sources.end(), [](const auto& a, const auto& b) {
+            return a.name == b.name;
+        });
+    if (duplicate != sources.end()) {
+        std::cerr << "asset name " << duplicate->name << " is not unique\n";
+        return false;
+    }
+
+    // build header and index
+    lasset_pack_header header = {};
+    std::memcpy(header.magic, ASSET_PACK_MAGIC, 4);
+    header.version = ASSET_PACK_VERSION;
+    header.count   = gsl::narrow<std::uint32_t>(sources.size());
+
+    std::vector<lasset_pack_entry> entries(sources.size());
+    std::size_t offset = aligned(HEADER_SIZE + ENTRY_SIZE * entries.size());
+
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        const auto& source = sources[i];
+        auto&       entry  = entries[i];
+
+        if (source.name.size() >= ASSET_NAME_SIZE) {
+            std::cerr << "asset name " << source.name << " is too long\n";
+            return false;
+        }
+
+        std::strncpy(entry.name, source.name.c_str(), ASSET_NAME_SIZE);
+        entry.format = static_cast<std::uint32_t>(source.format);
+        entry.width  = source.dimensions[0];
+        entry.height = source.dimensions[1];
+        entry.offset = offset;
+        entry.size   = source.pixels.size();
+
+        offset = aligned(offset + source.pixels.size());
+    }
+
+    std::FILE* file = std::fopen(path.data(), "wb");
+    if (!file) {
+        std::cerr << "unable to create asset pack " << path << '\n';
+        return false;
+    }
+
+    // header, index and payloads in one sequential pass
+    static const GLubyte padding[ASSET_PACK_ALIGNMENT] = {0};
+    std::size_t          written                       = 0;
+    auto write = [&file, &written](const void* data, std::size_t size) {
+        written += size;
+        return std::fwrite(data, 1, size, file) == size;
+    };
+    auto pad = [&write, &written]() {
+        return write(padding, aligned(written) - written);
+    };
+
+    // header and index encoded in one block
+    std::vector<GLubyte> index(HEADER_SIZE + ENTRY_SIZE * entries.size());
+    encode_header(header, index.data());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        encode_entry(entries[i], index.data() + HEADER_SIZE + i * ENTRY_SIZE);
+    }
+
+    bool success = write(index.data(), index.size());
+    for (const auto& source : sources) {
+        success = success && pad() &&
+                  write(source.pixels.data(), source.pixels.size());
+    }
+
+    success = std::fclose(file) == 0 && success;
+    if (!success) std::cerr << "unable to write asset pack " << path << '\n';
+
+    return success;
+}
@@ -0,0 +1,142 @@
+#ifndef LASSET_PACK_HPP
+#define LASSET_PACK_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "lopengl.hpp"
+#include "lpixel_format.hpp"
+
+/*
+Asset pack layout, all integers little-endian:
+
+    header   magic "LPAK", version, entry count, reserved (16 bytes)
+    index    entry count lasset_pack_entry records sorted by name
+    payloads pixels of each entry in its format, rows unpadded, every payload
+             starting on an ASSET_PACK_ALIGNMENT boundary
+
+Payloads are ready for glTexImage2D, so a mapped pack hands them to GL as is.
+*/
+constexpr std::uint32_t ASSET_PACK_VERSION   = 1;
+constexpr std::size_t   ASSET_PACK_ALIGNMENT = 64;
+constexpr std::size_t   ASSET_NAME_SIZE      = 48;
+
+// header and index records in host order, see lasset_pack.cpp for their
+// encoding
+struct lasset_pack_header {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+struct lasset_pack_entry {
+    char          name[ASSET_NAME_SIZE]; // null-terminated
+    std::uint32_t format;                // lpixel_format
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t reserved;
+    std::uint64_t offset; // from start of the pack
+    std::uint64_t size;   // in bytes
+};
+
+/*
+Asset inside a mapped pack, pointers stay valid while the pack is open.
+*/
+struct lasset {
+    std::string_view      name;
+    lpixel_format         format     = {PIXEL_FORMAT_RGBA8};
+    std::array<GLuint, 2> dimensions = {0, 0};
+    const void*           pixels     = {nullptr};
+    std::size_t           size       = {0};
+};
+
+/*
+Asset to write into a pack, pixels are in the given format.
+*/
+struct lasset_source {
+    std::string           name;
+    lpixel_format         format     = {PIXEL_FORMAT_RGBA8};
+    std::array<GLuint, 2> dimensions = {0, 0};
+    std::vector<GLubyte>  pixels;
+};
+
+/*
+Read-only asset pack mapped into memory. Opening maps the whole file with one
+call and asks the kernel to read it ahead, assets are then plain pointers into
+the mapping.
+*/
+class lasset_pack {
+    // mapped file
+    const GLubyte* _data = {nullptr};
+    std::size_t    _size = {0};
+
+    // index decoded from the mapping
+    std::vector<lasset_pack_entry> _entries;
+
+public:
+    lasset_pack() = default;
+    ~lasset_pack();
+
+    lasset_pack(const lasset_pack&) = delete;
+    lasset_pack& operator=(const lasset_pack&) = delete;
+
+    /*
+    pre-conditions:
+        * null-terminated path
+    post-conditions:
+        * closes the open pack, maps the given one and validates its index,
+          names must be sorted and unique
+        * reports error to console if pack could not be opened
+    side-effects: n/a
+    */
+    bool open(std::string_view path);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * unmaps the pack, invalidating its assets
+    side-effects: n/a
+    */
+    void close();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of assets
+    side-effects: n/a
+    */
+    std::size_t size() const;
+
+    /*
+    pre-conditions:
+        * index < size()
+    post-conditions: returns asset at given index
+    side-effects: n/a
+    */
+    lasset at(std::size_t index) const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns asset of given name if the pack has one
+    side-effects: n/a
+    */
+    std::optional<lasset> find(std::string_view name) const;
+};
+
+/*
+pre-conditions:
+    * null-terminated path
+post-conditions:
+    * writes the assets into a pack at given path
+    * reports error to console if pack could not be written, or names are
+      not unique or not shorter than ASSET_NAME_SIZE
+side-effects: n/a
+*/
+bool write_asset_pack(std::string_view path, std::vector<lasset_source>);
+
+#endif // LASSET_PACK_HPP
@@ -0,0 +1,545 @@
+#include "lcapture.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>  // for std::fopen and std::snprintf
+#include <cstring> // for std::memcpy and std::memset
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif // HAVE_LIBPNG
+
+#include <gsl/gsl_util> // for gsl::narrow
+
+#include "macro_helpers.hpp"
+
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
+namespace {
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * appends given RGBA8 pixels, top row first, as a QOI image, see
+      https://qoiformat.org/qoi-specification.pdf
+side-effects: n/a
+*/
+void
+encode_qoi(
+    const std::vector<GLubyte>& pixels,
+    std::array<GLuint, 2>       dimensions,
+    std::vector<GLubyte>&       out)
+{
+    constexpr GLubyte OP_INDEX = 0x00;
+    constexpr GLubyte OP_DIFF  = 0x40;
+    constexpr GLubyte OP_LUMA  = 0x80;
+    constexpr GLubyte OP_RUN   = 0xc0;
+    constexpr GLubyte OP_RGB   = 0xfe;
+    constexpr GLubyte OP_RGBA  = 0xff;
+    constexpr int     MAX_RUN  = 62;
+
+    const auto push_u32 = [&out](GLuint value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<GLubyte>(value >> shift));
+        }
+    };
+
+    // header, four channels of sRGB with linear alpha
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    push_u32(Wv(dimensions));
+    push_u32(Hv(dimensions));
+    out.push_back(4);
+    out.push_back(0);
+
+    // byte wrapping differences, as signed
+    const auto diff = [](GLubyte a, GLubyte b) {
+        return static_cast<int>(static_cast<signed char>(a - b));
+    };
+
+    std::array<std::array<GLubyte, 4>, 64> seen     = {};
+    std::array<GLubyte, 4>                 previous = {0, 0, 0, 0xff};
+    int                                    run      = 0;
+
+    const std::size_t count = pixels.size() / 4;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::array<GLubyte, 4> pixel = {
+            pixels[i * 4],
+            pixels[i * 4 + 1],
+            pixels[i * 4 + 2],
+            pixels[i * 4 + 3]};
+
+        if (pixel == previous) {
+            if (++run == MAX_RUN || i + 1 == count) {
+                out.push_back(static_cast<GLubyte>(OP_RUN | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run > 0) {
+            out.push_back(static_cast<GLubyte>(OP_RUN | (run - 1)));
+            run = 0;
+        }
+
+        const std::size_t hash =
+            (Rc(pixel) * 3u + Gc(pixel) * 5u + Bc(pixel) * 7u +
+             Ac(pixel) * 11u) %
+            64u;
+        if (seen[hash] == pixel) {
+            out.push_back(static_cast<GLubyte>(OP_INDEX | hash));
+        } else if (Ac(pixel) != Ac(previous)) {
+            seen[hash] = pixel;
+            out.insert(
+                out.end(),
+                {OP_RGBA, Rc(pixel), Gc(pixel), Bc(pixel), Ac(pixel)});
+        } else {
+            seen[hash] = pixel;
+
+            const int dr = diff(Rc(pixel), Rc(previous));
+            const int dg = diff(Gc(pixel), Gc(previous));
+            const int db = diff(Bc(pixel), Bc(previous));
+
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 &&
+                db <= 1) {
+                out.push_back(static_cast<GLubyte>(
+                    OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+            } else if (
+                dg >= -32 && dg <= 31 && dr - dg >= -8 && dr - dg <= 7 &&
+                db - dg >= -8 && db - dg <= 7) {
+                out.push_back(static_cast<GLubyte>(OP_LUMA | (dg + 32)));
+                out.push_back(
+                    static_cast<GLubyte>((dr - dg + 8) << 4 | (db - dg + 8)));
+            } else {
+                out.insert(
+                    out.end(), {OP_RGB, Rc(pixel), Gc(pixel), Bc(pixel)});
+            }
+        }
+
+        previous = pixel;
+    }
+
+    // end marker
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+}
+
+bool
+write_file(const std::string& path, const GLubyte* data, std::size_t size)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    const bool written = std::fwrite(data, 1, size, file) == size;
+    return std::fclose(file) == 0 && written;
+}
+
+const char*
+extension(lcapture_format format)
+{
+    switch (format) {
+    case CAPTURE_FORMAT_RAW: return ".rgba";
+    case CAPTURE_FORMAT_QOI: return ".qoi";
+    case CAPTURE_FORMAT_PNG: return ".png";
+    }
+    return "";
+}
+
+double
+seconds_since(std::chrono::steady_clock::time_point start)
+{
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+std::size_t
+save_capture(
+    const std::string&    path,
+    lcapture_format       format,
+    std::array<GLuint, 2> dimensions,
+    std::vector<GLubyte>& pixels)
+{
+    const std::size_t row_bytes = std::size_t{Wv(dimensions)} * 4;
+    const std::size_t height    = Hv(dimensions);
+
+    // GL reads the bottom row first, files start at the top
+    for (std::size_t y = 0; y < height / 2; ++y) {
+        std::swap_ranges(
+            pixels.begin() + gsl::narrow<std::ptrdiff_t>(y * row_bytes),
+            pixels.begin() + gsl::narrow<std::ptrdiff_t>((y + 1) * row_bytes),
+            pixels.begin() +
+                gsl::narrow<std::ptrdiff_t>((height - 1 - y) * row_bytes));
+    }
+
+    // the window shows no alpha, whatever blending left in the back buffer
+    for (std::size_t i = 3; i < pixels.size(); i += 4) { pixels[i] = 0xff; }
+
+    std::size_t bytes = 0;
+    switch (format) {
+    case CAPTURE_FORMAT_RAW:
+        if (write_file(path, pixels.data(), pixels.size())) {
+            bytes = pixels.size();
+        }
+        break;
+
+    case CAPTURE_FORMAT_QOI: {
+        std::vector<GLubyte> encoded;
+        encode_qoi(pixels, dimensions, encoded);
+        if (write_file(path, encoded.data(), encoded.size())) {
+            bytes = encoded.size();
+        }
+        break;
+    }
+
+    case CAPTURE_FORMAT_PNG: {
+#ifdef HAVE_LIBPNG
+        png_image png;
+        std::memset(&png, 0, sizeof(png));
+        png.version = PNG_IMAGE_VERSION;
+        png.width   = Wv(dimensions);
+        png.height  = Hv(dimensions);
+        png.format  = PNG_FORMAT_RGBA;
+
+        if (!png_image_write_to_file(
+                &png, path.c_str(), 0, pixels.data(), 0, nullptr)) {
+            std::cerr << "libpng: " << png.message << '\n';
+        } else if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+            // the simplified API does not tell how much it wrote
+            std::fseek(file, 0, SEEK_END);
+            bytes = gsl::narrow<std::size_t>(std::ftell(file));
+            std::fclose(file);
+        }
+#endif // HAVE_LIBPNG
+        break;
+    }
+    }
+
+    if (bytes == 0) std::cerr << "unable to write capture " << path << '\n';
+    return bytes;
+}
+
+lcapture::lcapture() = default;
+
+lcapture::~lcapture()
+{
+    free_capture();
+}
+
+bool
+lcapture::supported()
+{
+    return gl_supported(2, 1, "GL_ARB_pixel_buffer_object");
+}
+
+bool
+lcapture::format_supported(lcapture_format format)
+{
+#ifdef HAVE_LIBPNG
+    return format == CAPTURE_FORMAT_RAW || format == CAPTURE_FORMAT_QOI ||
+           format == CAPTURE_FORMAT_PNG;
+#else
+    return format == CAPTURE_FORMAT_RAW || format == CAPTURE_FORMAT_QOI;
+#endif // HAVE_LIBPNG
+}
+
+bool
+lcapture::init(
+    std::array<GLuint, 2> dimensions,
+    std::size_t           pack_buffers,
+    std::size_t           queued_frames)
+{
+    free_capture();
+
+    if (!supported()) {
+        std::cerr << "pixel buffer objects are not supported\n";
+        return false;
+    }
+
+    _dimensions = dimensions;
+    _fences     = gl_supported(3, 2, "GL_ARB_sync");
+    _max_frames = queued_frames;
+    _stop       = false;
+
+    // storage for one frame each, read by the CPU once
+    _readbacks.resize(std::max<std::size_t>(pack_buffers, 2));
+    const auto bytes = gsl::narrow<GLsizeiptr>(
+        std::size_t{Wv(dimensions)} * Hv(dimensions) * 4);
+    for (auto& readback : _readbacks) {
+        glGenBuffers(1, &readback.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    _worker = std::thread([this]() { work(); });
+    return true;
+}
+
+void
+lcapture::free_capture()
+{
+    if (_readbacks.empty()) return;
+
+    finish();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _worker.join();
+
+    for (auto& readback : _readbacks) {
+        glDeleteBuffers(1, &readback.buffer);
+    }
+    _readbacks.clear();
+    _free_pixels.clear();
+    _oldest    = 0;
+    _in_flight = 0;
+    _screenshot.clear();
+    _recording.clear();
+}
+
+void
+lcapture::set_synchronous(bool synchronous)
+{
+    _synchronous = synchronous;
+}
+
+bool
+lcapture::screenshot(std::string path, lcapture_format format)
+{
+    if (!format_supported(format)) {
+        std::cerr << "unable to capture " << path << ", format unsupported\n";
+        return false;
+    }
+
+    _screenshot        = std::move(path);
+    _screenshot_format = format;
+    return true;
+}
+
+bool
+lcapture::start_recording(std::string prefix, lcapture_format format)
+{
+    if (!format_supported(format)) {
+        std::cerr << "unable to record " << prefix << ", format unsupported\n";
+        return false;
+    }
+
+    _recording        = std::move(prefix);
+    _recording_format = format;
+    _recorded         = 0;
+    return true;
+}
+
+void
+lcapture::stop_recording()
+{
+    _recording.clear();
+}
+
+bool
+lcapture::is_recording() const
+{
+    return !_recording.empty();
+}
+
+void
+lcapture::issue(std::string path, lcapture_format format)
+{
+    const auto width  = gsl::narrow<GLsizei>(Wv(_dimensions));
+    const auto height = gsl::narrow<GLsizei>(Hv(_dimensions));
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.frames_requested;
+    }
+
+    // the naive way, stalls until the GPU finished the frame and the file
+    // is written
+    if (_synchronous) {
+        std::vector<GLubyte> pixels(std::size_t{Wv(_dimensions)} *
+                                    Hv(_dimensions) * 4);
+        glReadPixels(
+            0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        const std::size_t bytes =
+            save_capture(path, format, _dimensions, pixels);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++(bytes ? _stats.frames_written : _stats.frames_failed);
+        _stats.pixel_bytes += pixels.size();
+        _stats.encoded_bytes += bytes;
+        return;
+    }
+
+    if (_in_flight == _readbacks.size()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.dropped_readback;
+        return;
+    }
+
+    // the read is queued behind the frame, the call returns at once
+    auto& readback =
+        _readbacks[(_oldest + _in_flight) % _readbacks.size()];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    if (_fences) readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    readback.frame  = _frame;
+    readback.path   = std::move(path);
+    readback.format = format;
+    ++_in_flight;
+}
+
+void
+lcapture::retire()
+{
+    auto& readback = _readbacks[_oldest];
+    _oldest        = (_oldest + 1) % _readbacks.size();
+    --_in_flight;
+
+    if (readback.fence) {
+        glDeleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+
+    lframe frame;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_frames.size() >= _max_frames) {
+            ++_stats.dropped_encoder;
+            return;
+        }
+
+        // reuse the pixels of encoded frames
+        if (!_free_pixels.empty()) {
+            frame.pixels = std::move(_free_pixels.back());
+            _free_pixels.pop_back();
+        }
+    }
+    frame.pixels.resize(std::size_t{Wv(_dimensions)} * Hv(_dimensions) * 4);
+
+    // maps without waiting when the fence signaled, waits for the read
+    // otherwise
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    const void* mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (!mapped) {
+        std::cerr << "unable to map capture of " << readback.path << '\n';
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.frames_failed;
+        return;
+    }
+    std::memcpy(frame.pixels.data(), mapped, frame.pixels.size());
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+    frame.path   = std::move(readback.path);
+    frame.format = readback.format;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _frames.push_back(std::move(frame));
+    }
+    _wake.notify_one();
+}
+
+void
+lcapture::capture_frame()
+{
+    if (_readbacks.empty()) return;
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool busy  = _in_flight != 0;
+
+    // hand over finished reads in order, without fences a read is taken as
+    // finished once the ring would wrap around to it
+    while (_in_flight != 0) {
+        const auto& readback = _readbacks[_oldest];
+        if (_fences ? glClientWaitSync(readback.fence, 0, 0) ==
+                          GL_TIMEOUT_EXPIRED
+                    : _frame - readback.frame < _readbacks.size() - 1) {
+            break;
+        }
+        retire();
+    }
+
+    const bool wanted = !_screenshot.empty() || !_recording.empty();
+    if (!_screenshot.empty()) {
+        issue(std::move(_screenshot), _screenshot_format);
+        _screenshot.clear();
+    }
+
+    // numbers of dropped frames are skipped, gaps show in the sequence
+    if (!_recording.empty()) {
+        char number[16] = {};
+        std::snprintf(number, sizeof(number), "%05zu", _recorded++);
+        issue(
+            _recording + number + extension(_recording_format),
+            _recording_format);
+    }
+
+    if (busy || wanted) glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    ++_frame;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.capture_seconds += seconds_since(start);
+}
+
+void
+lcapture::finish()
+{
+    // mapping waits for the reads
+    const bool busy = _in_flight != 0;
+    while (_in_flight != 0) { retire(); }
+    if (busy) glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this]() { return _frames.empty() && _encoding == 0; });
+}
+
+lcapture_stats
+lcapture::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void
+lcapture::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats = {};
+}
+
+void
+lcapture::work()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _wake.wait(lock, [this]() { return _stop || !_frames.empty(); });
+
+        // stopping waits for the queue to drain
+        if (_frames.empty()) return;
+
+        lframe frame = std::move(_frames.front());
+        _frames.pop_front();
+        ++_encoding;
+
+        lock.unlock();
+        const auto        start = std::chrono::steady_clock::now();
+        const std::size_t bytes =
+            save_capture(frame.path, frame.format, _dimensions, frame.pixels);
+        const double elapsed = seconds_since(start);
+        lock.lock();
+
+        ++(bytes ? _stats.frames_written : _stats.frames_failed);
+        _stats.pixel_bytes += frame.pixels.size();
+        _stats.encoded_bytes += bytes;
+        _stats.encode_seconds += elapsed;
+        _free_pixels.push_back(std::move(frame.pixels));
+
+        if (--_encoding == 0 && _frames.empty()) _idle.notify_all();
+    }
+}
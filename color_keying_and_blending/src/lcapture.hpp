@@ -0,0 +1,250 @@
+#ifndef LCAPTURE_HPP
+#define LCAPTURE_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lopengl.hpp"
+
+enum lcapture_format { // no classes, like the pixel formats
+    CAPTURE_FORMAT_RAW, // RGBA8 rows top to bottom, no header
+    CAPTURE_FORMAT_QOI, // "Quite OK Image" format, RGBA
+    CAPTURE_FORMAT_PNG  // needs libpng
+};
+
+// counters since the last reset, frames of screenshots and recordings alike
+struct lcapture_stats {
+    std::size_t frames_requested = {0};
+    std::size_t frames_written   = {0};
+    std::size_t frames_failed    = {0}; // files which could not be written
+
+    // every pack buffer was still waiting for the GPU
+    std::size_t dropped_readback = {0};
+
+    // the encoder had a full queue
+    std::size_t dropped_encoder = {0};
+
+    std::size_t pixel_bytes   = {0}; // read back and encoded
+    std::size_t encoded_bytes = {0}; // written to files
+
+    // time the GL thread spent capturing, the worker spent encoding
+    double capture_seconds = {0};
+    double encode_seconds  = {0};
+};
+
+/*
+Captures the back buffer into image files without stalling the frame. Each
+captured frame is read into the next of a ring of pixel pack buffers; the
+read completes on the GPU while the following frames render, and a fence
+tells when its pixels may be mapped. Without sync objects they are mapped a
+fixed number of frames later, one less than there are pack buffers. Mapped
+pixels are copied out and handed to a worker thread, which flips them top
+to bottom, encodes and writes them. When the GPU or the encoder falls
+behind, new frames are dropped and counted rather than waited for.
+*/
+class lcapture {
+    struct lframe {
+        std::vector<GLubyte> pixels;
+        std::string          path;
+        lcapture_format      format = {CAPTURE_FORMAT_RAW};
+    };
+
+    // a pack buffer and the frame being read into it
+    struct lreadback {
+        GLuint          buffer = {0};
+        GLsync          fence  = {nullptr};
+        std::size_t     frame  = {0};
+        std::string     path;
+        lcapture_format format = {CAPTURE_FORMAT_RAW};
+    };
+
+    std::array<GLuint, 2> _dimensions = {0, 0};
+    bool                  _synchronous = {false};
+    bool                  _fences      = {false};
+
+    // ring of pack buffers, _in_flight of them from _oldest on are reading
+    std::vector<lreadback> _readbacks;
+    std::size_t            _oldest    = {0};
+    std::size_t            _in_flight = {0};
+    std::size_t            _frame     = {0};
+
+    // next frame to capture
+    std::string     _screenshot;
+    lcapture_format _screenshot_format = {CAPTURE_FORMAT_RAW};
+    std::string     _recording;
+    lcapture_format _recording_format = {CAPTURE_FORMAT_RAW};
+    std::size_t     _recorded         = {0};
+
+    // state shared with the worker
+    mutable std::mutex                _mutex;
+    std::condition_variable           _wake;
+    std::condition_variable           _idle;
+    std::deque<lframe>                _frames;
+    std::vector<std::vector<GLubyte>> _free_pixels;
+    std::size_t                       _max_frames = {0};
+    std::size_t                       _encoding   = {0};
+    bool                              _stop       = {false};
+    lcapture_stats                    _stats;
+    std::thread                       _worker;
+
+    void issue(std::string path, lcapture_format);
+    void retire();
+    void work();
+
+public:
+    lcapture();
+    ~lcapture();
+
+    lcapture(const lcapture&) = delete;
+    lcapture& operator=(const lcapture&) = delete;
+
+    /*
+    pre-conditions: valid GL context
+    post-conditions: returns true if the context has pixel buffer objects
+    side-effects: n/a
+    */
+    static bool supported();
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns true if frames can be encoded to the format, PNG needs
+          libpng
+    side-effects: n/a
+    */
+    static bool format_supported(lcapture_format);
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * at least two pack buffers
+    post-conditions:
+        * captures the given region from the bottom left of the back
+          buffer through given number of pack buffers, with at most given
+          number of frames waiting for the encoder
+        * starts the encoder thread
+        * reports error to console and returns false if pack buffers are
+          not supported
+    side-effects: n/a
+    */
+    bool init(
+        std::array<GLuint, 2> dimensions,
+        std::size_t           pack_buffers  = 3,
+        std::size_t           queued_frames = 8);
+
+    /*
+    pre-conditions: valid GL context
+    post-conditions:
+        * writes the frames in flight, then stops the encoder thread and
+          deletes the pack buffers
+    side-effects: n/a
+    */
+    void free_capture();
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * with synchronous set, frames are read into client memory and
+          encoded on the GL thread as they are captured, to compare against
+    side-effects: n/a
+    */
+    void set_synchronous(bool);
+
+    /*
+    pre-conditions: init succeeded
+    post-conditions:
+        * the next captured frame is written to given path
+        * returns false if the format is not supported
+    side-effects: n/a
+    */
+    bool screenshot(std::string path, lcapture_format);
+
+    /*
+    pre-conditions: init succeeded
+    post-conditions:
+        * every captured frame is written to given prefix followed by a
+          five digit frame number and the extension of the format, until
+          stop_recording
+        * returns false if the format is not supported
+    side-effects: n/a
+    */
+    bool start_recording(std::string prefix, lcapture_format);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * stops recording, frames in flight are still written
+    side-effects: n/a
+    */
+    void stop_recording();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns true while recording
+    side-effects: n/a
+    */
+    bool is_recording() const;
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * called once per frame, after drawing and before swapping buffers
+    post-conditions:
+        * hands frames whose reads finished to the encoder
+        * reads the frame into a pack buffer if a screenshot or recording
+          wants it, drops it if every pack buffer is still reading
+    side-effects:
+        * binds a null pixel pack buffer
+    */
+    void capture_frame();
+
+    /*
+    pre-conditions: valid GL context
+    post-conditions:
+        * waits for the frames in flight to be read back, encoded and
+          written
+    side-effects:
+        * binds a null pixel pack buffer
+    */
+    void finish();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns counters since the last reset
+    side-effects: n/a
+    */
+    lcapture_stats stats() const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: zeroes the counters
+    side-effects: n/a
+    */
+    void reset_stats();
+};
+
+/*
+pre-conditions:
+    * pixels hold given dimensions of RGBA8, bottom row first as GL reads
+      them
+post-conditions:
+    * flips the pixels top to bottom, makes them opaque and writes them to
+      given path in given format
+    * returns bytes written, 0 and reports error to console if the file
+      could not be written
+side-effects:
+    * rewrites the pixels
+*/
+std::size_t save_capture(
+    const std::string&    path,
+    lcapture_format       format,
+    std::array<GLuint, 2> dimensions,
+    std::vector<GLubyte>& pixels);
+
+#endif // LCAPTURE_HPP
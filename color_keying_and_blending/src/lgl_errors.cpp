@@ -0,0 +1,102 @@
+#include "lgl_errors.hpp"
+
+#ifndef LGL_NO_ERROR_CHECKS
+
+#include <algorithm> // for std::any_of
+#include <mutex>
+#include <string>
+#include <vector>
+
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
+namespace {
+
+// debug message queued by the callback
+struct lgl_message {
+    bool        error = {false};
+    std::string text;
+};
+
+// the driver may call back from its own threads
+static std::mutex               g_mutex;
+static std::vector<lgl_message> g_messages;
+static bool                     g_callbacks = false;
+
+void GLAPIENTRY
+debug_callback(
+    GLenum /* source */,
+    GLenum type,
+    GLuint /* id */,
+    GLenum severity,
+    GLsizei length,
+    const GLchar* message,
+    const void* /* user data */)
+{
+    // notifications are chatter, not problems
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION) return;
+
+    std::lock_guard lock(g_mutex);
+    g_messages.push_back(
+        {type == GL_DEBUG_TYPE_ERROR,
+         length < 0 ? std::string(message)
+                    : std::string(message, static_cast<std::size_t>(length))});
+}
+
+} // namespace
+
+bool
+gl_errors_init()
+{
+    // core since OpenGL 4.3, otherwise from KHR_debug
+    if (gl_supported(4, 3, "GL_KHR_debug")) {
+        glEnable(GL_DEBUG_OUTPUT);
+        glDebugMessageCallback(debug_callback, nullptr);
+        g_callbacks = true;
+    } /* older extension, always on in debug contexts */ else if (
+        gl_has_extension("GL_ARB_debug_output")) {
+        glDebugMessageCallbackARB(debug_callback, nullptr);
+        g_callbacks = true;
+    }
+
+    std::cout << "GL errors are "
+              << (g_callbacks ? "reported by debug callbacks"
+                              : "polled once per frame")
+              << '\n';
+    return g_callbacks;
+}
+
+std::size_t
+gl_errors_flush(const char* context)
+{
+    std::vector<lgl_message> messages;
+    {
+        std::lock_guard lock(g_mutex);
+        messages.swap(g_messages);
+    }
+
+    // drain the error flags, one per error kind, callbacks do not clear
+    // them; their errors arrived as messages already, so flags are only
+    // reported when no callback reported an error
+    const bool reported = std::any_of(
+        messages.begin(), messages.end(), [](const lgl_message& message) {
+            return message.error;
+        });
+    for (GLenum error = glGetError(); error != GL_NO_ERROR;
+         error        = glGetError()) {
+        if (g_callbacks && reported) continue;
+        messages.push_back(
+            {true, reinterpret_cast<const char*>(gluErrorString(error))});
+    }
+
+    std::size_t errors = 0;
+    for (const auto& message : messages) {
+        std::cerr << (message.error ? "GL error" : "GL warning") << " in "
+                  << context << ": " << message.text << '\n';
+        if (message.error) ++errors;
+    }
+
+    return errors;
+}
+
+#endif // LGL_NO_ERROR_CHECKS
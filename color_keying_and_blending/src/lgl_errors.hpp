@@ -0,0 +1,65 @@
+#ifndef LGL_ERRORS_HPP
+#define LGL_ERRORS_HPP
+
+#include <cstddef>
+
+#include "lopengl.hpp"
+
+/*
+GL errors are collected off the hot paths instead of calling glGetError after
+each operation, which stalls the pipeline and blames whatever call comes first
+for errors left over from earlier ones. With KHR_debug or ARB_debug_output the
+driver hands errors to a callback as they happen; without them glGetError is
+polled once per flush. Either way gl_errors_flush reports them in a batch,
+once per frame and once after loading, and drains the error flags so none
+stay latched for a later glGetError.
+
+Building with LGL_NO_ERROR_CHECKS strips all of it.
+*/
+
+#ifndef LGL_NO_ERROR_CHECKS
+
+/*
+pre-conditions:
+    * a valid OpenGL context, a debug context for callbacks to be called on
+      every driver
+post-conditions:
+    * installs a debug message callback if KHR_debug or ARB_debug_output
+      is available, falls back to polling glGetError otherwise
+    * returns true if callbacks are used
+side-effects:
+    * enables GL_DEBUG_OUTPUT
+*/
+bool gl_errors_init();
+
+/*
+pre-conditions:
+    * gl_errors_init was called
+    * called from the GL thread
+post-conditions:
+    * reports GL errors and warnings raised since the last flush to console,
+      tagged with given context
+    * returns number of errors reported, warnings are not counted
+side-effects:
+    * calls glGetError until it returns GL_NO_ERROR, with callbacks too
+*/
+std::size_t gl_errors_flush(const char* context);
+
+#else
+
+// error checks compiled out
+inline bool
+gl_errors_init()
+{
+    return false;
+}
+
+inline std::size_t
+gl_errors_flush(const char*)
+{
+    return 0;
+}
+
+#endif // LGL_NO_ERROR_CHECKS
+
+#endif // LGL_ERRORS_HPP
@@ -0,0 +1,131 @@
+#include "lgl_stats.hpp"
+
+#include <cstdio> // for std::fopen and std::fprintf
+#include <string>
+
+namespace {
+
+std::size_t
+components(GLenum format)
+{
+    switch (format) {
+    case GL_RED:
+    case GL_ALPHA:
+    case GL_LUMINANCE: return 1;
+    case GL_RG:
+    case GL_LUMINANCE_ALPHA: return 2;
+    case GL_RGB:
+    case GL_BGR: return 3;
+    case GL_RGBA:
+    case GL_BGRA: return 4;
+    }
+    return 0;
+}
+
+std::size_t
+bytes_per_pixel(GLenum format, GLenum type)
+{
+    switch (type) {
+    // packed types hold a whole pixel
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1: return 2;
+    case GL_UNSIGNED_INT_8_8_8_8:
+    case GL_UNSIGNED_INT_8_8_8_8_REV:
+    case GL_UNSIGNED_INT_2_10_10_10_REV: return 4;
+
+    case GL_BYTE:
+    case GL_UNSIGNED_BYTE: return components(format);
+    case GL_SHORT:
+    case GL_UNSIGNED_SHORT:
+    case GL_HALF_FLOAT: return components(format) * 2;
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_FLOAT: return components(format) * 4;
+    }
+    return 0;
+}
+
+} // namespace
+
+std::size_t
+gl_image_bytes(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    if (width <= 0 || height <= 0) return 0;
+
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height) *
+           bytes_per_pixel(format, type);
+}
+
+#ifdef LGL_STATS
+
+namespace {
+
+// column names of the stats log, in category order
+constexpr std::array<const char*, CALL_CATEGORY_COUNT> CATEGORY_NAMES = {
+    "bind",
+    "immediate",
+    "draw",
+    "upload",
+    "download",
+    "query",
+    "object",
+    "state"};
+
+static lgl_frame_stats g_frame;
+static lgl_frame_stats g_last_frame;
+static std::FILE*      g_log = nullptr;
+
+} // namespace
+
+void
+gl_stats_count(lgl_call_category category, std::size_t bytes)
+{
+    ++g_frame.calls[category];
+    g_frame.bytes[category] += bytes;
+}
+
+void
+gl_stats_end_frame()
+{
+    if (g_log) {
+        std::fprintf(g_log, "%zu", g_frame.frame);
+        for (auto calls : g_frame.calls) std::fprintf(g_log, ",%zu", calls);
+        for (auto bytes : g_frame.bytes) std::fprintf(g_log, ",%zu", bytes);
+        std::fputc('\n', g_log);
+
+        // keep the log readable while the program runs
+        std::fflush(g_log);
+    }
+
+    g_last_frame  = g_frame;
+    g_frame       = {};
+    g_frame.frame = g_last_frame.frame + 1;
+}
+
+const lgl_frame_stats&
+gl_stats_last_frame()
+{
+    return g_last_frame;
+}
+
+bool
+gl_stats_open_log(std::string_view path)
+{
+    if (g_log) std::fclose(g_log);
+
+    g_log = std::fopen(std::string(path).c_str(), "w");
+    if (!g_log) {
+        std::cerr << "unable to create GL stats log " << path << '\n';
+        return false;
+    }
+
+    std::fprintf(g_log, "frame");
+    for (auto name : CATEGORY_NAMES) std::fprintf(g_log, ",%s_calls", name);
+    for (auto name : CATEGORY_NAMES) std::fprintf(g_log, ",%s_bytes", name);
+    std::fputc('\n', g_log);
+
+    return true;
+}
+
+#endif // LGL_STATS
@@ -0,0 +1,372 @@
+#ifndef LGL_STATS_HPP
+#define LGL_STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "lopengl.hpp"
+
+enum lgl_call_category { // no classes, categories index the counter arrays
+    CALL_CATEGORY_BIND,      // texture, buffer, framebuffer and program binds
+    CALL_CATEGORY_IMMEDIATE, // glBegin/glEnd and the vertices between them
+    CALL_CATEGORY_DRAW,      // vertex array draws
+    CALL_CATEGORY_UPLOAD,    // pixels and vertices sent to GL
+    CALL_CATEGORY_DOWNLOAD,  // pixels read back from GL
+    CALL_CATEGORY_QUERY,     // glGetError, glGetString, status checks, waits
+    CALL_CATEGORY_OBJECT,    // creating, attaching, building, deleting objects
+    CALL_CATEGORY_STATE,     // matrices, viewport, clearing, blending, ...
+    CALL_CATEGORY_COUNT
+};
+
+// GL calls and pixel bytes of one frame, per category
+struct lgl_frame_stats {
+    std::size_t                                  frame = {0};
+    std::array<std::size_t, CALL_CATEGORY_COUNT> calls = {};
+    std::array<std::size_t, CALL_CATEGORY_COUNT> bytes = {};
+};
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * returns size in bytes of width x height pixels of given GL pixel
+      format and type, 0 for unknown ones
+    * rows are taken as unpadded
+side-effects: n/a
+*/
+std::size_t gl_image_bytes(GLsizei, GLsizei, GLenum format, GLenum type);
+
+#ifdef LGL_STATS
+
+/*
+pre-conditions:
+    * called from the GL thread
+post-conditions:
+    * adds a call and given bytes to the category counters of the frame
+side-effects: n/a
+*/
+void gl_stats_count(lgl_call_category, std::size_t bytes = 0);
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * finishes the counters of the frame, they become gl_stats_last_frame
+    * appends them to the stats log if one is open
+    * starts counting the next frame
+side-effects:
+    * writes the stats log
+*/
+void gl_stats_end_frame();
+
+/*
+pre-conditions: n/a
+post-conditions: returns counters of the last finished frame
+side-effects: n/a
+*/
+const lgl_frame_stats& gl_stats_last_frame();
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * creates a CSV file at given path with a header row, every finished
+      frame appends one row of calls and bytes per category
+    * reports error to console if the file could not be created
+side-effects: n/a
+*/
+bool gl_stats_open_log(std::string_view);
+
+#else
+
+// stats compiled out: GL calls are not wrapped and these do nothing
+inline void
+gl_stats_end_frame()
+{
+}
+
+inline bool
+gl_stats_open_log(std::string_view)
+{
+    std::cerr << "GL stats are disabled, build with LGL_STATS\n";
+    return false;
+}
+
+#endif // LGL_STATS
+
+/*
+With LGL_STATS defined, the GL entry points used to load and render are
+replaced below by macros which count the call before making it. Include this
+header last, after every header that declares GL functions.
+*/
+#ifdef LGL_STATS
+
+inline void
+lgl_tex_image_2d(
+    GLenum      target,
+    GLint       level,
+    GLint       internal_format,
+    GLsizei     width,
+    GLsizei     height,
+    GLint       border,
+    GLenum      format,
+    GLenum      type,
+    const void* pixels)
+{
+    // null pixels only allocate storage
+    gl_stats_count(
+        CALL_CATEGORY_UPLOAD,
+        pixels ? gl_image_bytes(width, height, format, type) : 0);
+    glTexImage2D(
+        target,
+        level,
+        internal_format,
+        width,
+        height,
+        border,
+        format,
+        type,
+        pixels);
+}
+
+inline void
+lgl_tex_sub_image_2d(
+    GLenum      target,
+    GLint       level,
+    GLint       x,
+    GLint       y,
+    GLsizei     width,
+    GLsizei     height,
+    GLenum      format,
+    GLenum      type,
+    const void* pixels)
+{
+    gl_stats_count(
+        CALL_CATEGORY_UPLOAD, gl_image_bytes(width, height, format, type));
+    glTexSubImage2D(target, level, x, y, width, height, format, type, pixels);
+}
+
+inline void
+lgl_get_tex_image(
+    GLenum target, GLint level, GLenum format, GLenum type, void* pixels)
+{
+    // the level size query is not counted, it is part of the bookkeeping
+    GLint width  = 0;
+    GLint height = 0;
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &height);
+
+    gl_stats_count(
+        CALL_CATEGORY_DOWNLOAD, gl_image_bytes(width, height, format, type));
+    glGetTexImage(target, level, format, type, pixels);
+}
+
+inline void
+lgl_read_pixels(
+    GLint   x,
+    GLint   y,
+    GLsizei width,
+    GLsizei height,
+    GLenum  format,
+    GLenum  type,
+    void*   pixels)
+{
+    // counted alike whether pixels land in client memory or a pack buffer
+    gl_stats_count(
+        CALL_CATEGORY_DOWNLOAD, gl_image_bytes(width, height, format, type));
+    glReadPixels(x, y, width, height, format, type, pixels);
+}
+
+inline void
+lgl_buffer_data(
+    GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    // null data only allocates storage
+    gl_stats_count(
+        CALL_CATEGORY_UPLOAD, data ? static_cast<std::size_t>(size) : 0);
+    glBufferData(target, size, data, usage);
+}
+
+inline void
+lgl_buffer_sub_data(
+    GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    gl_stats_count(CALL_CATEGORY_UPLOAD, static_cast<std::size_t>(size));
+    glBufferSubData(target, offset, size, data);
+}
+
+// the call is the right operand, so calls returning values keep them
+#define LGL_COUNT(category, call) \
+    (gl_stats_count(CALL_CATEGORY_##category), call)
+
+#define glBindTexture(...) \
+    LGL_COUNT(BIND, glBindTexture(__VA_ARGS__))
+#define glBindFramebuffer(...) \
+    LGL_COUNT(BIND, glBindFramebuffer(__VA_ARGS__))
+#define glBindBuffer(...) \
+    LGL_COUNT(BIND, glBindBuffer(__VA_ARGS__))
+#define glBindBufferBase(...) \
+    LGL_COUNT(BIND, glBindBufferBase(__VA_ARGS__))
+#define glUseProgram(...) \
+    LGL_COUNT(BIND, glUseProgram(__VA_ARGS__))
+
+#define glBegin(...) \
+    LGL_COUNT(IMMEDIATE, glBegin(__VA_ARGS__))
+#define glEnd(...) \
+    LGL_COUNT(IMMEDIATE, glEnd(__VA_ARGS__))
+#define glTexCoord2f(...) \
+    LGL_COUNT(IMMEDIATE, glTexCoord2f(__VA_ARGS__))
+#define glVertex2f(...) \
+    LGL_COUNT(IMMEDIATE, glVertex2f(__VA_ARGS__))
+
+#define glDrawArrays(...) \
+    LGL_COUNT(DRAW, glDrawArrays(__VA_ARGS__))
+#define glDrawArraysInstanced(...) \
+    LGL_COUNT(DRAW, glDrawArraysInstanced(__VA_ARGS__))
+#define glDrawElements(...) \
+    LGL_COUNT(DRAW, glDrawElements(__VA_ARGS__))
+
+#define glBufferData(...) lgl_buffer_data(__VA_ARGS__)
+#define glBufferSubData(...) lgl_buffer_sub_data(__VA_ARGS__)
+#define glTexImage2D(...) lgl_tex_image_2d(__VA_ARGS__)
+#define glTexSubImage2D(...) lgl_tex_sub_image_2d(__VA_ARGS__)
+#define glGetTexImage(...) lgl_get_tex_image(__VA_ARGS__)
+#define glReadPixels(...) lgl_read_pixels(__VA_ARGS__)
+
+#define glMapBuffer(...) \
+    LGL_COUNT(DOWNLOAD, glMapBuffer(__VA_ARGS__))
+#define glUnmapBuffer(...) \
+    LGL_COUNT(DOWNLOAD, glUnmapBuffer(__VA_ARGS__))
+
+#define glGetError(...) \
+    LGL_COUNT(QUERY, glGetError(__VA_ARGS__))
+#define glGetIntegerv(...) \
+    LGL_COUNT(QUERY, glGetIntegerv(__VA_ARGS__))
+#define glGetString(...) \
+    LGL_COUNT(QUERY, glGetString(__VA_ARGS__))
+#define glCheckFramebufferStatus(...) \
+    LGL_COUNT(QUERY, glCheckFramebufferStatus(__VA_ARGS__))
+#define glClientWaitSync(...) \
+    LGL_COUNT(QUERY, glClientWaitSync(__VA_ARGS__))
+#define glFinish(...) \
+    LGL_COUNT(QUERY, glFinish(__VA_ARGS__))
+#define glGetProgramInfoLog(...) \
+    LGL_COUNT(QUERY, glGetProgramInfoLog(__VA_ARGS__))
+#define glGetProgramiv(...) \
+    LGL_COUNT(QUERY, glGetProgramiv(__VA_ARGS__))
+#define glGetShaderInfoLog(...) \
+    LGL_COUNT(QUERY, glGetShaderInfoLog(__VA_ARGS__))
+#define glGetShaderiv(...) \
+    LGL_COUNT(QUERY, glGetShaderiv(__VA_ARGS__))
+#define glGetTexLevelParameteriv(...) \
+    LGL_COUNT(QUERY, glGetTexLevelParameteriv(__VA_ARGS__))
+#define glGetUniformBlockIndex(...) \
+    LGL_COUNT(QUERY, glGetUniformBlockIndex(__VA_ARGS__))
+#define glGetUniformLocation(...) \
+    LGL_COUNT(QUERY, glGetUniformLocation(__VA_ARGS__))
+
+#define glGenTextures(...) \
+    LGL_COUNT(OBJECT, glGenTextures(__VA_ARGS__))
+#define glDeleteTextures(...) \
+    LGL_COUNT(OBJECT, glDeleteTextures(__VA_ARGS__))
+#define glGenFramebuffers(...) \
+    LGL_COUNT(OBJECT, glGenFramebuffers(__VA_ARGS__))
+#define glDeleteFramebuffers(...) \
+    LGL_COUNT(OBJECT, glDeleteFramebuffers(__VA_ARGS__))
+#define glFramebufferTexture2D(...) \
+    LGL_COUNT(OBJECT, glFramebufferTexture2D(__VA_ARGS__))
+#define glFenceSync(...) \
+    LGL_COUNT(OBJECT, glFenceSync(__VA_ARGS__))
+#define glDeleteSync(...) \
+    LGL_COUNT(OBJECT, glDeleteSync(__VA_ARGS__))
+#define glGenBuffers(...) \
+    LGL_COUNT(OBJECT, glGenBuffers(__VA_ARGS__))
+#define glDeleteBuffers(...) \
+    LGL_COUNT(OBJECT, glDeleteBuffers(__VA_ARGS__))
+#define glCreateShader(...) \
+    LGL_COUNT(OBJECT, glCreateShader(__VA_ARGS__))
+#define glShaderSource(...) \
+    LGL_COUNT(OBJECT, glShaderSource(__VA_ARGS__))
+#define glCompileShader(...) \
+    LGL_COUNT(OBJECT, glCompileShader(__VA_ARGS__))
+#define glDeleteShader(...) \
+    LGL_COUNT(OBJECT, glDeleteShader(__VA_ARGS__))
+#define glCreateProgram(...) \
+    LGL_COUNT(OBJECT, glCreateProgram(__VA_ARGS__))
+#define glAttachShader(...) \
+    LGL_COUNT(OBJECT, glAttachShader(__VA_ARGS__))
+#define glBindAttribLocation(...) \
+    LGL_COUNT(OBJECT, glBindAttribLocation(__VA_ARGS__))
+#define glLinkProgram(...) \
+    LGL_COUNT(OBJECT, glLinkProgram(__VA_ARGS__))
+#define glUniformBlockBinding(...) \
+    LGL_COUNT(OBJECT, glUniformBlockBinding(__VA_ARGS__))
+#define glDeleteProgram(...) \
+    LGL_COUNT(OBJECT, glDeleteProgram(__VA_ARGS__))
+
+#define glBlendFunc(...) \
+    LGL_COUNT(STATE, glBlendFunc(__VA_ARGS__))
+#define glClear(...) \
+    LGL_COUNT(STATE, glClear(__VA_ARGS__))
+#define glClearColor(...) \
+    LGL_COUNT(STATE, glClearColor(__VA_ARGS__))
+#define glColor4f(...) \
+    LGL_COUNT(STATE, glColor4f(__VA_ARGS__))
+#define glColor4fv(...) \
+    LGL_COUNT(STATE, glColor4fv(__VA_ARGS__))
+#define glDisable(...) \
+    LGL_COUNT(STATE, glDisable(__VA_ARGS__))
+#define glDisableClientState(...) \
+    LGL_COUNT(STATE, glDisableClientState(__VA_ARGS__))
+#define glDisableVertexAttribArray(...) \
+    LGL_COUNT(STATE, glDisableVertexAttribArray(__VA_ARGS__))
+#define glEnable(...) \
+    LGL_COUNT(STATE, glEnable(__VA_ARGS__))
+#define glEnableClientState(...) \
+    LGL_COUNT(STATE, glEnableClientState(__VA_ARGS__))
+#define glEnableVertexAttribArray(...) \
+    LGL_COUNT(STATE, glEnableVertexAttribArray(__VA_ARGS__))
+#define glLoadIdentity(...) \
+    LGL_COUNT(STATE, glLoadIdentity(__VA_ARGS__))
+#define glLoadMatrixf(...) \
+    LGL_COUNT(STATE, glLoadMatrixf(__VA_ARGS__))
+#define glMatrixMode(...) \
+    LGL_COUNT(STATE, glMatrixMode(__VA_ARGS__))
+#define glOrtho(...) \
+    LGL_COUNT(STATE, glOrtho(__VA_ARGS__))
+#define glPixelStorei(...) \
+    LGL_COUNT(STATE, glPixelStorei(__VA_ARGS__))
+#define glPopAttrib(...) \
+    LGL_COUNT(STATE, glPopAttrib(__VA_ARGS__))
+#define glPopMatrix(...) \
+    LGL_COUNT(STATE, glPopMatrix(__VA_ARGS__))
+#define glPushAttrib(...) \
+    LGL_COUNT(STATE, glPushAttrib(__VA_ARGS__))
+#define glPushMatrix(...) \
+    LGL_COUNT(STATE, glPushMatrix(__VA_ARGS__))
+#define glTexParameteri(...) \
+    LGL_COUNT(STATE, glTexParameteri(__VA_ARGS__))
+#define glTranslatef(...) \
+    LGL_COUNT(STATE, glTranslatef(__VA_ARGS__))
+#define glUniform1i(...) \
+    LGL_COUNT(STATE, glUniform1i(__VA_ARGS__))
+#define glUniform2f(...) \
+    LGL_COUNT(STATE, glUniform2f(__VA_ARGS__))
+#define glUniform4f(...) \
+    LGL_COUNT(STATE, glUniform4f(__VA_ARGS__))
+#define glUniform4fv(...) \
+    LGL_COUNT(STATE, glUniform4fv(__VA_ARGS__))
+#define glVertexAttribDivisor(...) \
+    LGL_COUNT(STATE, glVertexAttribDivisor(__VA_ARGS__))
+#define glVertexAttribPointer(...) \
+    LGL_COUNT(STATE, glVertexAttribPointer(__VA_ARGS__))
+#define glVertexPointer(...) \
+    LGL_COUNT(STATE, glVertexPointer(__VA_ARGS__))
+#define glTexCoordPointer(...) \
+    LGL_COUNT(STATE, glTexCoordPointer(__VA_ARGS__))
+#define glColorPointer(...) \
+    LGL_COUNT(STATE, glColorPointer(__VA_ARGS__))
+#define glViewport(...) \
+    LGL_COUNT(STATE, glViewport(__VA_ARGS__))
+
+#endif // LGL_STATS
+
+#endif // LGL_STATS_HPP
@@ -0,0 +1,274 @@
+#include "limage_decoder.hpp"
+
+#include <csetjmp> // for std::setjmp and std::longjmp
+#include <cstdio>  // for std::fopen and std::fread
+#include <cstring> // for std::memcpy and std::memset
+#include <mutex>
+#include <vector>
+
+#include <IL/il.h>
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
+
+#ifdef HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+
+#include <gsl/gsl_util> // for gsl::finally and gsl::narrow
+
+#include "macro_helpers.hpp"
+
+namespace {
+
+// allocates pixels the decoder overwrites
+void
+allocate(limage& image, std::array<GLuint, 2> dims)
+{
+    image.dimensions = dims;
+    image.pixels     = make_pixel_buffer(std::size_t{Wv(dims)} * Hv(dims));
+}
+
+#ifdef HAVE_LIBPNG
+
+/*
+libpng through its simplified API, which converts any PNG to RGBA8 while
+decoding and keeps all state in the png_image.
+*/
+class lpng_decoder : public limage_decoder {
+public:
+    const char* name() const override { return "libpng"; }
+
+    bool accepts(const unsigned char* header, std::size_t size) const override
+    {
+        return size >= 8 && png_sig_cmp(header, 0, 8) == 0;
+    }
+
+    bool decode(std::string_view path, limage& image) const override
+    {
+        png_image png;
+        std::memset(&png, 0, sizeof(png));
+        png.version = PNG_IMAGE_VERSION;
+
+        if (!png_image_begin_read_from_file(&png, path.data())) {
+            std::cerr << "libpng: " << png.message << '\n';
+            return false;
+        }
+
+        png.format = PNG_FORMAT_RGBA;
+        allocate(image, {png.width, png.height});
+
+        // frees the png_image either way
+        if (!png_image_finish_read(
+                &png, nullptr, image.pixels.get(), 0, nullptr)) {
+            std::cerr << "libpng: " << png.message << '\n';
+            image.pixels.reset();
+            return false;
+        }
+
+        return true;
+    }
+};
+
+#endif // HAVE_LIBPNG
+
+#ifdef HAVE_LIBJPEG
+
+// libjpeg reports errors by calling error_exit, which must not return
+struct ljpeg_error {
+    jpeg_error_mgr manager;
+    std::jmp_buf   jump;
+};
+
+void
+jpeg_error_exit(j_common_ptr info)
+{
+    char message[JMSG_LENGTH_MAX];
+    (*info->err->format_message)(info, message);
+    std::cerr << "libjpeg: " << message << '\n';
+
+    // manager is the first member
+    std::longjmp(reinterpret_cast<ljpeg_error*>(info->err)->jump, 1);
+}
+
+/*
+libjpeg(-turbo), decoding scanlines straight into the image. libjpeg-turbo
+writes RGBA itself, plain libjpeg gets RGB expanded row by row.
+*/
+class ljpeg_decoder : public limage_decoder {
+public:
+    const char* name() const override { return "libjpeg"; }
+
+    bool accepts(const unsigned char* header, std::size_t size) const override
+    {
+        return size >= 3 && header[0] == 0xff && header[1] == 0xd8 &&
+               header[2] == 0xff;
+    }
+
+    bool decode(std::string_view path, limage& image) const override
+    {
+        std::FILE* file = std::fopen(path.data(), "rb");
+        if (!file) {
+            std::cerr << "libjpeg: cannot open " << path << '\n';
+            return false;
+        }
+
+        // no locals with destructors from here on, longjmp skips them
+        jpeg_decompress_struct info;
+        ljpeg_error            error;
+        info.err                 = jpeg_std_error(&error.manager);
+        error.manager.error_exit = jpeg_error_exit;
+
+        if (setjmp(error.jump)) {
+            jpeg_destroy_decompress(&info);
+            std::fclose(file);
+            image.pixels.reset();
+            return false;
+        }
+
+        jpeg_create_decompress(&info);
+        jpeg_stdio_src(&info, file);
+        jpeg_read_header(&info, TRUE);
+#ifdef JCS_EXTENSIONS
+        info.out_color_space = JCS_EXT_RGBA;
+#else
+        info.out_color_space = JCS_RGB;
+#endif
+        jpeg_start_decompress(&info);
+
+        allocate(image, {info.output_width, info.output_height});
+        read_scanlines(info, image);
+
+        jpeg_finish_decompress(&info);
+        jpeg_destroy_decompress(&info);
+        std::fclose(file);
+
+        return true;
+    }
+
+private:
+    static void read_scanlines(jpeg_decompress_struct& info, limage& image)
+    {
+        const auto width = std::size_t{Wv(image.dimensions)};
+
+        while (info.output_scanline < info.output_height) {
+            GLuint* row = image.pixels.get() + info.output_scanline * width;
+            auto*   out = reinterpret_cast<JSAMPLE*>(row);
+            jpeg_read_scanlines(&info, &out, 1);
+
+#ifndef JCS_EXTENSIONS
+            // expand RGB in place, back to front
+            for (std::size_t x = width; x-- > 0;) {
+                GLubyte pixel[4] = {
+                    out[x * 3], out[x * 3 + 1], out[x * 3 + 2], 0xff};
+                std::memcpy(row + x, pixel, sizeof(pixel));
+            }
+#endif
+        }
+    }
+};
+
+#endif // HAVE_LIBJPEG
+
+/*
+DevIL reads anything else. It keeps the bound image in global state, so
+decodes are serialized.
+*/
+class ldevil_decoder : public limage_decoder {
+    mutable std::mutex _mutex;
+
+public:
+    const char* name() const override { return "DevIL"; }
+
+    bool accepts(const unsigned char*, std::size_t) const override
+    {
+        return true;
+    }
+
+    bool decode(std::string_view path, limage& image) const override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // generate and set current image id
+        ILuint img_id = 0;
+        ilGenImages(1, &img_id);
+        ilBindImage(img_id);
+        auto _ = gsl::finally([&img_id]() { ilDeleteImages(1, &img_id); });
+
+        // load image and convert it to RGBA
+        if (ilLoadImage(path.data()) != IL_TRUE ||
+            ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE) != IL_TRUE) {
+            return false;
+        }
+
+        allocate(
+            image,
+            {gsl::narrow<GLuint>(ilGetInteger(IL_IMAGE_WIDTH)),
+             gsl::narrow<GLuint>(ilGetInteger(IL_IMAGE_HEIGHT))});
+
+        // copy pixels
+        std::memcpy(
+            image.pixels.get(),
+            ilGetData(),
+            std::size_t{Wv(image.dimensions)} * Hv(image.dimensions) *
+                sizeof(GLuint));
+
+        return true;
+    }
+};
+
+std::vector<std::unique_ptr<limage_decoder>>&
+decoders()
+{
+    static auto backends = []() {
+        std::vector<std::unique_ptr<limage_decoder>> b;
+#ifdef HAVE_LIBPNG
+        b.push_back(std::make_unique<lpng_decoder>());
+#endif
+#ifdef HAVE_LIBJPEG
+        b.push_back(std::make_unique<ljpeg_decoder>());
+#endif
+        b.push_back(std::make_unique<ldevil_decoder>());
+        return b;
+    }();
+    return backends;
+}
+
+} // namespace
+
+void
+add_image_decoder(std::unique_ptr<limage_decoder> decoder)
+{
+    auto& backends = decoders();
+    backends.insert(backends.begin(), std::move(decoder));
+}
+
+std::vector<const limage_decoder*>
+image_decoders()
+{
+    std::vector<const limage_decoder*> backends;
+    for (const auto& decoder : decoders()) backends.push_back(decoder.get());
+    return backends;
+}
+
+bool
+decode_image(std::string_view path, limage& image)
+{
+    // read file header to pick a backend
+    unsigned char header[16] = {0};
+    std::size_t   size       = 0;
+    if (std::FILE* file = std::fopen(path.data(), "rb")) {
+        size = std::fread(header, 1, sizeof(header), file);
+        std::fclose(file);
+    }
+
+    // a backend failing on a file it accepts leaves it to the next one
+    for (const auto& decoder : decoders()) {
+        if (decoder->accepts(header, size) && decoder->decode(path, image)) {
+            return true;
+        }
+    }
+
+    return false;
+}
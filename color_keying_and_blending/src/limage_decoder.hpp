@@ -0,0 +1,91 @@
+#ifndef LIMAGE_DECODER_HPP
+#define LIMAGE_DECODER_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "lopengl.hpp"
+#include "lpixel_allocator.hpp"
+
+/*
+Decoded image, pixels are RGBA8 packed into GLuint with red in the lowest byte
+and rows stored top to bottom without padding. Pixels come from the current
+pixel allocator.
+*/
+struct limage {
+    lpixel_buffer         pixels;
+    std::array<GLuint, 2> dimensions = {0, 0};
+};
+
+/*
+Image decoder backend. Backends are tried in the order they were added, the
+first one accepting the file header decodes it. Backends must be reentrant
+or serialize themselves: textures may be loaded from several threads.
+*/
+class limage_decoder {
+public:
+    virtual ~limage_decoder() = default;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns backend name for diagnostics
+    side-effects: n/a
+    */
+    virtual const char* name() const = 0;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns true if the backend decodes files starting with the given
+          bytes
+    side-effects: n/a
+    */
+    virtual bool
+    accepts(const unsigned char* header, std::size_t size) const = 0;
+
+    /*
+    pre-conditions:
+        * null-terminated path
+    post-conditions:
+        * decodes the file into the image
+        * reports error to console if file could not be decoded
+    side-effects: n/a
+    */
+    virtual bool decode(std::string_view path, limage&) const = 0;
+};
+
+/*
+pre-conditions:
+    * not called while images are being decoded
+post-conditions:
+    * adds a backend, tried before the built-in ones
+side-effects: n/a
+*/
+void add_image_decoder(std::unique_ptr<limage_decoder>);
+
+/*
+pre-conditions:
+    * not called while backends are being added
+post-conditions:
+    * returns the backends in the order decode_image tries them, to run
+      them one at a time
+side-effects: n/a
+*/
+std::vector<const limage_decoder*> image_decoders();
+
+/*
+pre-conditions:
+    * null-terminated path
+    * initialized DevIL, for files no other backend accepts
+post-conditions:
+    * decodes the file with the first backend accepting and decoding it,
+      DevIL last
+    * reports errors to console
+side-effects: n/a
+*/
+bool decode_image(std::string_view path, limage&);
+
+#endif // LIMAGE_DECODER_HPP
@@ -0,0 +1,29 @@
+#include "lopengl.hpp"
+
+#include <cstdio>  // for std::sscanf
+#include <cstring> // for std::strstr
+
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
+bool
+gl_has_extension(const char* extension)
+{
+    auto extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    return extensions && std::strstr(extensions, extension) != nullptr;
+}
+
+bool
+gl_supported(int major_version, int minor_version, const char* extension)
+{
+    auto version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    int  major   = 0;
+    int  minor   = 0;
+    if (version && std::sscanf(version, "%d.%d", &major, &minor) == 2 &&
+        (major > major_version ||
+         (major == major_version && minor >= minor_version))) {
+        return true;
+    }
+
+    return gl_has_extension(extension);
+}
@@ -1,6 +1,9 @@
 #ifndef LOPENGL_HPP
 #define LOPENGL_HPP
 
+// declare framebuffer object entry points from GL/glext.h
+#define GL_GLEXT_PROTOTYPES
+
 // clang-format off
 #include <GL/freeglut.h>
 #include <GL/gl.h>
@@ -8,4 +11,22 @@
 #include <iostream> // for std::cerr
 // clang-format on
 
+/*
+pre-conditions:
+    * valid GL context
+post-conditions: returns true if the context has the given extension
+side-effects: n/a
+*/
+bool gl_has_extension(const char*);
+
+/*
+pre-conditions:
+    * valid GL context
+post-conditions:
+    * returns true if the context is at least the given GL version or has
+      the given extension
+side-effects: n/a
+*/
+bool gl_supported(int major, int minor, const char* extension);
+
 #endif // LOPENGL_HPP
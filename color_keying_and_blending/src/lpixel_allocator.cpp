@@ -0,0 +1,204 @@
+#include "lpixel_allocator.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// smallest class is 4 KiB, a page
+constexpr std::size_t MIN_CLASS_SHIFT = 12;
+
+std::size_t
+size_class(std::size_t bytes)
+{
+    std::size_t shift = MIN_CLASS_SHIFT;
+    while ((std::size_t{1} << shift) < bytes) { ++shift; }
+    return shift - MIN_CLASS_SHIFT;
+}
+
+std::size_t
+class_bytes(std::size_t size_class)
+{
+    return std::size_t{1} << (size_class + MIN_CLASS_SHIFT);
+}
+
+// arena allocations start on cache line boundaries
+constexpr std::size_t ARENA_ALIGNMENT = 64 / sizeof(GLuint);
+
+static lpixel_allocator* g_allocator = {nullptr};
+
+} // namespace
+
+void
+lpixel_allocator::record_allocation(std::size_t bytes, bool from_system)
+{
+    std::lock_guard<std::mutex> lock(_stats_mutex);
+
+    ++_stats.allocations;
+    if (from_system) ++_stats.system_allocations;
+    _stats.bytes_in_use += bytes;
+    _stats.peak_bytes_in_use =
+        std::max(_stats.peak_bytes_in_use, _stats.bytes_in_use);
+}
+
+void
+lpixel_allocator::record_deallocation(std::size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_stats_mutex);
+
+    _stats.bytes_in_use -= bytes;
+}
+
+lallocator_stats
+lpixel_allocator::stats() const
+{
+    std::lock_guard<std::mutex> lock(_stats_mutex);
+
+    return _stats;
+}
+
+lpool_allocator::lpool_allocator(std::size_t max_cached)
+    : _max_cached(max_cached)
+{
+}
+
+lpool_allocator::~lpool_allocator()
+{
+    trim();
+}
+
+GLuint*
+lpool_allocator::allocate(std::size_t count)
+{
+    const auto c = size_class(count * sizeof(GLuint));
+
+    GLuint* pixels = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free[c].empty()) {
+            pixels = _free[c].back();
+            _free[c].pop_back();
+            _cached -= class_bytes(c);
+        }
+    }
+
+    const bool from_system = !pixels;
+    if (from_system) pixels = new GLuint[class_bytes(c) / sizeof(GLuint)];
+
+    record_allocation(count * sizeof(GLuint), from_system);
+    return pixels;
+}
+
+void
+lpool_allocator::deallocate(GLuint* pixels, std::size_t count)
+{
+    if (!pixels) return;
+
+    record_deallocation(count * sizeof(GLuint));
+
+    const auto c = size_class(count * sizeof(GLuint));
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cached + class_bytes(c) <= _max_cached) {
+            _free[c].push_back(pixels);
+            _cached += class_bytes(c);
+            return;
+        }
+    }
+
+    // cache is full
+    delete[] pixels;
+}
+
+void
+lpool_allocator::trim()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& buffers : _free) {
+        for (auto* pixels : buffers) { delete[] pixels; }
+        buffers.clear();
+    }
+    _cached = 0;
+}
+
+larena_allocator::larena_allocator(std::size_t block_pixels)
+    : _block_pixels(block_pixels)
+{
+}
+
+GLuint*
+larena_allocator::allocate(std::size_t count)
+{
+    const auto aligned =
+        (count + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // block is full, start a new one; the first block is allocated even for
+    // an empty request, so every allocation returns a pointer into a block
+    const bool from_system = aligned > _capacity - _used || _blocks.empty();
+    if (from_system) {
+        _capacity = std::max(aligned, _block_pixels);
+        _used     = 0;
+        _reserved += _capacity;
+        _blocks.emplace_back(new GLuint[_capacity]);
+    }
+
+    GLuint* pixels = _blocks.back().get() + _used;
+    _used += aligned;
+    _allocated += aligned;
+    record_allocation(count * sizeof(GLuint), from_system);
+    return pixels;
+}
+
+void
+larena_allocator::deallocate(GLuint* pixels, std::size_t count)
+{
+    // block memory comes back on reset
+    if (pixels) record_deallocation(count * sizeof(GLuint));
+}
+
+void
+larena_allocator::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // one block for everything the arena handed out
+    if (_blocks.size() > 1) {
+        _blocks.clear();
+        _blocks.emplace_back(new GLuint[_allocated]);
+        _capacity = _allocated;
+        _reserved = _allocated;
+    }
+    _used      = 0;
+    _allocated = 0;
+}
+
+std::size_t
+larena_allocator::capacity() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    return _reserved;
+}
+
+lpixel_allocator&
+pixel_allocator()
+{
+    // never destroyed, buffers of static textures may outlive it otherwise
+    static auto* pool = new lpool_allocator();
+    return g_allocator ? *g_allocator : *pool;
+}
+
+void
+set_pixel_allocator(lpixel_allocator* allocator)
+{
+    g_allocator = allocator;
+}
+
+lpixel_buffer
+make_pixel_buffer(std::size_t count)
+{
+    auto& allocator = pixel_allocator();
+    return {allocator.allocate(count), lpixel_deleter{&allocator, count}};
+}
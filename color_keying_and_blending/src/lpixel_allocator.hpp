@@ -0,0 +1,185 @@
+#ifndef LPIXEL_ALLOCATOR_HPP
+#define LPIXEL_ALLOCATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "lopengl.hpp"
+
+// allocation counters of a pixel allocator
+struct lallocator_stats {
+    std::size_t allocations        = {0};
+    std::size_t system_allocations = {0}; // requests the allocator could not
+                                          // serve from memory it already had
+    std::size_t bytes_in_use       = {0};
+    std::size_t peak_bytes_in_use  = {0};
+};
+
+/*
+Allocates pixel buffers. Buffers live only between loading (or locking) a
+texture and uploading it, so allocators recycle their memory instead of
+going back to the heap for every multi-megabyte image.
+*/
+class lpixel_allocator {
+    mutable std::mutex _stats_mutex;
+    lallocator_stats   _stats;
+
+protected:
+    // bookkeeping for derived allocators
+    void record_allocation(std::size_t bytes, bool from_system);
+    void record_deallocation(std::size_t bytes);
+
+public:
+    virtual ~lpixel_allocator() = default;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns uninitialized room for count pixels
+    side-effects: n/a
+    */
+    virtual GLuint* allocate(std::size_t count) = 0;
+
+    /*
+    pre-conditions:
+        * pixels were allocated by this allocator with the same count
+    post-conditions:
+        * gives the pixels back to the allocator
+    side-effects: n/a
+    */
+    virtual void deallocate(GLuint*, std::size_t count) = 0;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns allocation counters
+    side-effects: n/a
+    */
+    lallocator_stats stats() const;
+};
+
+/*
+Pool of pixel buffers in power of two size classes. Freed buffers are cached
+per class, up to a byte limit, and handed out again to requests of the same
+class.
+*/
+class lpool_allocator : public lpixel_allocator {
+    static constexpr std::size_t CLASSES = 48;
+
+    std::mutex                                _mutex;
+    std::array<std::vector<GLuint*>, CLASSES> _free;
+    std::size_t                               _cached     = {0};
+    std::size_t                               _max_cached = {0};
+
+public:
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * creates a pool caching at most given number of bytes of free
+          buffers
+    side-effects: n/a
+    */
+    explicit lpool_allocator(std::size_t max_cached = 64 << 20);
+    ~lpool_allocator() override;
+
+    GLuint* allocate(std::size_t count) override;
+    void    deallocate(GLuint*, std::size_t count) override;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: frees all cached buffers
+    side-effects: n/a
+    */
+    void trim();
+};
+
+/*
+Linear arena: allocating bumps an offset into the current block, deallocating
+does nothing and reset() frees everything at once, e.g. at the end of a frame
+or a level load. Blocks are allocated on demand to fit the request. A reset
+after several blocks merges them into one holding everything allocated
+since the last reset, so repeating the same loads takes one block.
+*/
+class larena_allocator : public lpixel_allocator {
+    mutable std::mutex                     _mutex;
+    std::vector<std::unique_ptr<GLuint[]>> _blocks; // the current one last
+    std::size_t                            _block_pixels = {0};
+    std::size_t                            _capacity     = {0}; // current
+    std::size_t                            _used         = {0}; // current
+    std::size_t                            _reserved     = {0}; // all blocks
+    std::size_t                            _allocated    = {0}; // since reset
+
+public:
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * creates an empty arena, its first block holds at least given
+          number of pixels
+    side-effects: n/a
+    */
+    explicit larena_allocator(std::size_t block_pixels = 0);
+
+    GLuint* allocate(std::size_t count) override;
+    void    deallocate(GLuint*, std::size_t count) override;
+
+    /*
+    pre-conditions:
+        * no buffers allocated from the arena are in use
+    post-conditions:
+        * makes the arena memory available again, in one block
+    side-effects: n/a
+    */
+    void reset();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of pixels held by the blocks
+    side-effects: n/a
+    */
+    std::size_t capacity() const;
+};
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * returns allocator used for new pixel buffers, a process wide
+      lpool_allocator unless set_pixel_allocator was called
+side-effects: n/a
+*/
+lpixel_allocator& pixel_allocator();
+
+/*
+pre-conditions:
+    * allocator outlives the buffers allocated from it
+    * not called while pixel buffers are being allocated
+post-conditions:
+    * sets allocator for new pixel buffers, null restores the default pool
+side-effects: n/a
+*/
+void set_pixel_allocator(lpixel_allocator*);
+
+// returns pixels to the allocator they came from
+struct lpixel_deleter {
+    lpixel_allocator* allocator = {nullptr};
+    std::size_t       count     = {0};
+
+    void operator()(GLuint* pixels) const
+    {
+        allocator->deallocate(pixels, count);
+    }
+};
+
+using lpixel_buffer = std::unique_ptr<GLuint[], lpixel_deleter>;
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * returns uninitialized buffer for count pixels from the current pixel
+      allocator
+side-effects: n/a
+*/
+lpixel_buffer make_pixel_buffer(std::size_t count);
+
+#endif // LPIXEL_ALLOCATOR_HPP
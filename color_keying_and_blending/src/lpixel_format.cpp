@@ -0,0 +1,226 @@
+#include "lpixel_format.hpp"
+
+#include <algorithm> // for std::min
+#include <array>
+#include <cstdint>
+#include <cstring> // for std::memcpy
+
+namespace {
+
+const std::array<lpixel_format_info, 5> g_format_info = {{
+    {GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, 4, "RGBA8"},
+    {GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1, "R8"},
+    {GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2, "RG8"},
+    // sized GL_RGB565 is OpenGL 4.1, ltexture asks for it where it exists
+    {GL_RGB5, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 2, "RGB565"},
+    {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8, "RGBA16F"},
+}};
+
+// converted in slices, so intermediate RGBA8 pixels stay in cache
+constexpr std::size_t SLICE_PIXELS = 1024;
+
+std::uint16_t
+float_to_half(float value)
+{
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const auto sign     = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+    const auto exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+    const auto mantissa = bits & 0x7fffffu;
+
+    // zero and values too small for a half
+    if (exponent <= 0) return sign;
+
+    // values too large for a half
+    if (exponent >= 31) return static_cast<std::uint16_t>(sign | 0x7c00u);
+
+    return static_cast<std::uint16_t>(
+        sign | static_cast<std::uint32_t>(exponent) << 10 | mantissa >> 13);
+}
+
+float
+half_to_float(std::uint16_t half)
+{
+    const std::uint32_t sign     = (half & 0x8000u) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1fu;
+    const std::uint32_t mantissa = half & 0x3ffu;
+
+    // zero, denormals are flushed
+    std::uint32_t bits = sign;
+    if (exponent == 31) {
+        bits |= 0x7f800000u | mantissa << 13;
+    } else if (exponent != 0) {
+        bits |= (exponent - 15 + 127) << 23 | mantissa << 13;
+    }
+
+    float value = 0.f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// halves of n / 255 for every byte value n
+const std::array<std::uint16_t, 256>&
+byte_to_half()
+{
+    static const auto table = []() {
+        std::array<std::uint16_t, 256> t = {};
+        for (std::size_t i = 0; i < t.size(); ++i) {
+            t[i] = float_to_half(static_cast<float>(i) / 255.f);
+        }
+        return t;
+    }();
+    return table;
+}
+
+/* The kernels below are plain loops over bytes without branches, which the
+compiler vectorizes on its own. */
+
+void
+from_rgba8(
+    const GLubyte* source, lpixel_format format, void* out, std::size_t count)
+{
+    switch (format) {
+    case PIXEL_FORMAT_RGBA8:
+        std::memcpy(out, source, count * 4);
+        break;
+    case PIXEL_FORMAT_R8: {
+        auto* dest = static_cast<GLubyte*>(out);
+        for (std::size_t i = 0; i < count; ++i) { dest[i] = source[i * 4]; }
+    } break;
+    case PIXEL_FORMAT_RG8: {
+        // keeps alpha in the second channel for masks and glyphs, ltexture
+        // swizzles it back into alpha when sampling
+        auto* dest = static_cast<GLubyte*>(out);
+        for (std::size_t i = 0; i < count; ++i) {
+            dest[i * 2]     = source[i * 4];
+            dest[i * 2 + 1] = source[i * 4 + 3];
+        }
+    } break;
+    case PIXEL_FORMAT_RGB565: {
+        auto* dest = static_cast<std::uint16_t*>(out);
+        for (std::size_t i = 0; i < count; ++i) {
+            const unsigned r = source[i * 4] >> 3;
+            const unsigned g = source[i * 4 + 1] >> 2;
+            const unsigned b = source[i * 4 + 2] >> 3;
+            dest[i]          = static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+        }
+    } break;
+    case PIXEL_FORMAT_RGBA16F: {
+        const auto& table = byte_to_half();
+        auto*       dest  = static_cast<std::uint16_t*>(out);
+        for (std::size_t i = 0; i < count * 4; ++i) {
+            dest[i] = table[source[i]];
+        }
+    } break;
+    }
+}
+
+void
+to_rgba8(const void* in, lpixel_format format, GLubyte* dest, std::size_t count)
+{
+    switch (format) {
+    case PIXEL_FORMAT_RGBA8:
+        std::memcpy(dest, in, count * 4);
+        break;
+    case PIXEL_FORMAT_R8: {
+        const auto* source = static_cast<const GLubyte*>(in);
+        for (std::size_t i = 0; i < count; ++i) {
+            dest[i * 4]     = source[i];
+            dest[i * 4 + 1] = 0;
+            dest[i * 4 + 2] = 0;
+            dest[i * 4 + 3] = 0xff;
+        }
+    } break;
+    case PIXEL_FORMAT_RG8: {
+        const auto* source = static_cast<const GLubyte*>(in);
+        for (std::size_t i = 0; i < count; ++i) {
+            dest[i * 4]     = source[i * 2];
+            dest[i * 4 + 1] = 0;
+            dest[i * 4 + 2] = 0;
+            dest[i * 4 + 3] = source[i * 2 + 1];
+        }
+    } break;
+    case PIXEL_FORMAT_RGB565: {
+        // replicate high bits into the low ones so white stays white
+        const auto* source = static_cast<const std::uint16_t*>(in);
+        for (std::size_t i = 0; i < count; ++i) {
+            const unsigned r = (source[i] >> 11) & 0x1fu;
+            const unsigned g = (source[i] >> 5) & 0x3fu;
+            const unsigned b = source[i] & 0x1fu;
+            dest[i * 4]      = static_cast<GLubyte>(r << 3 | r >> 2);
+            dest[i * 4 + 1]  = static_cast<GLubyte>(g << 2 | g >> 4);
+            dest[i * 4 + 2]  = static_cast<GLubyte>(b << 3 | b >> 2);
+            dest[i * 4 + 3]  = 0xff;
+        }
+    } break;
+    case PIXEL_FORMAT_RGBA16F: {
+        const auto* source = static_cast<const std::uint16_t*>(in);
+        for (std::size_t i = 0; i < count * 4; ++i) {
+            float value = half_to_float(source[i]);
+            value       = value < 0.f ? 0.f : value > 1.f ? 1.f : value;
+            dest[i]     = static_cast<GLubyte>(value * 255.f + 0.5f);
+        }
+    } break;
+    }
+}
+
+} // namespace
+
+const lpixel_format_info&
+pixel_format_info(lpixel_format format)
+{
+    return g_format_info[static_cast<std::size_t>(format)];
+}
+
+void
+convert_pixels(
+    const void*   source,
+    lpixel_format source_format,
+    void*         destination,
+    lpixel_format destination_format,
+    std::size_t   count)
+{
+    const auto& source_info = pixel_format_info(source_format);
+    const auto& dest_info   = pixel_format_info(destination_format);
+
+    // nothing to convert
+    if (source_format == destination_format) {
+        std::memcpy(destination, source, count * source_info.bytes_per_pixel);
+        return;
+    }
+
+    // one step conversions
+    if (source_format == PIXEL_FORMAT_RGBA8) {
+        from_rgba8(
+            static_cast<const GLubyte*>(source),
+            destination_format,
+            destination,
+            count);
+        return;
+    }
+    if (destination_format == PIXEL_FORMAT_RGBA8) {
+        to_rgba8(
+            source, source_format, static_cast<GLubyte*>(destination), count);
+        return;
+    }
+
+    // everything else goes through RGBA8
+    std::array<GLubyte, SLICE_PIXELS * 4> rgba;
+
+    const auto* in  = static_cast<const GLubyte*>(source);
+    auto*       out = static_cast<GLubyte*>(destination);
+    for (std::size_t first = 0; first < count; first += SLICE_PIXELS) {
+        const auto n = std::min(count - first, SLICE_PIXELS);
+        to_rgba8(
+            in + first * source_info.bytes_per_pixel,
+            source_format,
+            rgba.data(),
+            n);
+        from_rgba8(
+            rgba.data(),
+            destination_format,
+            out + first * dest_info.bytes_per_pixel,
+            n);
+    }
+}
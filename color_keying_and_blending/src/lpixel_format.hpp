@@ -0,0 +1,53 @@
+#ifndef LPIXEL_FORMAT_HPP
+#define LPIXEL_FORMAT_HPP
+
+#include <cstddef>
+
+#include "lopengl.hpp"
+
+enum lpixel_format { // no classes, values are passed around like GL enums
+    PIXEL_FORMAT_RGBA8,
+    PIXEL_FORMAT_R8,
+    PIXEL_FORMAT_RG8,
+    PIXEL_FORMAT_RGB565,
+    PIXEL_FORMAT_RGBA16F
+};
+
+// how pixels of a format are stored in client memory and on the GPU
+struct lpixel_format_info {
+    GLint       internal_format;
+    GLenum      format;
+    GLenum      type;
+    std::size_t bytes_per_pixel;
+    const char* name;
+};
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * returns upload parameters and client size of the format
+    * RG8 pixels are red and alpha, textures map green to alpha
+side-effects: n/a
+*/
+const lpixel_format_info& pixel_format_info(lpixel_format);
+
+/*
+pre-conditions:
+    * source holds count pixels of source format
+    * destination has room for count pixels of destination format
+    * buffers do not overlap
+post-conditions:
+    * converts pixels between formats, RGBA8 is the common ground: R8 keeps
+      red, RG8 keeps red and alpha, RGB565 drops alpha, RGBA16F maps
+      0..255 to 0.0..1.0
+    * equal formats are copied as is
+side-effects: n/a
+*/
+void convert_pixels(
+    const void*   source,
+    lpixel_format source_format,
+    void*         destination,
+    lpixel_format destination_format,
+    std::size_t   count);
+
+#endif // LPIXEL_FORMAT_HPP
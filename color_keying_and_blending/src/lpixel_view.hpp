@@ -0,0 +1,165 @@
+#ifndef LPIXEL_VIEW_HPP
+#define LPIXEL_VIEW_HPP
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "lopengl.hpp"
+#include "lrect.hpp"
+
+/*
+Non-owning view of a 2D block of pixels, rows are stride pixels apart. A view
+of a whole texture has stride equal to its width, sub-rectangle views keep the
+stride of the view they were taken from.
+
+Per-pixel work should go through row() or the algorithms below: they walk
+plain pointers row by row, which compiles to tight (vectorized) loops, instead
+of recomputing y * width + x for every pixel.
+*/
+template <typename Pixel>
+class lpixel_view {
+    Pixel*      _data   = {nullptr};
+    std::size_t _width  = {0};
+    std::size_t _height = {0};
+    std::size_t _stride = {0};
+
+public:
+    lpixel_view() = default;
+
+    lpixel_view(
+        Pixel* data, std::size_t width, std::size_t height, std::size_t stride)
+        : _data(data), _width(width), _height(height), _stride(stride)
+    {
+    }
+
+    lpixel_view(Pixel* data, const std::array<GLuint, 2>& dims)
+        : lpixel_view(data, dims[0], dims[1], dims[0])
+    {
+    }
+
+    // views of mutable pixels convert to views of const pixels
+    template <
+        typename Other,
+        typename = std::enable_if_t<std::is_convertible_v<Other*, Pixel*>>>
+    lpixel_view(const lpixel_view<Other>& other)
+        : lpixel_view(
+              other.row(0), other.width(), other.height(), other.stride())
+    {
+    }
+
+    std::size_t width() const { return _width; }
+    std::size_t height() const { return _height; }
+    std::size_t stride() const { return _stride; }
+    bool        empty() const { return !_data || !_width || !_height; }
+
+    /*
+    pre-conditions:
+        * y < height()
+    post-conditions: returns pointer to first pixel of row y
+    side-effects: n/a
+    */
+    Pixel* row(std::size_t y) const { return _data + y * _stride; }
+
+    /*
+    pre-conditions:
+        * x < width() and y < height()
+    post-conditions: returns pixel at given position
+    side-effects: n/a
+    */
+    Pixel& operator()(std::size_t x, std::size_t y) const { return row(y)[x]; }
+
+    /*
+    pre-conditions:
+        * rectangle {x, y, w, h} lies within the view
+    post-conditions: returns view of the rectangle
+    side-effects: n/a
+    */
+    lpixel_view sub(const lrect<GLuint>& rect) const
+    {
+        return {row(rect[1]) + rect[0], rect[2], rect[3], _stride};
+    }
+};
+
+/*
+pre-conditions: n/a
+post-conditions: sets every pixel of the view to value
+side-effects: n/a
+*/
+template <typename Pixel>
+void
+fill(const lpixel_view<Pixel>& view, Pixel value)
+{
+    for (std::size_t y = 0; y < view.height(); ++y) {
+        Pixel* const row = view.row(y);
+        for (std::size_t x = 0; x < view.width(); ++x) { row[x] = value; }
+    }
+}
+
+/*
+pre-conditions:
+    * function is callable as Pixel function(Pixel)
+post-conditions: replaces every pixel with function(pixel)
+side-effects: n/a
+*/
+template <typename Pixel, typename Function>
+void
+transform(const lpixel_view<Pixel>& view, Function function)
+{
+    for (std::size_t y = 0; y < view.height(); ++y) {
+        Pixel* const row = view.row(y);
+        for (std::size_t x = 0; x < view.width(); ++x) {
+            row[x] = function(row[x]);
+        }
+    }
+}
+
+/*
+pre-conditions:
+    * views have the same dimensions and do not overlap
+post-conditions: copies source pixels into destination
+side-effects: n/a
+*/
+template <typename Source, typename Pixel>
+void
+copy(const lpixel_view<Source>& source, const lpixel_view<Pixel>& dest)
+{
+    for (std::size_t y = 0; y < source.height(); ++y) {
+        const Source* const from = source.row(y);
+        Pixel* const       to   = dest.row(y);
+        for (std::size_t x = 0; x < source.width(); ++x) { to[x] = from[x]; }
+    }
+}
+
+/*
+pre-conditions:
+    * views have the same dimensions and do not overlap
+    * pixels are RGBA8 packed into GLuint, red in the lowest byte
+post-conditions:
+    * blends source over destination with source alpha, destination alpha
+      is kept
+side-effects: n/a
+*/
+inline void
+blend(const lpixel_view<const GLuint>& source, const lpixel_view<GLuint>& dest)
+{
+    for (std::size_t y = 0; y < source.height(); ++y) {
+        const GLuint* const from = source.row(y);
+        GLuint* const       to   = dest.row(y);
+        for (std::size_t x = 0; x < source.width(); ++x) {
+            const GLuint s = from[x];
+            const GLuint d = to[x];
+            const GLuint a = s >> 24;
+
+            GLuint out = d & 0xff000000u;
+            for (GLuint shift = 0; shift < 24; shift += 8) {
+                const GLuint sc = (s >> shift) & 0xffu;
+                const GLuint dc = (d >> shift) & 0xffu;
+                out |= ((sc * a + dc * (255u - a) + 127u) / 255u) << shift;
+            }
+            to[x] = out;
+        }
+    }
+}
+
+#endif // LPIXEL_VIEW_HPP
@@ -0,0 +1,708 @@
+#include "lrenderer.hpp"
+
+#include <cmath>   // for std::cos and std::sin
+#include <cstddef> // for offsetof
+#include <vector>
+
+#include <gsl/gsl_util> // for gsl::narrow
+
+#include "lsprite_program.hpp"
+#include "macro_helpers.hpp"
+
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
+namespace {
+
+// uniform buffer binding point of the camera block
+constexpr GLuint CAMERA_BINDING = 0;
+
+// vertex attribute locations, bound in this order when linking
+constexpr GLuint POSITION_LOCATION         = 0;
+constexpr GLuint TEXTURE_POSITION_LOCATION = 1;
+constexpr GLuint COLOR_LOCATION            = 2;
+
+// attribute locations of instanced sprites, corner is per vertex
+constexpr GLuint CORNER_LOCATION          = 0;
+constexpr GLuint SPRITE_POSITION_LOCATION = 1;
+constexpr GLuint SPRITE_CLIP_LOCATION     = 2;
+constexpr GLuint SPRITE_ROTATION_LOCATION = 3;
+constexpr GLuint SPRITE_TINT_LOCATION     = 4;
+
+// corners of the unit quad as a triangle strip
+constexpr std::array<GLfloat, 8> UNIT_QUAD = {
+    0.f, 0.f, // top left
+    1.f, 0.f, // top right
+    0.f, 1.f, // bottom left
+    1.f, 1.f  // bottom right
+};
+
+constexpr GLfloat DEGREES_TO_RADIANS = 3.14159265f / 180.f;
+
+// GLSL 1.20 with uniform blocks, the sprite program adds the fragment stage
+constexpr const char* VERTEX_SHADER = R"(
+#version 120
+#extension GL_ARB_uniform_buffer_object : require
+
+layout(std140) uniform camera
+{
+    mat4 projection;
+    mat4 view;
+};
+
+attribute vec2 position;
+attribute vec2 texture_position;
+attribute vec4 color;
+
+varying vec2 texcoord;
+
+void main()
+{
+    gl_Position   = projection * view * vec4(position, 0.0, 1.0);
+    gl_FrontColor = color;
+    texcoord      = texture_position;
+}
+)";
+
+// expands the unit quad of every sprite instance, texture coordinates come
+// from the clip in texels
+constexpr const char* INSTANCED_VERTEX_SHADER = R"(
+#version 120
+#extension GL_ARB_uniform_buffer_object : require
+
+layout(std140) uniform camera
+{
+    mat4 projection;
+    mat4 view;
+};
+
+uniform vec2 texture_size;
+
+attribute vec2  corner;
+attribute vec2  position;
+attribute vec4  clip;
+attribute float rotation;
+attribute vec4  color;
+
+varying vec2 texcoord;
+
+void main()
+{
+    // rotate around the center, clockwise with y pointing down
+    vec2  half_size = 0.5 * clip.zw;
+    vec2  offset    = corner * clip.zw - half_size;
+    float c         = cos(radians(rotation));
+    float s         = sin(radians(rotation));
+    vec2  rotated =
+        vec2(offset.x * c - offset.y * s, offset.x * s + offset.y * c);
+
+    gl_Position =
+        projection * view * vec4(position + half_size + rotated, 0.0, 1.0);
+    gl_FrontColor = color;
+    texcoord      = (clip.xy + corner * clip.zw) / texture_size;
+}
+)";
+
+// color key applied to the quads of a batch
+struct lcolor_key {
+    std::array<GLuint, 2>                 dimensions = {0, 0};
+    std::optional<std::array<GLubyte, 3>> rgb;
+    GLubyte                               a = {0};
+};
+
+/*
+Draws batches with client vertex arrays and the GL matrices. Color keys need
+the sprite program, which runs with the fixed-function vertex stage.
+*/
+class lfixed_renderer : public lrenderer {
+    lmatrix              _projection = IDENTITY_MATRIX;
+    lmatrix              _view       = IDENTITY_MATRIX;
+    lsprite_program      _sprites;
+    lcolor_key           _key;
+    GLuint               _texture = {0};
+    std::vector<lvertex> _vertices;
+
+    // quads are split into triangles (0, 1, 2), (0, 2, 3) like the other
+    // backends do, GL_QUADS leaves the split to the implementation
+    std::vector<GLuint> _indices;
+
+public:
+    void load()
+    {
+        // keying is optional, keyed images are rewritten on the CPU without
+        if (!_sprites.load()) {
+            std::cerr << "color keys are applied on the CPU\n";
+        }
+
+        glEnable(GL_TEXTURE_2D);
+    }
+
+    const char* name() const override { return "fixed-function"; }
+
+    void set_camera(const lmatrix& projection, const lmatrix& view) override
+    {
+        flush();
+
+        _projection = projection;
+        _view       = view;
+
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(_projection.data());
+        glMatrixMode(GL_MODELVIEW);
+        glLoadMatrixf(_view.data());
+    }
+
+    const lmatrix& projection() const override { return _projection; }
+    const lmatrix& view() const override { return _view; }
+
+    bool supports_color_key() const override { return _sprites.is_loaded(); }
+
+    void set_color_key(
+        std::array<GLuint, 2>                 dims,
+        std::optional<std::array<GLubyte, 3>> rgb,
+        GLubyte                               a) override
+    {
+        if (!supports_color_key()) return;
+
+        flush();
+        _key = {dims, rgb, a};
+    }
+
+    void draw(GLuint texture, const std::array<lvertex, 4>& quad) override
+    {
+        if (texture != _texture) flush();
+
+        _texture = texture;
+        _vertices.insert(_vertices.end(), quad.begin(), quad.end());
+    }
+
+    void flush() override
+    {
+        if (_vertices.empty()) return;
+
+        // plain colored quads
+        if (!_texture) glDisable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, _texture);
+
+        if (_key.rgb) {
+            _sprites.bind();
+            _sprites.set_color_key(_key.dimensions, _key.rgb, _key.a);
+        }
+
+        constexpr auto stride = gsl::narrow_cast<GLsizei>(sizeof(lvertex));
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, stride, &_vertices[0].x);
+        glTexCoordPointer(2, GL_FLOAT, stride, &_vertices[0].s);
+        glColorPointer(4, GL_UNSIGNED_BYTE, stride, &_vertices[0].color);
+
+        const auto quads = _vertices.size() / 4;
+        for (auto quad = _indices.size() / 6; quad < quads; ++quad) {
+            const auto first = gsl::narrow<GLuint>(quad * 4);
+            for (GLuint corner : {0u, 1u, 2u, 0u, 2u, 3u}) {
+                _indices.push_back(first + corner);
+            }
+        }
+        glDrawElements(
+            GL_TRIANGLES,
+            gsl::narrow<GLsizei>(quads * 6),
+            GL_UNSIGNED_INT,
+            _indices.data());
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        if (_key.rgb) _sprites.unbind();
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        if (!_texture) glEnable(GL_TEXTURE_2D);
+
+        // color array leaves current color undefined
+        glColor4f(1.f, 1.f, 1.f, 1.f);
+
+        _vertices.clear();
+    }
+};
+
+/*
+Streams interleaved vertices through a buffer object and draws them as
+indexed triangles with the sprite program and a vertex shader reading the
+camera from a uniform buffer.
+*/
+class lshader_renderer : public lrenderer {
+    lmatrix              _projection = IDENTITY_MATRIX;
+    lmatrix              _view       = IDENTITY_MATRIX;
+    lsprite_program      _program;
+    lcolor_key           _key;
+    GLuint               _texture = {0};
+    std::vector<lvertex> _vertices;
+
+    // instanced sprites, queued apart from quads, flushed in order with them
+    lsprite_program       _instanced_program;
+    std::array<GLuint, 2> _texture_dimensions = {0, 0};
+    std::vector<lsprite>  _sprites;
+
+    // buffer and texture names
+    GLuint _vertex_buffer   = {0};
+    GLuint _index_buffer    = {0};
+    GLuint _camera_buffer   = {0};
+    GLuint _white_texture   = {0};
+    GLuint _corner_buffer   = {0};
+    GLuint _instance_buffer = {0};
+
+    // quads the index buffer covers
+    std::size_t _index_quads = {0};
+
+    void reserve_indices(std::size_t quads)
+    {
+        if (quads <= _index_quads) return;
+
+        // grow in powers of two, the buffer is rebuilt rarely
+        std::size_t capacity = _index_quads ? _index_quads : 64;
+        while (capacity < quads) capacity *= 2;
+
+        std::vector<GLuint> indices;
+        indices.reserve(capacity * 6);
+        for (GLuint quad = 0; quad < capacity; ++quad) {
+            const GLuint first = quad * 4;
+            for (GLuint corner : {0u, 1u, 2u, 0u, 2u, 3u}) {
+                indices.push_back(first + corner);
+            }
+        }
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            gsl::narrow<GLsizeiptr>(indices.size() * sizeof(GLuint)),
+            indices.data(),
+            GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        _index_quads = capacity;
+    }
+
+    bool load_instancing()
+    {
+        // instanced arrays are core since OpenGL 3.3, instanced draws since
+        // OpenGL 3.1
+        if (!gl_supported(3, 3, "GL_ARB_instanced_arrays") ||
+            !gl_supported(3, 1, "GL_ARB_draw_instanced")) {
+            std::cerr << "instanced arrays are not supported\n";
+            return false;
+        }
+
+        if (!_instanced_program.load(
+                INSTANCED_VERTEX_SHADER,
+                {"corner", "position", "clip", "rotation", "color"}) ||
+            !bind_camera(_instanced_program)) {
+            _instanced_program.free_program();
+            return false;
+        }
+
+        glGenBuffers(1, &_corner_buffer);
+        glGenBuffers(1, &_instance_buffer);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _corner_buffer);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            sizeof(UNIT_QUAD),
+            UNIT_QUAD.data(),
+            GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        return true;
+    }
+
+    static bool bind_camera(const lsprite_program& program)
+    {
+        for (GLuint program_id : program.get_program_ids()) {
+            const GLuint camera = glGetUniformBlockIndex(program_id, "camera");
+            if (camera == GL_INVALID_INDEX) {
+                std::cerr << "renderer shader lacks camera block\n";
+                return false;
+            }
+            glUniformBlockBinding(program_id, camera, CAMERA_BINDING);
+        }
+        return true;
+    }
+
+    void flush_quads()
+    {
+        const std::size_t quads = _vertices.size() / 4;
+        reserve_indices(quads);
+
+        _program.bind();
+        _program.set_color_key(_key.dimensions, _key.rgb, _key.a);
+        glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, _camera_buffer);
+        glBindTexture(GL_TEXTURE_2D, _texture ? _texture : _white_texture);
+
+        // orphan last batch's storage instead of waiting for it
+        glBindBuffer(GL_ARRAY_BUFFER, _vertex_buffer);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            gsl::narrow<GLsizeiptr>(_vertices.size() * sizeof(lvertex)),
+            _vertices.data(),
+            GL_STREAM_DRAW);
+
+        constexpr auto stride = gsl::narrow_cast<GLsizei>(sizeof(lvertex));
+        glEnableVertexAttribArray(POSITION_LOCATION);
+        glEnableVertexAttribArray(TEXTURE_POSITION_LOCATION);
+        glEnableVertexAttribArray(COLOR_LOCATION);
+        glVertexAttribPointer(
+            POSITION_LOCATION,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            stride,
+            reinterpret_cast<const void*>(offsetof(lvertex, x)));
+        glVertexAttribPointer(
+            TEXTURE_POSITION_LOCATION,
+            2,
+            GL_FLOAT,
+            GL_FALSE,
+            stride,
+            reinterpret_cast<const void*>(offsetof(lvertex, s)));
+        glVertexAttribPointer(
+            COLOR_LOCATION,
+            4,
+            GL_UNSIGNED_BYTE,
+            GL_TRUE,
+            stride,
+            reinterpret_cast<const void*>(offsetof(lvertex, color)));
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+        glDrawElements(
+            GL_TRIANGLES,
+            gsl::narrow<GLsizei>(quads * 6),
+            GL_UNSIGNED_INT,
+            nullptr);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        glDisableVertexAttribArray(COLOR_LOCATION);
+        glDisableVertexAttribArray(TEXTURE_POSITION_LOCATION);
+        glDisableVertexAttribArray(POSITION_LOCATION);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        _program.unbind();
+
+        _vertices.clear();
+    }
+
+    void flush_sprites()
+    {
+        _instanced_program.bind();
+        _instanced_program.set_color_key(_key.dimensions, _key.rgb, _key.a);
+        _instanced_program.set_texture_size(
+            _texture ? _texture_dimensions : std::array<GLuint, 2>{1, 1});
+        glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, _camera_buffer);
+        glBindTexture(GL_TEXTURE_2D, _texture ? _texture : _white_texture);
+
+        // one unit quad for all instances
+        glBindBuffer(GL_ARRAY_BUFFER, _corner_buffer);
+        glEnableVertexAttribArray(CORNER_LOCATION);
+        glVertexAttribPointer(
+            CORNER_LOCATION, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+        // orphaned like the vertices of quads
+        glBindBuffer(GL_ARRAY_BUFFER, _instance_buffer);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            gsl::narrow<GLsizeiptr>(_sprites.size() * sizeof(lsprite)),
+            _sprites.data(),
+            GL_STREAM_DRAW);
+
+        // attributes advance once per instance
+        struct lattribute {
+            GLuint      location;
+            GLint       size;
+            GLenum      type;
+            GLboolean   normalized;
+            std::size_t offset;
+        };
+        constexpr auto stride = gsl::narrow_cast<GLsizei>(sizeof(lsprite));
+        for (const auto& attribute :
+             {lattribute{
+                  SPRITE_POSITION_LOCATION,
+                  2,
+                  GL_FLOAT,
+                  GL_FALSE,
+                  offsetof(lsprite, x)},
+              lattribute{
+                  SPRITE_CLIP_LOCATION,
+                  4,
+                  GL_FLOAT,
+                  GL_FALSE,
+                  offsetof(lsprite, clip)},
+              lattribute{
+                  SPRITE_ROTATION_LOCATION,
+                  1,
+                  GL_FLOAT,
+                  GL_FALSE,
+                  offsetof(lsprite, rotation)},
+              lattribute{
+                  SPRITE_TINT_LOCATION,
+                  4,
+                  GL_UNSIGNED_BYTE,
+                  GL_TRUE,
+                  offsetof(lsprite, tint)}}) {
+            glEnableVertexAttribArray(attribute.location);
+            glVertexAttribPointer(
+                attribute.location,
+                attribute.size,
+                attribute.type,
+                attribute.normalized,
+                stride,
+                reinterpret_cast<const void*>(attribute.offset));
+            glVertexAttribDivisor(attribute.location, 1);
+        }
+
+        glDrawArraysInstanced(
+            GL_TRIANGLE_STRIP, 0, 4, gsl::narrow<GLsizei>(_sprites.size()));
+
+        // divisors outlive the draw, quads expect per vertex attributes
+        for (GLuint location = SPRITE_TINT_LOCATION;
+             location > CORNER_LOCATION;
+             --location) {
+            glVertexAttribDivisor(location, 0);
+            glDisableVertexAttribArray(location);
+        }
+        glDisableVertexAttribArray(CORNER_LOCATION);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        _instanced_program.unbind();
+
+        _sprites.clear();
+    }
+
+public:
+    ~lshader_renderer() override
+    {
+        glDeleteBuffers(1, &_vertex_buffer);
+        glDeleteBuffers(1, &_index_buffer);
+        glDeleteBuffers(1, &_camera_buffer);
+        glDeleteTextures(1, &_white_texture);
+        glDeleteBuffers(1, &_corner_buffer);
+        glDeleteBuffers(1, &_instance_buffer);
+    }
+
+    bool load(bool instancing)
+    {
+        // uniform buffers are core since OpenGL 3.1
+        if (!gl_supported(3, 1, "GL_ARB_uniform_buffer_object")) {
+            std::cerr << "uniform buffer objects are not supported\n";
+            return false;
+        }
+
+        if (!_program.load(
+                VERTEX_SHADER, {"position", "texture_position", "color"}) ||
+            !bind_camera(_program)) {
+            return false;
+        }
+
+        glGenBuffers(1, &_vertex_buffer);
+        glGenBuffers(1, &_index_buffer);
+        glGenBuffers(1, &_camera_buffer);
+
+        // projection and view
+        glBindBuffer(GL_UNIFORM_BUFFER, _camera_buffer);
+        glBufferData(
+            GL_UNIFORM_BUFFER, 2 * sizeof(lmatrix), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        set_camera(_projection, _view);
+
+        // texture 0 draws plain colors, sample white instead
+        const GLuint white = 0xffffffff;
+        glGenTextures(1, &_white_texture);
+        glBindTexture(GL_TEXTURE_2D, _white_texture);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RGBA,
+            1,
+            1,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            &white);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // sprites are expanded into quads without instancing
+        if (instancing && !load_instancing()) {
+            std::cerr << "sprites are expanded on the CPU\n";
+        }
+
+        return true;
+    }
+
+    const char* name() const override
+    {
+        return supports_instancing() ? "programmable instanced"
+                                     : "programmable";
+    }
+
+    void set_camera(const lmatrix& projection, const lmatrix& view) override
+    {
+        flush();
+
+        _projection = projection;
+        _view       = view;
+
+        glBindBuffer(GL_UNIFORM_BUFFER, _camera_buffer);
+        glBufferSubData(
+            GL_UNIFORM_BUFFER, 0, sizeof(lmatrix), _projection.data());
+        glBufferSubData(
+            GL_UNIFORM_BUFFER, sizeof(lmatrix), sizeof(lmatrix), _view.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    const lmatrix& projection() const override { return _projection; }
+    const lmatrix& view() const override { return _view; }
+
+    bool supports_color_key() const override { return true; }
+
+    void set_color_key(
+        std::array<GLuint, 2>                 dims,
+        std::optional<std::array<GLubyte, 3>> rgb,
+        GLubyte                               a) override
+    {
+        flush();
+        _key = {dims, rgb, a};
+    }
+
+    void draw(GLuint texture, const std::array<lvertex, 4>& quad) override
+    {
+        if (texture != _texture || !_sprites.empty()) flush();
+
+        _texture = texture;
+        _vertices.insert(_vertices.end(), quad.begin(), quad.end());
+    }
+
+    bool supports_instancing() const override
+    {
+        return _instanced_program.is_loaded();
+    }
+
+    void draw_sprite(
+        GLuint                texture,
+        std::array<GLuint, 2> dims,
+        const lsprite&        sprite) override
+    {
+        if (!supports_instancing()) {
+            lrenderer::draw_sprite(texture, dims, sprite);
+            return;
+        }
+
+        if (texture != _texture || !_vertices.empty()) flush();
+
+        _texture            = texture;
+        _texture_dimensions = dims;
+        _sprites.push_back(sprite);
+    }
+
+    void flush() override
+    {
+        // at most one of them is queued
+        if (!_vertices.empty()) flush_quads();
+        if (!_sprites.empty()) flush_sprites();
+    }
+};
+
+} // namespace
+
+lmatrix
+ortho_matrix(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top)
+{
+    lmatrix matrix = IDENTITY_MATRIX;
+    matrix[0]      = 2.f / (right - left);
+    matrix[5]      = 2.f / (top - bottom);
+    matrix[10]     = 1.f; // -2 / (far - near) with near 1 and far -1
+    matrix[12]     = -(right + left) / (right - left);
+    matrix[13]     = -(top + bottom) / (top - bottom);
+    return matrix;
+}
+
+GLuint
+pack_color(const std::array<GLfloat, 4>& color)
+{
+    GLuint packed = 0;
+    for (std::size_t channel = 0; channel < 4; ++channel) {
+        const GLfloat value = color[channel] < 0.f   ? 0.f
+                              : color[channel] > 1.f ? 1.f
+                                                     : color[channel];
+        packed |= static_cast<GLuint>(value * 255.f + 0.5f) << (channel * 8);
+    }
+    return packed;
+}
+
+bool
+lrenderer::supports_instancing() const
+{
+    return false;
+}
+
+void
+lrenderer::draw_sprite(
+    GLuint texture, std::array<GLuint, 2> dims, const lsprite& sprite)
+{
+    const auto& clip   = sprite.clip;
+    const auto  width  = gsl::narrow<GLfloat>(Wv(dims));
+    const auto  height = gsl::narrow<GLfloat>(Hv(dims));
+
+    // texture coordinates
+    const GLfloat left   = Lv(clip) / width;
+    const GLfloat top    = Tv(clip) / height;
+    const GLfloat right  = (Lv(clip) + Rv(clip)) / width;
+    const GLfloat bottom = (Tv(clip) + Bv(clip)) / height;
+
+    // corners around the center in the order of the old GL_QUADS, rotated
+    // as the instanced vertex shader does
+    const GLfloat half_width  = Rv(clip) / 2.f;
+    const GLfloat half_height = Bv(clip) / 2.f;
+    const GLfloat center_x    = sprite.x + half_width;
+    const GLfloat center_y    = sprite.y + half_height;
+    const GLfloat c = std::cos(sprite.rotation * DEGREES_TO_RADIANS);
+    const GLfloat s = std::sin(sprite.rotation * DEGREES_TO_RADIANS);
+
+    std::array<lvertex, 4> quad = {
+        {{-half_width, -half_height, left, top, sprite.tint},
+         {half_width, -half_height, right, top, sprite.tint},
+         {half_width, half_height, right, bottom, sprite.tint},
+         {-half_width, half_height, left, bottom, sprite.tint}}};
+    for (auto& vertex : quad) {
+        const GLfloat x = vertex.x;
+        vertex.x        = center_x + x * c - vertex.y * s;
+        vertex.y        = center_y + x * s + vertex.y * c;
+    }
+
+    draw(texture, quad);
+}
+
+std::unique_ptr<lrenderer>
+make_renderer(bool programmable, bool instancing)
+{
+    std::unique_ptr<lrenderer> renderer;
+
+    if (programmable) {
+        auto shader_renderer = std::make_unique<lshader_renderer>();
+        if (shader_renderer->load(instancing)) {
+            renderer = std::move(shader_renderer);
+        } else {
+            std::cerr << "falling back to fixed-function rendering\n";
+        }
+    }
+
+    if (!renderer) {
+        auto fixed_renderer = std::make_unique<lfixed_renderer>();
+        fixed_renderer->load();
+        renderer = std::move(fixed_renderer);
+    }
+
+    std::cout << "rendering with the " << renderer->name() << " renderer\n";
+    return renderer;
+}
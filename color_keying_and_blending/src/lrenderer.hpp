@@ -0,0 +1,189 @@
+#ifndef LRENDERER_HPP
+#define LRENDERER_HPP
+
+#include <array>
+#include <memory>
+#include <optional>
+
+#include "lopengl.hpp"
+#include "lrect.hpp"
+
+// column-major 4x4 matrix, as GL takes them
+using lmatrix = std::array<GLfloat, 16>;
+
+constexpr lmatrix IDENTITY_MATRIX = {
+    1.f, 0.f, 0.f, 0.f, // column 0
+    0.f, 1.f, 0.f, 0.f, // column 1
+    0.f, 0.f, 1.f, 0.f, // column 2
+    0.f, 0.f, 0.f, 1.f  // column 3
+};
+
+/*
+pre-conditions:
+    * left != right, bottom != top
+post-conditions:
+    * returns orthographic projection of the given rectangle, same as glOrtho
+      with near 1 and far -1
+side-effects: n/a
+*/
+lmatrix ortho_matrix(GLfloat left, GLfloat right, GLfloat bottom, GLfloat top);
+
+/*
+Interleaved vertex of a quad: position, texture coordinates and RGBA8 color,
+red in the lowest byte.
+*/
+struct lvertex {
+    GLfloat x     = {0.f};
+    GLfloat y     = {0.f};
+    GLfloat s     = {0.f};
+    GLfloat t     = {0.f};
+    GLuint  color = {0xffffffff};
+};
+
+/*
+Sprite instance: top left position, clip rectangle in texture pixels, rotation
+in degrees around the center of the clip, clockwise on screen, and RGBA8 tint
+packed as lvertex colors. 32 bytes instead of the 80 of its four vertices.
+*/
+struct lsprite {
+    GLfloat x        = {0.f};
+    GLfloat y        = {0.f};
+    lfrect  clip     = {0.f, 0.f, 0.f, 0.f};
+    GLfloat rotation = {0.f};
+    GLuint  tint     = {0xffffffff};
+};
+
+/*
+pre-conditions: n/a
+post-conditions: returns color packed for lvertex
+side-effects: n/a
+*/
+GLuint pack_color(const std::array<GLfloat, 4>&);
+
+/*
+Renders batches of quads. Quads are queued with the texture they use and
+submitted together when the texture, color key or camera changes, or on
+flush. The programmable backend streams interleaved vertices through a
+buffer object and reads the camera from a uniform buffer; the fixed-function
+backend draws the same vertices from client arrays with the GL matrices.
+Sprites are drawn as instances of a unit quad where instanced arrays are
+supported, other renderers expand them into quads on the CPU.
+
+Only this tutorial renders through it. The earlier tutorials are lessons in
+the fixed-function calls themselves, glBegin, glColor and the matrix stack,
+and keep them.
+*/
+class lrenderer {
+public:
+    virtual ~lrenderer() = default;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns backend name for diagnostics
+    side-effects: n/a
+    */
+    virtual const char* name() const = 0;
+
+    /*
+    pre-conditions:
+        * valid GL context
+    post-conditions:
+        * submits queued quads, then uses given projection and view for the
+          quads queued next
+    side-effects:
+        * fixed-function backend replaces the projection and modelview
+          matrices and sets matrix mode to modelview
+    */
+    virtual void set_camera(const lmatrix& projection, const lmatrix& view) = 0;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns projection and view of the camera
+    side-effects: n/a
+    */
+    virtual const lmatrix& projection() const = 0;
+    virtual const lmatrix& view() const = 0;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns true if set_color_key drops keyed texels, renderers without
+          shaders need keyed images rewritten on the CPU
+    side-effects: n/a
+    */
+    virtual bool supports_color_key() const = 0;
+
+    /*
+    pre-conditions:
+        * valid GL context
+    post-conditions:
+        * submits queued quads, then drops texels with given RGBA value from
+          the quads queued next, if A = 0 only RGB components are compared
+        * a null color key turns keying off
+        * ignored unless supports_color_key
+    side-effects: n/a
+    */
+    virtual void set_color_key(
+        std::array<GLuint, 2>                 texture_dimensions,
+        std::optional<std::array<GLubyte, 3>> rgb,
+        GLubyte                               a = 0) = 0;
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * vertices in counter-clockwise or clockwise order
+    post-conditions:
+        * queues a quad drawn with given texture, texture 0 draws plain
+          colored quads
+    side-effects: n/a
+    */
+    virtual void draw(GLuint texture, const std::array<lvertex, 4>&) = 0;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns true if draw_sprite queues instances instead of quads
+    side-effects: n/a
+    */
+    virtual bool supports_instancing() const;
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * given dimensions are those of the texture
+    post-conditions:
+        * queues sprite drawn with given texture, in order with the quads
+          queued by draw
+    side-effects: n/a
+    */
+    virtual void draw_sprite(
+        GLuint                texture,
+        std::array<GLuint, 2> texture_dimensions,
+        const lsprite&);
+
+    /*
+    pre-conditions:
+        * valid GL context
+    post-conditions:
+        * submits queued quads
+    side-effects:
+        * binds textures of the quads and a null-texture after them
+    */
+    virtual void flush() = 0;
+};
+
+/*
+pre-conditions:
+    * valid GL context
+post-conditions:
+    * returns the programmable renderer if requested and supported, the
+      fixed-function renderer otherwise
+    * the programmable renderer draws sprites instanced if requested and
+      supported
+    * reports to console which renderer is used
+side-effects: n/a
+*/
+std::unique_ptr<lrenderer>
+make_renderer(bool programmable, bool instancing = true);
+
+#endif // LRENDERER_HPP
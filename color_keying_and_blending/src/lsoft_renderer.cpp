@@ -0,0 +1,685 @@
+#include "lsoft_renderer.hpp"
+
+#include <algorithm>
+#include <cmath> // for std::floor and std::lround
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "macro_helpers.hpp"
+
+namespace {
+
+// framebuffer tiles rendered by one worker at a time
+constexpr long TILE_SIZE = 64;
+
+// fixed point window coordinates, 8 subpixel bits like common GPUs
+constexpr int          SUBPIXEL_BITS = 8;
+constexpr std::int64_t SUBPIXEL      = std::int64_t{1} << SUBPIXEL_BITS;
+
+// vertices are clamped to a guard band, which keeps edge functions in range
+constexpr GLfloat GUARD_BAND = 1 << 20;
+
+// keyed texels turn transparent white, as with keying on the CPU
+constexpr GLuint KEYED_TEXEL = 0x00ffffffu;
+
+/*
+The four channels of a pixel as floats in 0..1, in one SSE register where
+available. Spans do all per pixel math through it, so blending is a handful
+of instructions without per channel loops or branches.
+*/
+#ifdef __SSE2__
+
+struct lvec4 {
+    __m128 v;
+};
+
+lvec4
+splat(GLfloat value)
+{
+    return {_mm_set1_ps(value)};
+}
+
+lvec4
+load(const std::array<GLfloat, 4>& values)
+{
+    return {_mm_loadu_ps(values.data())};
+}
+
+lvec4
+operator+(lvec4 a, lvec4 b)
+{
+    return {_mm_add_ps(a.v, b.v)};
+}
+
+lvec4
+operator-(lvec4 a, lvec4 b)
+{
+    return {_mm_sub_ps(a.v, b.v)};
+}
+
+lvec4
+operator*(lvec4 a, lvec4 b)
+{
+    return {_mm_mul_ps(a.v, b.v)};
+}
+
+lvec4
+alpha(lvec4 a)
+{
+    return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 3, 3, 3))};
+}
+
+lvec4
+unpack(GLuint pixel)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i bytes = _mm_cvtsi32_si128(static_cast<int>(pixel));
+    const __m128i words = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i ints  = _mm_unpacklo_epi16(words, zero);
+    return {_mm_mul_ps(_mm_cvtepi32_ps(ints), _mm_set1_ps(1.f / 255.f))};
+}
+
+// rounds to nearest, saturating packs clamp to 0..255
+GLuint
+pack(lvec4 color)
+{
+    const __m128i ints =
+        _mm_cvtps_epi32(_mm_mul_ps(color.v, _mm_set1_ps(255.f)));
+    const __m128i words = _mm_packs_epi32(ints, ints);
+    const __m128i bytes = _mm_packus_epi16(words, words);
+    return static_cast<GLuint>(_mm_cvtsi128_si32(bytes));
+}
+
+#else // plain floats
+
+struct lvec4 {
+    std::array<GLfloat, 4> v;
+};
+
+lvec4
+splat(GLfloat value)
+{
+    return {{value, value, value, value}};
+}
+
+lvec4
+load(const std::array<GLfloat, 4>& values)
+{
+    return {values};
+}
+
+lvec4
+operator+(lvec4 a, lvec4 b)
+{
+    return {{a.v[0] + b.v[0],
+             a.v[1] + b.v[1],
+             a.v[2] + b.v[2],
+             a.v[3] + b.v[3]}};
+}
+
+lvec4
+operator-(lvec4 a, lvec4 b)
+{
+    return {{a.v[0] - b.v[0],
+             a.v[1] - b.v[1],
+             a.v[2] - b.v[2],
+             a.v[3] - b.v[3]}};
+}
+
+lvec4
+operator*(lvec4 a, lvec4 b)
+{
+    return {{a.v[0] * b.v[0],
+             a.v[1] * b.v[1],
+             a.v[2] * b.v[2],
+             a.v[3] * b.v[3]}};
+}
+
+lvec4
+alpha(lvec4 a)
+{
+    return splat(a.v[3]);
+}
+
+GLfloat
+channel(GLuint pixel, GLuint shift)
+{
+    return static_cast<GLfloat>((pixel >> shift) & 0xffu) * (1.f / 255.f);
+}
+
+lvec4
+unpack(GLuint pixel)
+{
+    return {{channel(pixel, 0),
+             channel(pixel, 8),
+             channel(pixel, 16),
+             channel(pixel, 24)}};
+}
+
+GLuint
+quantize(GLfloat value, GLuint shift)
+{
+    return static_cast<GLuint>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f)
+           << shift;
+}
+
+GLuint
+pack(lvec4 color)
+{
+    return quantize(color.v[0], 0) | quantize(color.v[1], 8) |
+           quantize(color.v[2], 16) | quantize(color.v[3], 24);
+}
+
+#endif // __SSE2__
+
+lvec4
+lerp(lvec4 a, lvec4 b, lvec4 t)
+{
+    return a + (b - a) * t;
+}
+
+// GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA on every channel, alpha included
+GLuint
+blend(GLuint destination, lvec4 source)
+{
+    return pack(lerp(unpack(destination), source, alpha(source)));
+}
+
+// GL_REPEAT wrapping of a texel coordinate
+std::size_t
+wrap(long coordinate, long size)
+{
+    coordinate %= size;
+    return static_cast<std::size_t>(coordinate < 0 ? coordinate + size
+                                                   : coordinate);
+}
+
+// integer division rounding down and up, for positive divisors
+std::int64_t
+floor_div(std::int64_t a, std::int64_t b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+std::int64_t
+ceil_div(std::int64_t a, std::int64_t b)
+{
+    return -floor_div(-a, b);
+}
+
+// untextured span, color steps linearly along the row
+void
+colored_span(GLuint* row, long first, long last, lvec4 color, lvec4 step)
+{
+    for (long x = first; x < last; ++x) {
+        const auto k = splat(static_cast<GLfloat>(x - first));
+        row[x]       = blend(row[x], color + step * k);
+    }
+}
+
+/*
+GL_LINEAR sampling along a span: texel centers are at +0.5, texture
+coordinates are in texels and step linearly along the row. Keyed texels are
+replaced before filtering, like the sprite program does.
+*/
+void
+textured_span(
+    GLuint*                          row,
+    long                             first,
+    long                             last,
+    const lpixel_view<const GLuint>& texture,
+    std::array<GLfloat, 2>           texcoord,
+    std::array<GLfloat, 2>           texcoord_step,
+    lvec4                            color,
+    lvec4                            color_step,
+    GLuint                           key,
+    GLuint                           key_mask)
+{
+    const auto w = static_cast<long>(texture.width());
+    const auto h = static_cast<long>(texture.height());
+
+    const auto fetch = [key, key_mask](GLuint texel) {
+        return unpack((texel & key_mask) == key ? KEYED_TEXEL : texel);
+    };
+
+    for (long x = first; x < last; ++x) {
+        const auto k  = static_cast<GLfloat>(x - first);
+        const auto u  = texcoord[0] + texcoord_step[0] * k - 0.5f;
+        const auto v  = texcoord[1] + texcoord_step[1] * k - 0.5f;
+        const auto x0 = std::floor(u);
+        const auto y0 = std::floor(v);
+        const auto ix = static_cast<long>(x0);
+        const auto iy = static_cast<long>(y0);
+
+        // both columns and rows inside the texture is the common case
+        std::size_t left  = static_cast<std::size_t>(ix);
+        std::size_t right = left + 1;
+        std::size_t top   = static_cast<std::size_t>(iy);
+        std::size_t down  = top + 1;
+        if (ix < 0 || ix + 1 >= w) {
+            left  = wrap(ix, w);
+            right = wrap(ix + 1, w);
+        }
+        if (iy < 0 || iy + 1 >= h) {
+            top  = wrap(iy, h);
+            down = wrap(iy + 1, h);
+        }
+
+        const GLuint* top_row  = texture.row(top);
+        const GLuint* down_row = texture.row(down);
+        const auto    texel    = lerp(
+            lerp(fetch(top_row[left]), fetch(top_row[right]), splat(u - x0)),
+            lerp(
+                fetch(down_row[left]), fetch(down_row[right]), splat(u - x0)),
+            splat(v - y0));
+
+        row[x] = blend(row[x], texel * (color + color_step * splat(k)));
+    }
+}
+
+lrect<long>
+intersect(const lrect<long>& a, const lrect<long>& b)
+{
+    return {std::max(Lv(a), Lv(b)),
+            std::max(Tv(a), Tv(b)),
+            std::min(Rv(a), Rv(b)),
+            std::min(Bv(a), Bv(b))};
+}
+
+// column-major a * b
+lmatrix
+multiply(const lmatrix& a, const lmatrix& b)
+{
+    lmatrix out = {};
+    for (std::size_t column = 0; column < 4; ++column) {
+        for (std::size_t row = 0; row < 4; ++row) {
+            for (std::size_t k = 0; k < 4; ++k) {
+                out[column * 4 + row] += a[k * 4 + row] * b[column * 4 + k];
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+lsoft_renderer::lsoft_renderer(
+    std::array<GLuint, 2> dimensions, std::size_t threads)
+    : _pixels(std::size_t{Wv(dimensions)} * Hv(dimensions), 0xff000000u),
+      _dimensions(dimensions)
+{
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    for (std::size_t i = 1; i < threads; ++i) {
+        _workers.emplace_back([this]() { work(); });
+    }
+
+    set_camera(
+        ortho_matrix(
+            0.f,
+            static_cast<GLfloat>(Wv(dimensions)),
+            static_cast<GLfloat>(Hv(dimensions)),
+            0.f),
+        IDENTITY_MATRIX);
+}
+
+lsoft_renderer::~lsoft_renderer()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (auto& worker : _workers) { worker.join(); }
+}
+
+GLuint
+lsoft_renderer::add_texture(const lpixel_view<const GLuint>& pixels)
+{
+    _textures.push_back(pixels);
+    return static_cast<GLuint>(_textures.size());
+}
+
+void
+lsoft_renderer::clear(const lcolor& color)
+{
+    _triangles.clear();
+    std::fill(_pixels.begin(), _pixels.end(), pack(load(color)));
+}
+
+lpixel_view<const GLuint>
+lsoft_renderer::pixels() const
+{
+    return {_pixels.data(), _dimensions};
+}
+
+const char*
+lsoft_renderer::name() const
+{
+    return "software";
+}
+
+void
+lsoft_renderer::set_camera(const lmatrix& projection, const lmatrix& view)
+{
+    _projection = projection;
+    _view       = view;
+    _transform  = multiply(projection, view);
+}
+
+const lmatrix&
+lsoft_renderer::projection() const
+{
+    return _projection;
+}
+
+const lmatrix&
+lsoft_renderer::view() const
+{
+    return _view;
+}
+
+bool
+lsoft_renderer::supports_color_key() const
+{
+    return true;
+}
+
+void
+lsoft_renderer::set_color_key(
+    std::array<GLuint, 2>, std::optional<std::array<GLubyte, 3>> rgb, GLubyte a)
+{
+    // no texel matches a key of 1 under an empty mask
+    if (!rgb) {
+        _key      = 1;
+        _key_mask = 0;
+        return;
+    }
+
+    _key = GLuint{Rc(*rgb)} | GLuint{Gc(*rgb)} << 8 | GLuint{Bc(*rgb)} << 16 |
+           GLuint{a} << 24;
+    _key_mask = a == 0 ? 0x00ffffffu : 0xffffffffu;
+}
+
+void
+lsoft_renderer::draw(GLuint texture, const std::array<lvertex, 4>& quad)
+{
+    const auto pixels = texture != 0 && texture <= _textures.size()
+                            ? _textures[texture - 1]
+                            : lpixel_view<const GLuint>();
+
+    // split like the GL backends split quads
+    add_triangle(pixels, quad, {0, 1, 2});
+    add_triangle(pixels, quad, {0, 2, 3});
+}
+
+void
+lsoft_renderer::add_triangle(
+    const lpixel_view<const GLuint>& texture,
+    const std::array<lvertex, 4>&    quad,
+    const std::array<int, 3>&        corners)
+{
+    const auto width  = static_cast<GLfloat>(Wv(_dimensions));
+    const auto height = static_cast<GLfloat>(Hv(_dimensions));
+    const auto& m     = _transform;
+
+    ltriangle triangle;
+    triangle.texture  = texture;
+    triangle.key      = _key;
+    triangle.key_mask = _key_mask;
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto& vertex = quad[static_cast<std::size_t>(corners[i])];
+
+        // clip space, then window coordinates with row 0 at the top
+        const auto clip_x = m[0] * vertex.x + m[4] * vertex.y + m[12];
+        const auto clip_y = m[1] * vertex.x + m[5] * vertex.y + m[13];
+        const auto clip_w = m[3] * vertex.x + m[7] * vertex.y + m[15];
+        const auto x      = (clip_x / clip_w + 1.f) * 0.5f * width;
+        const auto y      = (1.f - clip_y / clip_w) * 0.5f * height;
+
+        triangle.vertices[i] = {
+            std::lround(std::clamp(x, -GUARD_BAND, GUARD_BAND) * SUBPIXEL),
+            std::lround(std::clamp(y, -GUARD_BAND, GUARD_BAND) * SUBPIXEL)};
+        triangle.colors[i]    = {};
+        triangle.texcoords[i] = {
+            vertex.s * static_cast<GLfloat>(texture.width()),
+            vertex.t * static_cast<GLfloat>(texture.height())};
+        for (GLuint c = 0; c < 4; ++c) {
+            triangle.colors[i][c] =
+                static_cast<GLfloat>((vertex.color >> (c * 8)) & 0xffu) /
+                255.f;
+        }
+    }
+
+    // edge function of v[a] -> v[b], positive on the side of the third
+    // vertex once the triangle winds clockwise on screen
+    auto& v         = triangle.vertices;
+    const auto edge = [&v](std::size_t a, std::size_t b) {
+        return std::array<std::int64_t, 2>{
+            Yc(v[a]) - Yc(v[b]), Xc(v[b]) - Xc(v[a])};
+    };
+    const auto area = [&]() {
+        const auto e = edge(0, 1);
+        return e[0] * (Xc(v[2]) - Xc(v[0])) + e[1] * (Yc(v[2]) - Yc(v[0]));
+    };
+
+    triangle.area = area();
+    if (triangle.area == 0) return;
+    if (triangle.area < 0) {
+        std::swap(v[1], v[2]);
+        std::swap(triangle.colors[1], triangle.colors[2]);
+        std::swap(triangle.texcoords[1], triangle.texcoords[2]);
+        triangle.area = -triangle.area;
+    }
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto a       = (i + 1) % 3;
+        const auto b       = (i + 2) % 3;
+        triangle.edges[i]  = edge(a, b);
+        const auto& e      = triangle.edges[i];
+
+        // top-left rule: pixel centers on an edge belong to the triangle
+        // only if the edge is a left edge or a horizontal top edge
+        const bool top_left = e[0] > 0 || (e[0] == 0 && e[1] > 0);
+        triangle.biases[i]  = top_left ? 0 : -1;
+    }
+
+    // pixels whose centers may lie inside
+    const auto xs = std::minmax({Xc(v[0]), Xc(v[1]), Xc(v[2])});
+    const auto ys = std::minmax({Yc(v[0]), Yc(v[1]), Yc(v[2])});
+    const auto half = SUBPIXEL / 2;
+    triangle.bounds = intersect(
+        {static_cast<long>(ceil_div(xs.first - half, SUBPIXEL)),
+         static_cast<long>(ceil_div(ys.first - half, SUBPIXEL)),
+         static_cast<long>(floor_div(xs.second - half, SUBPIXEL) + 1),
+         static_cast<long>(floor_div(ys.second - half, SUBPIXEL) + 1)},
+        {0,
+         0,
+         static_cast<long>(Wv(_dimensions)),
+         static_cast<long>(Hv(_dimensions))});
+    if (Lv(triangle.bounds) >= Rv(triangle.bounds) ||
+        Tv(triangle.bounds) >= Bv(triangle.bounds)) {
+        return;
+    }
+
+    _triangles.push_back(triangle);
+}
+
+void
+lsoft_renderer::rasterize_tile(const lrect<long>& tile)
+{
+    const auto stride = std::size_t{Wv(_dimensions)};
+
+    for (const auto& triangle : _triangles) {
+        const auto area = intersect(triangle.bounds, tile);
+        if (Lv(area) >= Rv(area) || Tv(area) >= Bv(area)) continue;
+
+        const auto& v     = triangle.vertices;
+        const auto& edges = triangle.edges;
+
+        // per pixel steps of the normalized edge functions, which are the
+        // barycentric weights
+        const auto inverse = 1.0 / static_cast<double>(triangle.area);
+        std::array<GLfloat, 3> step;
+        for (std::size_t i = 0; i < 3; ++i) {
+            step[i] = static_cast<GLfloat>(
+                static_cast<double>(Xc(edges[i]) * SUBPIXEL) * inverse);
+        }
+
+        const auto& colors = triangle.colors;
+        const auto  color_step =
+            load(colors[0]) * splat(step[0]) +
+            load(colors[1]) * splat(step[1]) +
+            load(colors[2]) * splat(step[2]);
+
+        const auto&            texcoords = triangle.texcoords;
+        std::array<GLfloat, 2> texcoord_step;
+        for (std::size_t c = 0; c < 2; ++c) {
+            texcoord_step[c] = texcoords[0][c] * step[0] +
+                               texcoords[1][c] * step[1] +
+                               texcoords[2][c] * step[2];
+        }
+
+        for (long y = Tv(area); y < Bv(area); ++y) {
+            // edge functions at the center of the first pixel of the row
+            const auto px = Lv(area) * SUBPIXEL + SUBPIXEL / 2;
+            const auto py = y * SUBPIXEL + SUBPIXEL / 2;
+
+            // narrow the row to the span inside all three edges, exactly,
+            // so thin diagonal triangles do not walk their bounding box
+            std::array<std::int64_t, 3> e;
+            std::int64_t                first = 0;
+            std::int64_t                last  = Rv(area) - Lv(area);
+            for (std::size_t i = 0; i < 3; ++i) {
+                const auto& a = v[(i + 1) % 3];
+                e[i]          = Xc(edges[i]) * (px - Xc(a)) +
+                       Yc(edges[i]) * (py - Yc(a));
+
+                // inside where e + k * dx + bias >= 0
+                const auto value = e[i] + triangle.biases[i];
+                const auto dx    = Xc(edges[i]) * SUBPIXEL;
+                if (dx > 0) {
+                    first = std::max(first, ceil_div(-value, dx));
+                } else if (dx < 0) {
+                    last = std::min(last, floor_div(value, -dx) + 1);
+                } else if (value < 0) {
+                    last = 0;
+                }
+            }
+            if (first >= last) continue;
+
+            // attributes at the first pixel of the span
+            std::array<GLfloat, 3> weight;
+            for (std::size_t i = 0; i < 3; ++i) {
+                weight[i] =
+                    static_cast<GLfloat>(static_cast<double>(e[i]) * inverse) +
+                    step[i] * static_cast<GLfloat>(first);
+            }
+            const auto color = load(colors[0]) * splat(weight[0]) +
+                               load(colors[1]) * splat(weight[1]) +
+                               load(colors[2]) * splat(weight[2]);
+
+            GLuint*    row   = &_pixels[static_cast<std::size_t>(y) * stride];
+            const long begin = Lv(area) + static_cast<long>(first);
+            const long end   = Lv(area) + static_cast<long>(last);
+
+            if (triangle.texture.empty()) {
+                colored_span(row, begin, end, color, color_step);
+                continue;
+            }
+
+            std::array<GLfloat, 2> texcoord;
+            for (std::size_t c = 0; c < 2; ++c) {
+                texcoord[c] = texcoords[0][c] * weight[0] +
+                              texcoords[1][c] * weight[1] +
+                              texcoords[2][c] * weight[2];
+            }
+            textured_span(
+                row,
+                begin,
+                end,
+                triangle.texture,
+                texcoord,
+                texcoord_step,
+                color,
+                color_step,
+                triangle.key,
+                triangle.key_mask);
+        }
+    }
+}
+
+std::size_t
+lsoft_renderer::tiles() const
+{
+    const auto width  = static_cast<long>(Wv(_dimensions));
+    const auto height = static_cast<long>(Hv(_dimensions));
+    return static_cast<std::size_t>(
+        (width + TILE_SIZE - 1) / TILE_SIZE *
+        ((height + TILE_SIZE - 1) / TILE_SIZE));
+}
+
+void
+lsoft_renderer::rasterize_tiles()
+{
+    const auto width   = static_cast<long>(Wv(_dimensions));
+    const auto height  = static_cast<long>(Hv(_dimensions));
+    const auto tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const auto count   = tiles();
+
+    for (auto t = _next_tile++; t < count; t = _next_tile++) {
+        const auto tx = static_cast<long>(t) % tiles_x * TILE_SIZE;
+        const auto ty = static_cast<long>(t) / tiles_x * TILE_SIZE;
+        rasterize_tile(
+            {tx,
+             ty,
+             std::min(tx + TILE_SIZE, width),
+             std::min(ty + TILE_SIZE, height)});
+    }
+}
+
+void
+lsoft_renderer::work()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _wake.wait(lock, [this]() { return _stop || _joined < _wanted; });
+        if (_stop) return;
+        ++_joined;
+
+        lock.unlock();
+        rasterize_tiles();
+        lock.lock();
+
+        if (--_busy == 0) _idle.notify_all();
+    }
+}
+
+void
+lsoft_renderer::flush()
+{
+    if (_triangles.empty()) return;
+
+    // workers take tiles until none are left, this thread too, so a frame
+    // of a few tiles wakes only the workers it has tiles for
+    const std::size_t wanted = std::min(_workers.size(), tiles() - 1);
+    _next_tile               = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _wanted = wanted;
+        _joined = 0;
+        _busy   = wanted;
+    }
+    for (std::size_t i = 0; i < wanted; ++i) { _wake.notify_one(); }
+    rasterize_tiles();
+
+    // the queue is read until the last worker is done
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _idle.wait(lock, [this]() { return _busy == 0; });
+    }
+
+    _triangles.clear();
+}
@@ -0,0 +1,182 @@
+#ifndef LSOFT_RENDERER_HPP
+#define LSOFT_RENDERER_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "lopengl.hpp"
+#include "lpixel_view.hpp"
+#include "lrect.hpp"
+#include "lrenderer.hpp"
+
+/*
+CPU rasterizer behind the lrenderer draw API, for the subset of GL the
+tutorials use: textured and color interpolated (Gouraud) quads, modulated by
+their vertex colors and blended with GL_SRC_ALPHA/GL_ONE_MINUS_SRC_ALPHA.
+Textures are sampled bilinearly with GL_REPEAT wrapping, matching the texture
+parameters ltexture sets, and color keyed like the sprite program.
+
+Quads are split into triangles like the GL backends split them. Edges are
+evaluated in fixed point with a top-left fill rule, so triangles sharing an
+edge cover each of its pixels once. Spans blend all four channels of a pixel
+at once with SSE2 where available.
+
+Draws are transformed when queued and rasterized by flush(): the framebuffer
+is split into tiles which worker threads render independently, every tile
+running through the queue in order, so the result does not depend on the
+number of threads. Workers live as long as the renderer and sleep between
+flushes, so a frame costs no thread creation.
+*/
+class lsoft_renderer : public lrenderer {
+public:
+    using lcolor = std::array<GLfloat, 4>;
+
+private:
+    struct ltriangle {
+        // pixels {left, top, right, bottom} the triangle may cover, exclusive
+        lrect<long> bounds = {0, 0, 0, 0};
+
+        // vertices in fixed point window coordinates, y pointing down, and
+        // edge functions opposite each vertex, positive inside
+        std::array<std::array<std::int64_t, 2>, 3> vertices = {};
+        std::array<std::array<std::int64_t, 2>, 3> edges    = {};
+        std::array<std::int64_t, 3>                biases   = {};
+        std::int64_t                               area     = {0};
+
+        // vertex attributes, texture coordinates in texels
+        std::array<lcolor, 3>                 colors    = {};
+        std::array<std::array<GLfloat, 2>, 3> texcoords = {};
+
+        // empty for plain colored triangles
+        lpixel_view<const GLuint> texture;
+
+        // texels equal to key under key_mask are keyed out
+        GLuint key      = {1};
+        GLuint key_mask = {0};
+    };
+
+    std::vector<GLuint>                    _pixels;
+    std::array<GLuint, 2>                  _dimensions = {0, 0};
+    std::vector<lpixel_view<const GLuint>> _textures;
+    std::vector<ltriangle>                 _triangles;
+
+    // workers besides the flushing thread, flush wakes as many as there
+    // are tiles for
+    std::mutex               _mutex;
+    std::condition_variable  _wake;
+    std::condition_variable  _idle;
+    std::size_t              _wanted    = {0};
+    std::size_t              _joined    = {0};
+    std::size_t              _busy      = {0};
+    bool                     _stop      = {false};
+    std::atomic<std::size_t> _next_tile = {0};
+    std::vector<std::thread> _workers;
+
+    // camera and color key of the draws queued next
+    lmatrix _projection = IDENTITY_MATRIX;
+    lmatrix _view       = IDENTITY_MATRIX;
+    lmatrix _transform  = IDENTITY_MATRIX;
+    GLuint  _key        = {1};
+    GLuint  _key_mask   = {0};
+
+    void add_triangle(
+        const lpixel_view<const GLuint>& texture,
+        const std::array<lvertex, 4>&    quad,
+        const std::array<int, 3>&        corners);
+
+    void rasterize_tile(const lrect<long>& tile);
+
+    // tiles covering the framebuffer
+    std::size_t tiles() const;
+
+    // takes tiles of the current flush until none are left
+    void rasterize_tiles();
+
+    // worker thread loop
+    void work();
+
+public:
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * creates a framebuffer of given dimensions cleared to black
+        * flush uses given number of threads, zero picks one per hardware
+          thread
+        * starts the worker threads
+        * the camera maps framebuffer pixels to clip space like the window
+          ortho_matrix, origin at the top left
+    side-effects: n/a
+    */
+    explicit lsoft_renderer(
+        std::array<GLuint, 2> dimensions, std::size_t threads = 0);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * stops and joins the worker threads
+    side-effects: n/a
+    */
+    ~lsoft_renderer() override;
+
+    lsoft_renderer(const lsoft_renderer&) = delete;
+    lsoft_renderer& operator=(const lsoft_renderer&) = delete;
+
+    /*
+    pre-conditions:
+        * pixels stay valid while draws using them are queued
+    post-conditions:
+        * returns texture name for draw and draw_sprite, never 0
+    side-effects: n/a
+    */
+    GLuint add_texture(const lpixel_view<const GLuint>&);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * drops queued draws and sets every pixel to given color
+    side-effects: n/a
+    */
+    void clear(const lcolor&);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns framebuffer, RGBA8 with red in the lowest byte, row 0 at
+          the top
+    side-effects: n/a
+    */
+    lpixel_view<const GLuint> pixels() const;
+
+    /*
+    Draws are transformed and keyed when queued, so camera and color key
+    changes do not rasterize the queue.
+    */
+    const char*    name() const override;
+    void           set_camera(const lmatrix&, const lmatrix&) override;
+    const lmatrix& projection() const override;
+    const lmatrix& view() const override;
+    bool           supports_color_key() const override;
+    void           set_color_key(
+                  std::array<GLuint, 2>,
+                  std::optional<std::array<GLubyte, 3>>,
+                  GLubyte = 0) override;
+    void draw(GLuint texture, const std::array<lvertex, 4>&) override;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * rasterizes all queued draws into the framebuffer
+    side-effects:
+        * wakes the worker threads and waits for them
+    */
+    void flush() override;
+};
+
+#endif // LSOFT_RENDERER_HPP
@@ -0,0 +1,275 @@
+#include "lsprite_program.hpp"
+
+#include <cstdio> // for std::sscanf
+#include <vector>
+
+#include <gsl/gsl_util> // for gsl::narrow
+
+#include "macro_helpers.hpp"
+
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
+namespace {
+
+// key modes of the keyed fragment shader
+constexpr GLint KEY_RGB  = 1;
+constexpr GLint KEY_RGBA = 2;
+
+constexpr const char* FIXED_VERTEX_SHADER = R"(
+#version 120
+
+varying vec2 texcoord;
+
+void main()
+{
+    gl_Position   = ftransform();
+    gl_FrontColor = gl_Color;
+    texcoord      = gl_MultiTexCoord0.xy;
+}
+)";
+
+// the keyed variant is compiled with COLOR_KEY defined
+constexpr const char* FRAGMENT_SHADER = R"(
+
+uniform sampler2D texture_unit;
+uniform vec2      texture_size;
+uniform int       key_mode; // 1 compares RGB, 2 RGBA
+uniform vec4      color_key; // 0..255
+uniform vec4      tint;
+
+varying vec2 texcoord;
+
+// keyed texels turn transparent white, as with keying on the CPU
+vec4 keyed_texel(vec2 position)
+{
+    vec4 texel = texture2D(texture_unit, position);
+    vec4 bytes = floor(texel * 255.0 + 0.5);
+    if (all(equal(bytes.rgb, color_key.rgb)) &&
+        (key_mode == 1 || bytes.a == color_key.a)) {
+        return vec4(1.0, 1.0, 1.0, 0.0);
+    }
+    return texel;
+}
+
+void main()
+{
+#ifdef COLOR_KEY
+    // key the four texels before filtering, otherwise the key color bleeds
+    // into the edges; sampling at texel centers returns texels unfiltered
+    vec2 position = texcoord * texture_size - 0.5;
+    vec2 weight   = fract(position);
+    vec2 base     = (floor(position) + 0.5) / texture_size;
+    vec2 step     = 1.0 / texture_size;
+
+    vec4 texel = mix(
+        mix(keyed_texel(base),
+            keyed_texel(base + vec2(step.x, 0.0)),
+            weight.x),
+        mix(keyed_texel(base + vec2(0.0, step.y)),
+            keyed_texel(base + step),
+            weight.x),
+        weight.y);
+#else
+    vec4 texel = texture2D(texture_unit, texcoord);
+#endif
+
+    gl_FragColor = texel * gl_Color * tint;
+}
+)";
+
+bool
+glsl_120_supported()
+{
+    auto version = reinterpret_cast<const char*>(
+        glGetString(GL_SHADING_LANGUAGE_VERSION));
+    int major = 0;
+    int minor = 0;
+    return version && std::sscanf(version, "%d.%d", &major, &minor) == 2 &&
+           (major > 1 || (major == 1 && minor >= 20));
+}
+
+GLuint
+compile_shader(GLenum type, std::initializer_list<const char*> sources)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(
+        shader, gsl::narrow<GLsizei>(sources.size()), sources.begin(), nullptr);
+    glCompileShader(shader);
+
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::vector<GLchar> log(gsl::narrow<std::size_t>(length) + 1);
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+
+        std::cerr << "unable to compile "
+                  << (type == GL_VERTEX_SHADER ? "vertex" : "fragment")
+                  << " shader:\n"
+                  << log.data() << '\n';
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+} // namespace
+
+lsprite_program::~lsprite_program()
+{
+    free_program();
+}
+
+bool
+lsprite_program::load(
+    const char*                        vertex_shader_source,
+    std::initializer_list<const char*> attributes)
+{
+    free_program();
+
+    if (!glsl_120_supported()) {
+        std::cerr << "GLSL 1.20 is not supported\n";
+        return false;
+    }
+
+    GLuint vertex_shader = compile_shader(
+        GL_VERTEX_SHADER,
+        {vertex_shader_source ? vertex_shader_source : FIXED_VERTEX_SHADER});
+    if (!vertex_shader) return false;
+
+    for (std::size_t keyed = 0; keyed < _variants.size(); ++keyed) {
+        GLuint fragment_shader = compile_shader(
+            GL_FRAGMENT_SHADER,
+            {"#version 120\n",
+             keyed ? "#define COLOR_KEY\n" : "",
+             FRAGMENT_SHADER});
+        if (!fragment_shader) break;
+
+        auto& variant      = _variants[keyed];
+        variant.program_id = glCreateProgram();
+        glAttachShader(variant.program_id, vertex_shader);
+        glAttachShader(variant.program_id, fragment_shader);
+
+        GLuint location = 0;
+        for (auto attribute : attributes) {
+            glBindAttribLocation(variant.program_id, location++, attribute);
+        }
+        glLinkProgram(variant.program_id);
+
+        // shader is kept alive by the program
+        glDeleteShader(fragment_shader);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(variant.program_id, GL_LINK_STATUS, &linked);
+        if (linked != GL_TRUE) {
+            GLint length = 0;
+            glGetProgramiv(variant.program_id, GL_INFO_LOG_LENGTH, &length);
+            std::vector<GLchar> log(gsl::narrow<std::size_t>(length) + 1);
+            glGetProgramInfoLog(
+                variant.program_id, length, nullptr, log.data());
+
+            std::cerr << "unable to link sprite program:\n"
+                      << log.data() << '\n';
+            break;
+        }
+
+        variant.texture_size_location =
+            glGetUniformLocation(variant.program_id, "texture_size");
+        variant.key_mode_location =
+            glGetUniformLocation(variant.program_id, "key_mode");
+        variant.color_key_location =
+            glGetUniformLocation(variant.program_id, "color_key");
+        variant.tint_location =
+            glGetUniformLocation(variant.program_id, "tint");
+    }
+
+    glDeleteShader(vertex_shader);
+
+    // both variants or none
+    if (!_variants[0].program_id || !_variants[1].program_id) {
+        free_program();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+lsprite_program::is_loaded() const
+{
+    return _variants[0].program_id != 0;
+}
+
+std::array<GLuint, 2>
+lsprite_program::get_program_ids() const
+{
+    return {_variants[0].program_id, _variants[1].program_id};
+}
+
+void
+lsprite_program::free_program()
+{
+    for (auto& variant : _variants) {
+        if (variant.program_id != 0) glDeleteProgram(variant.program_id);
+        variant = {};
+    }
+}
+
+void
+lsprite_program::use(std::size_t variant)
+{
+    _current = variant;
+    glUseProgram(_variants[_current].program_id);
+    glUniform4fv(_variants[_current].tint_location, 1, _tint.data());
+}
+
+void
+lsprite_program::bind()
+{
+    _tint = {1.f, 1.f, 1.f, 1.f};
+    use(0);
+}
+
+void
+lsprite_program::unbind()
+{
+    glUseProgram(0);
+}
+
+void
+lsprite_program::set_color_key(
+    std::array<GLuint, 2>                 tex_dims,
+    std::optional<std::array<GLubyte, 3>> rgb,
+    GLubyte                               a)
+{
+    if (!rgb) {
+        if (_current != 0) use(0);
+        return;
+    }
+
+    if (_current != 1) use(1);
+
+    const auto& variant = _variants[_current];
+    glUniform1i(variant.key_mode_location, a == 0 ? KEY_RGB : KEY_RGBA);
+    glUniform4f(variant.color_key_location, Rc(*rgb), Gc(*rgb), Bc(*rgb), a);
+    set_texture_size(tex_dims);
+}
+
+void
+lsprite_program::set_tint(const std::array<GLfloat, 4>& tint)
+{
+    _tint = tint;
+    glUniform4fv(_variants[_current].tint_location, 1, _tint.data());
+}
+
+void
+lsprite_program::set_texture_size(std::array<GLuint, 2> tex_dims)
+{
+    glUniform2f(
+        _variants[_current].texture_size_location,
+        gsl::narrow<GLfloat>(Wv(tex_dims)),
+        gsl::narrow<GLfloat>(Hv(tex_dims)));
+}
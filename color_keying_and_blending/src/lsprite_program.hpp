@@ -0,0 +1,148 @@
+#ifndef LSPRITE_PROGRAM_HPP
+#define LSPRITE_PROGRAM_HPP
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+
+#include "lopengl.hpp"
+
+/*
+GLSL 1.20 program for textured sprites. Per fragment it drops texels matching
+a color key, then multiplies by the current color and a tint, so keyed images
+can be uploaded straight from the decoder instead of being rewritten on the
+CPU. By default vertices go through the fixed-function matrices and
+attributes and the program replaces only the texturing and coloring; a vertex
+shader may be given instead.
+*/
+class lsprite_program {
+    // compiled variant of the program
+    struct lvariant {
+        // program name
+        GLuint program_id = {0};
+
+        // uniform locations
+        GLint texture_size_location = {-1};
+        GLint key_mode_location     = {-1};
+        GLint color_key_location    = {-1};
+        GLint tint_location         = {-1};
+    };
+
+    // without and with color key, keying costs four texture reads and a
+    // branch on every fragment, sprites without a key should not pay it
+    std::array<lvariant, 2> _variants;
+
+    // variant in use while bound and its tint
+    std::size_t            _current = {0};
+    std::array<GLfloat, 4> _tint    = {1.f, 1.f, 1.f, 1.f};
+
+    // switches to given variant
+    void use(std::size_t);
+
+public:
+    lsprite_program() = default;
+    ~lsprite_program();
+
+    lsprite_program(const lsprite_program&) = delete;
+    lsprite_program& operator=(const lsprite_program&) = delete;
+
+    /*
+    pre-conditions:
+        * a valid OpenGL context
+        * given vertex shader is GLSL 1.20, writes gl_FrontColor and a vec2
+          texcoord varying
+    post-conditions:
+        * compiles and links the program, with the fixed-function vertex
+          stage if no vertex shader is given
+        * binds given vertex attributes to locations 0, 1, ... in order
+        * returns false if GLSL 1.20 is not supported or the program does not
+          compile or link
+        * reports error to console if the program could not be created
+    side-effects: n/a
+    */
+    bool load(
+        const char*                        vertex_shader = nullptr,
+        std::initializer_list<const char*> attributes    = {});
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns true if the program was loaded
+    side-effects: n/a
+    */
+    bool is_loaded() const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns program names/ids of the variants without and with color
+          key, 0 if not loaded
+    side-effects: n/a
+    */
+    std::array<GLuint, 2> get_program_ids() const;
+
+    /*
+    pre-conditions: valid GL context
+    post-conditions:
+        * deletes program if it exists
+    side-effects: n/a
+    */
+    void free_program();
+
+    /*
+    pre-conditions:
+        * loaded program
+    post-conditions:
+        * makes the program current with no color key and a white tint
+    side-effects:
+        * changes the current program
+    */
+    void bind();
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * restores the fixed-function pipeline
+    side-effects:
+        * changes the current program
+    */
+    void unbind();
+
+    /*
+    pre-conditions:
+        * bound program
+        * texture dimensions of the sprite about to be drawn
+    post-conditions:
+        * texels with given RGBA value become transparent, if A = 0 only RGB
+          components are compared, same rule as
+          ltexture::load_from_file_with_color_key
+        * a null color key turns keying off
+    side-effects: n/a
+    */
+    void set_color_key(
+        std::array<GLuint, 2>,
+        std::optional<std::array<GLubyte, 3>> rgb,
+        GLubyte                               a = 0);
+
+    /*
+    pre-conditions:
+        * bound program
+    post-conditions:
+        * multiplies fragments by given RGBA tint, alpha modulates
+          transparency
+    side-effects: n/a
+    */
+    void set_tint(const std::array<GLfloat, 4>&);
+
+    /*
+    pre-conditions:
+        * bound program
+    post-conditions:
+        * sets the texture_size uniform of the current variant, for vertex
+          shaders which turn texel coordinates into texture coordinates
+    side-effects: n/a
+    */
+    void set_texture_size(std::array<GLuint, 2>);
+};
+
+#endif // LSPRITE_PROGRAM_HPP
@@ -1,36 +1,69 @@
 #include "ltexture.hpp"
 
-#include <cstring> // for std::memcpy
-#include <memory>  // for std::align
-#include <numeric> // for std::accumulate
+#include <vector>
 
-#include <IL/il.h>
-#include <IL/ilu.h> // for ILU_PLACEMENT and ILU_UPPER_LEFT etc.
-
-#include <gsl/gsl_util> // for gsl::finally and gsl::narrow
+#include <gsl/gsl_util> // for gsl::narrow
 
+#include "limage_decoder.hpp"
 #include "macro_helpers.hpp"
 
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
 namespace {
 
-template <
-    typename Numeric,
-    typename = std::enable_if_t<std::is_integral_v<Numeric>>>
-Numeric
-align(Numeric num)
+bool
+framebuffer_supported()
+{
+    // core since OpenGL 3.0, otherwise from ARB_framebuffer_object
+    return gl_supported(3, 0, "GL_ARB_framebuffer_object");
+}
+
+bool
+format_supported(lpixel_format format)
+{
+    switch (format) {
+    case PIXEL_FORMAT_R8:
+        // core since OpenGL 3.0, otherwise from ARB_texture_rg
+        return gl_supported(3, 0, "GL_ARB_texture_rg");
+    case PIXEL_FORMAT_RG8:
+        // the second channel is swizzled into alpha, swizzles are core since
+        // OpenGL 3.3, otherwise from ARB_texture_swizzle
+        return gl_supported(3, 0, "GL_ARB_texture_rg") &&
+               gl_supported(3, 3, "GL_ARB_texture_swizzle");
+    case PIXEL_FORMAT_RGBA16F:
+        // core since OpenGL 3.0, otherwise from ARB_texture_float
+        return gl_supported(3, 0, "GL_ARB_texture_float");
+    case PIXEL_FORMAT_RGBA8:
+    case PIXEL_FORMAT_RGB565:
+        // packed pixels are core since OpenGL 1.2
+        break;
+    }
+    return true;
+}
+
+GLint
+internal_format(lpixel_format format)
 {
-    const auto bits_in_type =
-        static_cast<Numeric>(sizeof(Numeric) * 8 /* bits */);
-    return num + (bits_in_type - (num + bits_in_type) % bits_in_type);
+    // without the sized format GL may store RGB565 in more than 16 bits,
+    // core since OpenGL 4.1, otherwise from ARB_ES2_compatibility
+    if (format == PIXEL_FORMAT_RGB565 &&
+        gl_supported(4, 1, "GL_ARB_ES2_compatibility")) {
+        return GL_RGB565;
+    }
+    return pixel_format_info(format).internal_format;
 }
 
-template <
-    typename Numeric,
-    typename = std::enable_if_t<std::is_integral_v<Numeric>>>
-std::array<Numeric, 2>
-align(const std::array<Numeric, 2>& unaligned)
+// queried once, it is fixed for the context
+GLint
+max_texture_size()
 {
-    return {align<Numeric>(Wv(unaligned)), align<Numeric>(Hv(unaligned))};
+    static const GLint size = []() {
+        GLint value = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &value);
+        return value;
+    }();
+    return size;
 }
 
 } // namespace
@@ -52,14 +85,29 @@ ltexture::lock()
     std::cout << __FUNCTION__ << '\n';
 
     // allocate memory for texture data
-    GLuint size = Wv(_dimensions) * Hv(_dimensions);
-    _pixels     = std::make_unique<GLuint[]>(size);
+    _pixels =
+        make_pixel_buffer(std::size_t{Wv(_dimensions)} * Hv(_dimensions));
 
     // set current texture
     glBindTexture(GL_TEXTURE_2D, _texture_id);
 
-    // get pixels
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, _pixels.get());
+    // get pixels, other formats are read as stored so they convert the same
+    // way as on upload
+    if (_format == PIXEL_FORMAT_RGBA8) {
+        glGetTexImage(
+            GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, _pixels.get());
+    } else {
+        const auto& info  = pixel_format_info(_format);
+        const auto  count = std::size_t{Wv(_dimensions)} * Hv(_dimensions);
+        std::vector<GLubyte> stored(count * info.bytes_per_pixel);
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D, 0, info.format, info.type, stored.data());
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        convert_pixels(
+            stored.data(), _format, _pixels.get(), PIXEL_FORMAT_RGBA8, count);
+    }
 
     // unbind texture
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -78,7 +126,23 @@ ltexture::unlock()
     // set current texture
     glBindTexture(GL_TEXTURE_2D, _texture_id);
 
-    // update texture
+    // update texture, converting back to the storage format
+    const auto&          info  = pixel_format_info(_format);
+    const auto           count = std::size_t{Wv(_dimensions)} * Hv(_dimensions);
+    std::vector<GLubyte> converted;
+    const void*          pixels = _pixels.get();
+    if (_format != PIXEL_FORMAT_RGBA8) {
+        converted.resize(count * info.bytes_per_pixel);
+        convert_pixels(
+            _pixels.get(),
+            PIXEL_FORMAT_RGBA8,
+            converted.data(),
+            _format,
+            count);
+        pixels = converted.data();
+    }
+
+    if (info.bytes_per_pixel % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glTexSubImage2D(
         GL_TEXTURE_2D,
         0,
@@ -86,9 +150,10 @@ ltexture::unlock()
         0,
         Wv(_dimensions),
         Hv(_dimensions),
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
-        _pixels.get());
+        info.format,
+        info.type,
+        pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
     // delete pixels
     _pixels.reset();
@@ -107,6 +172,12 @@ ltexture::data()
     return _pixels.get();
 }
 
+lpixel_view<GLuint>
+ltexture::pixels()
+{
+    return {_pixels.get(), _dimensions};
+}
+
 GLuint
 ltexture::pixel(const std::array<GLuint, 2>& point) const
 {
@@ -120,13 +191,18 @@ ltexture::set_pixel(const std::array<GLuint, 2>& point, GLuint value)
 }
 
 bool
-ltexture::load_from_pixels32(GLuint* pixels, std::array<GLuint, 2> tex_dims)
+ltexture::generate(const void* pixels)
 {
-    // free texture if it exists
-    free_texture();
-
-    // get texture dimensions
-    _dimensions = std::move(tex_dims);
+    const auto& info = pixel_format_info(_format);
+
+    // GL would only flag an error and allocate no storage
+    const auto limit = static_cast<GLuint>(max_texture_size());
+    if (Wv(_dimensions) > limit || Hv(_dimensions) > limit) {
+        std::cerr << "unable to create " << Wv(_dimensions) << 'x'
+                  << Hv(_dimensions) << ' ' << info.name
+                  << " texture, the limit is " << limit << '\n';
+        return false;
+    }
 
     // generate texture id
     glGenTextures(1, &_texture_id);
@@ -134,18 +210,24 @@ ltexture::load_from_pixels32(GLuint* pixels, std::array<GLuint, 2> tex_dims)
     // bind texture
     glBindTexture(GL_TEXTURE_2D, _texture_id);
 
+    // rows of 1 and 2 byte formats are not padded to 4 bytes
+    if (info.bytes_per_pixel % 4 != 0) glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     // generate texture
     glTexImage2D(
         GL_TEXTURE_2D,
         0,
-        GL_RGBA,
+        internal_format(_format),
         Wv(_dimensions),
         Hv(_dimensions),
         0,
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
+        info.format,
+        info.type,
         pixels);
 
+    // restore default alignment
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
     /* Set texture parameters:
     Here we're setting the GL_TEXTURE_MAG_FILTER and GL_TEXTURE_MIN_FILTER which
     control how the texture is shown when it is magnified and minified
@@ -155,23 +237,71 @@ ltexture::load_from_pixels32(GLuint* pixels, std::array<GLuint, 2> tex_dims)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-    // unbind texture
+    // RG8 holds red and alpha, sample it as (R, 0, 0, G)
+    if (_format == PIXEL_FORMAT_RG8) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_GREEN);
+    }
+
+    // size of the storage format, reading back what GL chose would stall
+    _memory_size =
+        std::size_t{Wv(_dimensions)} * Hv(_dimensions) * info.bytes_per_pixel;
+
+    // unbind texture, errors are reported by the next gl_errors_flush
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    // check for error
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cerr << "error loading texture from "
-                  << static_cast<const void*>(pixels) << gluErrorString(error)
-                  << '\n';
-        return false;
+    return true;
+}
+
+bool
+ltexture::load_from_pixels(
+    const void* pixels, std::array<GLuint, 2> tex_dims, lpixel_format format)
+{
+    // free texture if it exists
+    free_texture();
+
+    // fall back to RGBA8 for formats GL lacks
+    if (!format_supported(format)) {
+        std::cerr << pixel_format_info(format).name
+                  << " textures are not supported, using RGBA8\n";
+
+        if (!pixels) {
+            return load_from_pixels(nullptr, tex_dims, PIXEL_FORMAT_RGBA8);
+        }
+
+        std::vector<GLuint> rgba(std::size_t{Wv(tex_dims)} * Hv(tex_dims));
+        convert_pixels(
+            pixels, format, rgba.data(), PIXEL_FORMAT_RGBA8, rgba.size());
+        return load_from_pixels(rgba.data(), tex_dims, PIXEL_FORMAT_RGBA8);
     }
 
-    return true;
+    // get texture dimensions and format
+    _dimensions = std::move(tex_dims);
+    _format     = format;
+
+    return generate(pixels);
 }
 
 bool
-ltexture::load_from_pixels32()
+ltexture::load_from_pixels32(
+    GLuint* pixels, std::array<GLuint, 2> tex_dims, lpixel_format format)
+{
+    // matching format or empty texture, nothing to convert
+    if (format == PIXEL_FORMAT_RGBA8 || !pixels) {
+        return load_from_pixels(pixels, tex_dims, format);
+    }
+
+    const auto count = std::size_t{Wv(tex_dims)} * Hv(tex_dims);
+    std::vector<GLubyte> converted(
+        count * pixel_format_info(format).bytes_per_pixel);
+    convert_pixels(
+        pixels, PIXEL_FORMAT_RGBA8, converted.data(), format, count);
+
+    return load_from_pixels(converted.data(), tex_dims, format);
+}
+
+bool
+ltexture::load_from_pixels32(lpixel_format format)
 {
     // there is loaded pixels
     if (_texture_id || !_pixels) {
@@ -186,92 +316,27 @@ ltexture::load_from_pixels32()
         return false;
     }
 
-    // generate texture id
-    glGenTextures(1, &_texture_id);
-
-    // bind texture id
-    glBindTexture(GL_TEXTURE_2D, _texture_id);
-
-    // generate texture
-    glTexImage2D(
-        GL_TEXTURE_2D,
-        0,
-        GL_RGBA,
-        Wv(_dimensions),
-        Hv(_dimensions),
-        0,
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
-        _pixels.get());
-
-    // set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    // keep pixels across the upload, it frees member data first
+    auto pixels = std::move(_pixels);
+    auto dims   = _dimensions;
 
-    // unbind texture
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    // check for error
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cerr
-            << "error loading texture from pixels: " << gluErrorString(error)
-            << '\n';
+    if (!load_from_pixels32(pixels.get(), dims, format)) {
+        _pixels     = std::move(pixels);
+        _dimensions = dims;
         return false;
-    } else {
-        // release pixels
-        _pixels.reset();
     }
 
     return true;
 }
 
 bool
-ltexture::load_from_file(std::string_view path)
+ltexture::load_from_file(std::string_view path, lpixel_format format)
 {
-    // generate and set current image id
-    ILuint img_id = 0;
-    ilGenImages(1, &img_id);
-    ilBindImage(img_id);
-
-    // load image
-    ILboolean success = ilLoadImage(path.data());
-    auto      _       = gsl::finally([success, &img_id]() {
-        if (success) {
-            // delete file from memory
-            ilDeleteImages(1, &img_id);
-        }
-    });
-
-    bool texture_loaded = false;
-    do {
-        if (success != IL_TRUE) break;
-
-        // convert image to RGBA
-        success = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
-        if (success != IL_TRUE) break;
-
-        auto img_dims =
-            std::array{gsl::narrow_cast<GLuint>(ilGetInteger(IL_IMAGE_WIDTH)),
-                       gsl::narrow_cast<GLuint>(ilGetInteger(IL_IMAGE_HEIGHT))};
-
-        auto tex_dims = align(img_dims);
-
-        // texture is the wrong size
-        if (tex_dims != img_dims) {
-            // place image at upper left
-            iluImageParameter(ILU_PLACEMENT, ILU_UPPER_LEFT);
-
-            // resize image
-            iluEnlargeCanvas(
-                gsl::narrow<int>(Wv(img_dims)),
-                gsl::narrow<int>(Hv(img_dims)),
-                1);
-        }
-
-        texture_loaded = load_from_pixels32(
-            reinterpret_cast<GLuint*>(ilGetData()), std::move(img_dims));
-    } while (false);
+    // decode image
+    limage image;
+    bool   texture_loaded =
+        decode_image(path, image) &&
+        load_from_pixels32(image.pixels.get(), image.dimensions, format);
 
     // report error
     if (!texture_loaded) { std::cerr << "unable to load " << path << '\n'; }
@@ -279,96 +344,52 @@ ltexture::load_from_file(std::string_view path)
     return texture_loaded;
 }
 
+bool
+ltexture::load_from_asset(const lasset& asset)
+{
+    // pack payloads are in their upload format, hand them to GL as they are
+    if (!load_from_pixels(asset.pixels, asset.dimensions, asset.format)) {
+        std::cerr << "unable to load asset " << asset.name << '\n';
+        return false;
+    }
+
+    return true;
+}
+
 bool
 ltexture::load_pixels_from_file(std::string_view path)
 {
     // deallocate texture data
     free_texture();
 
-    // generate and set current image id
-    ILuint img_id = 0;
-    ilGenImages(1, &img_id);
-    ilBindImage(img_id);
-
-    // load image
-    ILboolean success = ilLoadImage(path.data());
-    auto      _       = gsl::finally([success, &img_id]() {
-        if (success) {
-            // delete file from memory
-            ilDeleteImages(1, &img_id);
-        }
-    });
-
-    bool pixels_loaded = false;
-    do {
-        if (success != IL_TRUE) break;
-
-        // convert image to RGBA
-        success = ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE);
-        if (success != IL_TRUE) break;
-
-        // initialize dimensions
-        auto img_dims =
-            std::array{gsl::narrow<GLuint>(ilGetInteger(IL_IMAGE_WIDTH)),
-                       gsl::narrow<GLuint>(ilGetInteger(IL_IMAGE_HEIGHT))};
-
-        // calculate required texture dimensions
-        auto tex_dims = align(img_dims);
-
-        // texture is the wrong size
-        if (tex_dims != img_dims) {
-            // place image at upper left
-            iluImageParameter(ILU_PLACEMENT, ILU_UPPER_LEFT);
-
-            // resize image
-            iluEnlargeCanvas(
-                gsl::narrow<int>(Wv(img_dims)),
-                gsl::narrow<int>(Hv(img_dims)),
-                1);
-        }
-
-        // allocate memory for texture data
-        GLuint size = std::accumulate(
-            std::begin(img_dims),
-            std::end(img_dims),
-            1,
-            std::multiplies<GLuint>());
-        _pixels = std::make_unique<GLuint[]>(size);
-
-        // get image dimensions
-        _dimensions = img_dims;
-
-        // copy pixels
-        std::memcpy(_pixels.get(), ilGetData(), size * sizeof(GLuint));
-        pixels_loaded = true;
-    } while (false);
-
-    // delete file from memory
-    ilDeleteImages(1, &img_id);
+    // decode image
+    limage image;
+    if (!decode_image(path, image)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
 
-    // report error
-    if (!pixels_loaded) { std::cerr << "unable to load " << path << '\n'; }
+    // take over decoded pixels
+    _pixels     = std::move(image.pixels);
+    _dimensions = image.dimensions;
 
-    return pixels_loaded;
+    return true;
 }
 
 bool
 ltexture::load_from_file_with_color_key(
-    std::string_view path, std::array<GLubyte, 3> rgb, GLubyte a)
+    std::string_view       path,
+    std::array<GLubyte, 3> rgb,
+    GLubyte                a,
+    lpixel_format          format)
 {
     // load pixels
     if (!load_pixels_from_file(path)) { return false; }
 
     // go through pixels
-    GLuint size = std::accumulate(
-        std::begin(_dimensions),
-        std::end(_dimensions),
-        1,
-        std::multiplies<GLuint>());
-
-    for (size_t i = 0; i < size; ++i) {
+    transform(pixels(), [rgb, a](GLuint pixel) {
         // get pixel colors
-        GLubyte* colors = reinterpret_cast<GLubyte*>(&_pixels[i]);
+        GLubyte* colors = reinterpret_cast<GLubyte*>(&pixel);
 
         // color matches
         if (Rc(colors) == Rc(rgb) && Gc(colors) == Gc(rgb) &&
@@ -379,15 +400,111 @@ ltexture::load_from_file_with_color_key(
             Bc(colors) = 0xff;
             Ac(colors) = 0;
         }
-    }
+
+        return pixel;
+    });
 
     // create texture
-    return load_from_pixels32();
+    return load_from_pixels32(format);
+}
+
+bool
+ltexture::create_render_target(std::array<GLuint, 2> tex_dims)
+{
+    // free texture if it exists
+    free_texture();
+
+    if (!framebuffer_supported()) {
+        std::cerr << "framebuffer objects are not supported\n";
+        return false;
+    }
+
+    // create empty texture
+    if (!load_from_pixels(nullptr, tex_dims, PIXEL_FORMAT_RGBA8)) return false;
+
+    // attach texture to a new framebuffer
+    glGenFramebuffers(1, &_framebuffer_id);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer_id);
+    glFramebufferTexture2D(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture_id, 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "incomplete render target framebuffer: " << status
+                  << '\n';
+        free_texture();
+        return false;
+    }
+
+    return true;
+}
+
+bool
+ltexture::begin_render(lrenderer& renderer)
+{
+    if (!_framebuffer_id) return false;
+
+    // queued quads belong to the previous target
+    renderer.flush();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer_id);
+
+    // cover the texture
+    glGetIntegerv(GL_VIEWPORT, _saved_viewport.data());
+    glViewport(
+        0,
+        0,
+        gsl::narrow<GLsizei>(Wv(_dimensions)),
+        gsl::narrow<GLsizei>(Hv(_dimensions)));
+
+    /* Framebuffer row 0 is at the bottom, but it is texture row 0 which
+    ltexture::render shows at the top. Flipping the projection keeps y growing
+    downwards on screen, like the projection used for the window. */
+    _saved_projection = renderer.projection();
+    _saved_view       = renderer.view();
+    renderer.set_camera(
+        ortho_matrix(
+            0.f,
+            gsl::narrow<GLfloat>(Wv(_dimensions)),
+            0.f,
+            gsl::narrow<GLfloat>(Hv(_dimensions))),
+        IDENTITY_MATRIX);
+
+    return true;
+}
+
+void
+ltexture::end_render(lrenderer& renderer)
+{
+    // submits the quads of the target before switching back
+    renderer.set_camera(_saved_projection, _saved_view);
+
+    glViewport(
+        Xc(_saved_viewport),
+        Yc(_saved_viewport),
+        Rv(_saved_viewport),
+        Bv(_saved_viewport));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool
+ltexture::is_render_target() const
+{
+    return _framebuffer_id != 0;
 }
 
 void
 ltexture::free_texture()
 {
+    // delete framebuffer
+    if (_framebuffer_id != 0) {
+        glDeleteFramebuffers(1, &_framebuffer_id);
+        _framebuffer_id = 0;
+    }
+
     // delete texture
     if (_texture_id != 0) {
         glDeleteTextures(1, &_texture_id);
@@ -396,64 +513,40 @@ ltexture::free_texture()
 
     _pixels.reset();
 
-    _dimensions = {0, 0};
+    _dimensions  = {0, 0};
+    _format      = PIXEL_FORMAT_RGBA8;
+    _memory_size = 0;
 }
 
-void ltexture::render(std::array<GLfloat, 2> point, std::optional<lfrect> clip)
+void
+ltexture::render(
+    lrenderer&                    renderer,
+    std::array<GLfloat, 2>        point,
+    std::optional<lfrect>         clip,
+    const std::array<GLfloat, 4>& color,
+    GLfloat                       rotation)
 {
     // if the texture exists
     if (!_texture_id) return;
 
-    // remove any previous transformations
-    glLoadIdentity();
-
-    // texture coordinates
-    auto texcoord = lfrect{
-        0.f, // left
-        0.f, // top
-        1.f, // right
-        1.f  // bottom
-    };
-
-    // vertex coordinates
-    auto quad_size = std::array{gsl::narrow<GLfloat>(Wv(_dimensions)),
-                                gsl::narrow<GLfloat>(Hv(_dimensions))};
-
-    // handle clipping
-    if (clip) {
-        auto& _clip = *clip; // this (clip) thing is std::optional, thus deref
-
-        // texture coordinates
-        Lv(texcoord) = Xc(_clip) / gsl::narrow<GLfloat>(Wv(_dimensions));
-        Tv(texcoord) = Tv(_clip) / gsl::narrow<GLfloat>(Hv(_dimensions));
-        Rv(texcoord) =
-            (Xc(_clip) + Rv(_clip)) / gsl::narrow<GLfloat>(Wv(_dimensions));
-        Bv(texcoord) =
-            (Tv(_clip) + Bv(_clip)) / gsl::narrow<GLfloat>(Hv(_dimensions));
-
-        quad_size = {Rv(_clip), Bv(_clip)};
-    }
-
-    // move to rendering point
-    glTranslatef(Xc(point), Yc(point), 0.f);
-
-    // set texture id
-    glBindTexture(GL_TEXTURE_2D, _texture_id);
-
-    // render texture quad
-    glBegin(GL_QUADS);
-    glTexCoord2f(Lv(texcoord), Tv(texcoord));
-    glVertex2f(0.f, 0.f);
-    glTexCoord2f(Rv(texcoord), Tv(texcoord));
-    glVertex2f(Wv(quad_size), 0.f);
-    glTexCoord2f(Rv(texcoord), Bv(texcoord));
-    glVertex2f(Wv(quad_size), Hv(quad_size));
-    glTexCoord2f(Lv(texcoord), Bv(texcoord));
-    glVertex2f(0.f, Hv(quad_size));
-    glEnd();
+    // full texture unless clipped
+    const auto full = lfrect{0.f,
+                             0.f,
+                             gsl::narrow<GLfloat>(Wv(_dimensions)),
+                             gsl::narrow<GLfloat>(Hv(_dimensions))};
+
+    lsprite sprite;
+    sprite.x        = Xc(point);
+    sprite.y        = Yc(point);
+    sprite.clip     = clip.value_or(full);
+    sprite.rotation = rotation;
+    sprite.tint     = pack_color(color);
+
+    // an instance where the renderer supports them, a quad otherwise
+    renderer.draw_sprite(_texture_id, _dimensions, sprite);
 }
 
-inline GLuint
+GLuint
 ltexture::get_texture_id() const
 {
     return _texture_id;
@@ -464,3 +557,15 @@ ltexture::get_dimensions() const
 {
     return _dimensions;
 }
+
+lpixel_format
+ltexture::get_format() const
+{
+    return _format;
+}
+
+std::size_t
+ltexture::memory_size() const
+{
+    return _memory_size;
+}
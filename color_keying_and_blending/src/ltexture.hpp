@@ -5,19 +5,42 @@
 #include <memory>
 #include <optional>
 
+#include "lasset_pack.hpp"
 #include "lopengl.hpp"
+#include "lpixel_allocator.hpp"
+#include "lpixel_format.hpp"
+#include "lpixel_view.hpp"
 #include "lrect.hpp"
+#include "lrenderer.hpp"
 
 class ltexture {
     // texture name
     GLuint _texture_id = {0};
 
-    // texture data
-    std::unique_ptr<GLuint[]> _pixels;
+    // texture data, from the current pixel allocator
+    lpixel_buffer _pixels;
 
     // texture dimensions
     std::array<GLuint, 2> _dimensions = {0, 0};
 
+    // framebuffer name, non-zero for render targets
+    GLuint _framebuffer_id = {0};
+
+    // storage format of the texture, member pixels are always RGBA8
+    lpixel_format _format = {PIXEL_FORMAT_RGBA8};
+
+    // bytes of the texture storage format
+    std::size_t _memory_size = {0};
+
+    // renderer state replaced by begin_render, restored by end_render
+    std::array<GLint, 4> _saved_viewport   = {0, 0, 0, 0};
+    lmatrix              _saved_projection = IDENTITY_MATRIX;
+    lmatrix              _saved_view       = IDENTITY_MATRIX;
+
+    // creates texture from pixels of member format, returns false if it is
+    // above the size limit, GL errors are left to the next gl_errors_flush
+    bool generate(const void*);
+
 public:
     ltexture();
     ~ltexture();
@@ -26,7 +49,7 @@ public:
     pre-conditions:
         * an existing unlocked texture
     post-conditions:
-        * gets member pixels from texture data
+        * gets member pixels from texture data, converted to RGBA8
         * returns true if texture pixels were retrieved
     side-effects:
         * binds a null-texture
@@ -37,7 +60,8 @@ public:
     pre-conditions:
         * a locked texture
     post-conditions:
-        * updates texture with member pixels
+        * updates texture with member pixels, converted to the storage
+          format
         * returns true if pixels were updated
     side-effects:
         * binds a null-texture
@@ -53,6 +77,15 @@ public:
     */
     GLuint* data();
 
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns view of member pixels
+        * view is empty if the texture is not locked
+    side-effects: n/a
+    */
+    lpixel_view<GLuint> pixels();
+
     /*
     pre-conditions:
         * pixels available
@@ -73,40 +106,80 @@ public:
     */
     void set_pixel(const std::array<GLuint, 2>&, GLuint);
 
+    /*
+    pre-condition:
+        * valid GL context
+        * pixels are in given format, or null for an uninitialized texture
+    post-condition:
+        * creates a texture stored in given format from the given pixels,
+          pixels are handed to GL as they are
+        * formats the GL implementation lacks are stored as RGBA8
+        * reports error to console if texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_from_pixels(
+        const void*,           /* pixel data */
+        std::array<GLuint, 2>, /* texture dimensions */
+        lpixel_format);
+
     /*
     pre-condition:
         * valid GL context
     post-condition:
-        * creates a texture from the given pixels
+        * creates a texture stored in given format from the given RGBA8
+          pixels, converting them first unless the format is RGBA8
         * reports error to console if texture could not be created
     side-effects:
         * binds a null-texture
     */
     bool load_from_pixels32(
-        GLuint*, /* pixel data */
-        std::array<GLuint, 2> /* texture dimensions */);
+        GLuint*,               /* pixel data */
+        std::array<GLuint, 2>, /* texture dimensions */
+        lpixel_format = PIXEL_FORMAT_RGBA8);
 
     /*
     pre-conditions:
         * a valid OpenGL context
         * valid member pixels
     post-conditions:
-        * creates a texture from the number of pixels
+        * creates a texture stored in given format from the member pixels
         * deletes member pixels on success
         * reports error to console if texture could not be created
     side-effects:
         * binds a null-texture
     */
-    bool load_from_pixels32();
+    bool load_from_pixels32(lpixel_format = PIXEL_FORMAT_RGBA8);
 
-    bool load_from_file(std::string_view);
+    /*
+    pre-conditions:
+        * a valid OpenGL context
+        * initialized DevIL, for files no other decoder accepts
+    post-conditions:
+        * creates a texture stored in given format from the given file
+        * reports error to console if texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_from_file(std::string_view, lpixel_format = PIXEL_FORMAT_RGBA8);
+
+    /*
+    pre-conditions:
+        * a valid OpenGL context
+        * asset of an open pack
+    post-conditions:
+        * creates a texture from the asset pixels, in the asset format
+        * reports error to console if texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool load_from_asset(const lasset&);
 
     /*
     pre-conditions:
-        * initialized DevIL
+        * initialized DevIL, for files no other decoder accepts
     post-conditions:
         * loads member pixels from the given file
-        * pads image to have aligned dimensions
         * reports error to console if pixels could not be loaded
     side-effects: n/a
     */
@@ -115,18 +188,66 @@ public:
     /*
     pre-conditions:
         * a valid OpenGL context
-        * initialized DevIL
+        * initialized DevIL, for files no other decoder accepts
     post-conditions:
         * creates a texture from the given file
-        * pads image to have aligned dimensions
         * sets given RGBA value to RFFGFFBFFA00 in pixel data
         * if A = 0, only RGB components are compared
+        * texture is stored in given format
         * reports error to console if texture could not be created
     side-effects:
         * binds a null-texture
     */
     bool load_from_file_with_color_key(
-        std::string_view, std::array<GLubyte, 3> rgb, GLubyte a = 0);
+        std::string_view,
+        std::array<GLubyte, 3> rgb,
+        GLubyte                a      = 0,
+        lpixel_format          format = PIXEL_FORMAT_RGBA8);
+
+    /*
+    pre-conditions:
+        * a valid OpenGL context
+    post-conditions:
+        * creates an empty texture of given dimensions which can be rendered
+          into with begin_render/end_render
+        * returns false if framebuffer objects are not supported
+        * reports error to console if render target could not be created
+    side-effects:
+        * binds a null-texture
+        * binds the default framebuffer
+    */
+    bool create_render_target(std::array<GLuint, 2>);
+
+    /*
+    pre-conditions:
+        * a render target
+    post-conditions:
+        * submits quads queued on the renderer, then redirects rendering
+          into the texture
+        * viewport and camera cover the texture with the origin at the top
+          left corner, same as the screen
+    side-effects:
+        * saves viewport and renderer camera
+    */
+    bool begin_render(lrenderer&);
+
+    /*
+    pre-conditions:
+        * begin_render succeeded with the same renderer
+    post-conditions:
+        * submits quads queued on the renderer, then restores rendering into
+          the default framebuffer
+    side-effects:
+        * restores viewport and renderer camera
+    */
+    void end_render(lrenderer&);
+
+    /*
+    pre-condition: n/a
+    post-condition: returns true if texture is a render target
+    side-effects: n/a
+    */
+    bool is_render_target() const;
 
     /*
     pre-condition: valid GL context
@@ -140,16 +261,18 @@ public:
     /*
     pre-condition:
         * valid GL context
-        * active modelview matrix
     post-condition:
-        * translates to given position and renders textured quad
+        * queues textured sprite at given position, multiplied by given color
+          and rotated by given degrees clockwise around its center
         * if given texture clip is null, the full texture is rendered
-    side-effects:
-        * binds member texture id
+    side-effects: n/a
     */
     void render(
+        lrenderer&,
         std::array<GLfloat, 2>,
-        std::optional<lfrect> clip = std::optional<lfrect>());
+        std::optional<lfrect>         clip     = std::optional<lfrect>(),
+        const std::array<GLfloat, 4>& color    = {1.f, 1.f, 1.f, 1.f},
+        GLfloat                       rotation = 0.f);
 
     /*
     pre-condition: n/a
@@ -165,6 +288,22 @@ public:
     side-effects: n/a
     */
     std::array<GLuint, 2> get_dimensions() const;
+
+    /*
+    pre-condition: n/a
+    post-condition: returns storage format of the texture
+    side-effects: n/a
+    */
+    lpixel_format get_format() const;
+
+    /*
+    pre-condition: n/a
+    post-condition:
+        * returns size of the texture in video memory in bytes, from the
+          storage format, drivers may pad it further
+    side-effects: n/a
+    */
+    std::size_t memory_size() const;
 };
 
 #endif // LTEXTURE_HPP
@@ -0,0 +1,166 @@
+#include "lupload_queue.hpp"
+
+#include <algorithm>
+
+#include <gsl/gsl_util> // for gsl::narrow
+
+#include "ltexture.hpp"
+#include "macro_helpers.hpp"
+
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
+lupload_queue::lupload_queue(lupload_budget budget, std::size_t chunk_bytes)
+    : _budget(budget), _chunk_bytes(chunk_bytes)
+{
+}
+
+void
+lupload_queue::set_budget(lupload_budget budget)
+{
+    _budget = budget;
+}
+
+bool
+lupload_queue::enqueue(
+    ltexture&         texture,
+    limage&&          image,
+    ready_callback    ready,
+    progress_callback progress)
+{
+    if (!image.pixels || Wv(image.dimensions) == 0 ||
+        Hv(image.dimensions) == 0) {
+        std::cerr << "unable to upload an image without pixels\n";
+        return false;
+    }
+
+    // the texture is replaced once its upload starts
+    _uploads.push_back(
+        {&texture, std::move(image), 0, std::move(progress), std::move(ready)});
+    return true;
+}
+
+void
+lupload_queue::cancel(const ltexture& texture)
+{
+    _uploads.erase(
+        std::remove_if(
+            _uploads.begin(),
+            _uploads.end(),
+            [&texture](const lupload& upload) {
+                return upload.texture == &texture;
+            }),
+        _uploads.end());
+}
+
+std::size_t
+lupload_queue::update()
+{
+    const auto  start    = std::chrono::steady_clock::now();
+    std::size_t uploaded = 0;
+    GLuint      bound    = 0;
+
+    while (!_uploads.empty()) {
+        auto&             upload    = _uploads.front();
+        const auto&       dims      = upload.image.dimensions;
+        const std::size_t row_bytes = Wv(dims) * std::size_t{4};
+
+        // rows of the chunk, within what is left of the byte budget
+        std::size_t rows = std::max<std::size_t>(1, _chunk_bytes / row_bytes);
+        if (_budget.bytes_per_frame != 0) {
+            rows = std::min(
+                rows, (_budget.bytes_per_frame - uploaded) / row_bytes);
+
+            // a row wider than the budget still goes, alone in its frame
+            if (rows == 0) {
+                if (uploaded != 0) break;
+                rows = 1;
+            }
+        }
+        rows = std::min<std::size_t>(rows, Hv(dims) - upload.next_row);
+
+        // allocating storage costs about as much as filling it, so it waits
+        // for the first chunk instead of piling up in the frame of enqueue
+        if (upload.next_row == 0) {
+            bound = 0;
+            if (!upload.texture->load_from_pixels(
+                    nullptr, dims, PIXEL_FORMAT_RGBA8)) {
+                std::cerr << "queued upload dropped\n";
+                _uploads.pop_front();
+                continue;
+            }
+        }
+
+        const GLuint texture_id = upload.texture->get_texture_id();
+        if (texture_id != bound) {
+            glBindTexture(GL_TEXTURE_2D, texture_id);
+            bound = texture_id;
+        }
+
+        // rows are contiguous, a strip is one sub-rectangle
+        const GLuint* strip =
+            upload.image.pixels.get() + std::size_t{upload.next_row} * Wv(dims);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            0,
+            gsl::narrow<GLint>(upload.next_row),
+            gsl::narrow<GLsizei>(Wv(dims)),
+            gsl::narrow<GLsizei>(rows),
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            strip);
+
+        uploaded += rows * row_bytes;
+        upload.next_row += gsl::narrow<GLuint>(rows);
+
+        // callbacks may queue or cancel uploads, finished ones leave first
+        ltexture&   texture  = *upload.texture;
+        const float progress = static_cast<float>(upload.next_row) /
+                               static_cast<float>(Hv(dims));
+        if (upload.next_row == Hv(dims)) {
+            lupload done = std::move(upload);
+            _uploads.pop_front();
+
+            if (done.progress) done.progress(texture, progress);
+            if (done.ready) done.ready(texture);
+            bound = 0;
+        } else if (upload.progress) {
+            auto callback = upload.progress;
+            callback(texture, progress);
+            bound = 0;
+        }
+
+        // budget spent
+        if (_budget.bytes_per_frame != 0 &&
+            uploaded >= _budget.bytes_per_frame) {
+            break;
+        }
+        if (_budget.time_per_frame.count() != 0 &&
+            std::chrono::steady_clock::now() - start >=
+                _budget.time_per_frame) {
+            break;
+        }
+    }
+
+    if (uploaded != 0) glBindTexture(GL_TEXTURE_2D, 0);
+
+    return uploaded;
+}
+
+std::size_t
+lupload_queue::pending() const
+{
+    return _uploads.size();
+}
+
+std::size_t
+lupload_queue::pending_bytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& upload : _uploads) {
+        const auto& dims = upload.image.dimensions;
+        bytes += (Hv(dims) - upload.next_row) * std::size_t{Wv(dims)} * 4;
+    }
+    return bytes;
+}
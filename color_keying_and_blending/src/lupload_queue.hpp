@@ -0,0 +1,125 @@
+#ifndef LUPLOAD_QUEUE_HPP
+#define LUPLOAD_QUEUE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+
+#include "limage_decoder.hpp"
+#include "lopengl.hpp"
+
+class ltexture;
+
+/*
+Upload work allowed per frame, a zero limit is no limit. The time limit is
+checked between chunks, so a frame may overrun it by one chunk.
+*/
+struct lupload_budget {
+    std::size_t               bytes_per_frame = {0};
+    std::chrono::microseconds time_per_frame  = std::chrono::microseconds(0);
+};
+
+/*
+Spreads texture uploads over frames. Decoded images are queued with their
+texture; every update then allocates the storage of the next textures and
+uploads strips of rows with glTexSubImage2D until the frame budget is spent,
+so a large image no longer stalls the frame it was loaded in. Images are
+uploaded in the order they were queued.
+*/
+class lupload_queue {
+public:
+    // texture and fraction of its rows uploaded, called after every chunk
+    using progress_callback = std::function<void(ltexture&, float)>;
+
+    // texture holds the whole image
+    using ready_callback = std::function<void(ltexture&)>;
+
+private:
+    struct lupload {
+        ltexture*         texture = {nullptr};
+        limage            image;
+        GLuint            next_row = {0};
+        progress_callback progress;
+        ready_callback    ready;
+    };
+
+    std::deque<lupload> _uploads;
+    lupload_budget      _budget;
+    std::size_t         _chunk_bytes = {0};
+
+public:
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * uploads at most given budget per update, in chunks of about given
+          bytes, at least one row each
+    side-effects: n/a
+    */
+    explicit lupload_queue(
+        lupload_budget = {}, std::size_t chunk_bytes = 64 * 1024);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * replaces the budget of the following updates
+    side-effects: n/a
+    */
+    void set_budget(lupload_budget);
+
+    /*
+    pre-conditions:
+        * texture outlives the upload or is cancelled first
+        * image pixels come from an allocator which outlives the upload
+    post-conditions:
+        * queues the image for upload, the texture is recreated as RGBA8
+          when the upload starts and is undefined until the ready callback
+        * returns false if the image has no pixels or is empty
+    side-effects: n/a
+    */
+    bool enqueue(
+        ltexture&,
+        limage&&,
+        ready_callback    ready    = {},
+        progress_callback progress = {});
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * drops queued uploads of the texture without calling back
+    side-effects: n/a
+    */
+    void cancel(const ltexture&);
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * called once per frame
+    post-conditions:
+        * creates textures whose upload starts and uploads queued rows
+          within the budget, calling back progress and readiness as they
+          happen
+        * uploads whose texture cannot be created are dropped without
+          calling back and reported to console
+        * returns bytes uploaded
+    side-effects:
+        * binds a null-texture
+    */
+    std::size_t update();
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns number of textures not uploaded completely
+    side-effects: n/a
+    */
+    std::size_t pending() const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns bytes left to upload
+    side-effects: n/a
+    */
+    std::size_t pending_bytes() const;
+};
+
+#endif // LUPLOAD_QUEUE_HPP
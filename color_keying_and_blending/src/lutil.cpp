@@ -2,54 +2,524 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdio> // for std::fopen and std::fprintf
+#include <cstdlib> // for std::abs
 #include <cstring>
 #include <gsl/gsl_util>
 #include <limits>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>        // for ::open and posix_fadvise
+#include <sys/resource.h> // for getrusage
+#include <unistd.h>       // for ::close and fdatasync
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
+#ifdef HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+
+#include "lasset_pack.hpp"
+#include "lcapture.hpp"
+#include "lgl_errors.hpp"
+#include "limage_decoder.hpp"
+#include "lpixel_allocator.hpp"
 #include "lrect.hpp"
+#include "lrenderer.hpp"
+#include "lsoft_renderer.hpp"
 #include "ltexture.hpp"
+#include "lupload_queue.hpp"
 #include "macro_helpers.hpp"
 
+// wraps GL calls when stats are enabled, keep it last
+#include "lgl_stats.hpp"
+
 namespace {
 
-static ltexture g_circle_texture;
+// frames between backdrop refreshes
+constexpr int BACKDROP_REFRESH_FRAMES = SCREEN_FPS / 4;
+
+// stripe width of the backdrop
+constexpr GLfloat BACKDROP_STRIPE = 32.f;
+
+// backdrop colors
+constexpr std::array<GLfloat, 4> BACKDROP_COLOR = {0.1f, 0.1f, 0.3f, 1.f};
+constexpr std::array<GLfloat, 4> STRIPE_COLOR   = {0.2f, 0.2f, 0.6f, 1.f};
+
+// cyan background of the circle image
+constexpr std::array<GLubyte, 3> CIRCLE_COLOR_KEY = {0, 0xff, 0xff};
+
+// circle is drawn half transparent
+constexpr std::array<GLfloat, 4> CIRCLE_TINT = {1.f, 1.f, 1.f, 0.5f};
+
+// frames rendered by render_software to time the rasterizer
+constexpr int SOFTWARE_FRAMES = 60;
+
+// quads of the polygons tutorial, compare_software draws them at every
+// projection scale the tutorial cycles through
+constexpr GLfloat                POLYGON_HALF_SIZE = 50.f;
+constexpr std::array<GLfloat, 4> POLYGON_CYAN      = {0.f, 1.f, 1.f, 1.f};
+constexpr std::array<std::array<GLfloat, 4>, 4> POLYGON_CORNERS = {{
+    {1.f, 0.f, 0.f, 1.f}, // red
+    {1.f, 1.f, 0.f, 1.f}, // yellow
+    {0.f, 1.f, 0.f, 1.f}, // green
+    {0.f, 0.f, 1.f, 1.f}  // blue
+}};
+constexpr std::array<GLfloat, 3> POLYGON_SCALES = {1.f, 2.f, 0.5f};
+
+// largest channel difference between GL and software frames, GL rasterizers
+// may interpolate and round with a few bits less precision
+constexpr int SOFTWARE_PARITY_TOLERANCE = 2;
+
+// full screen quads drawn per frame by benchmark_software
+constexpr int SOFTWARE_BENCHMARK_LAYERS = 8;
+
+// pack with the color keyed circle, built by make_asset_pack:
+// make_asset_pack textures.pack -k 00ffff circle.png
+constexpr std::string_view ASSET_PACK_PATH = "../textures/textures.pack";
+
+// images loaded per pass of benchmark_loads, as one level would
+constexpr std::array<std::string_view, 4> LOAD_BENCHMARK_PATHS = {
+    "../textures/circle.png",
+    "../textures/clip.png",
+    "../textures/football.png",
+    "../textures/grass.jpg"};
+constexpr int LOAD_BENCHMARK_PASSES = 20;
+
+// benchmark_packs loads this many copies of the load benchmark images, as
+// files and as one pack, written to the working directory and removed after
+constexpr std::size_t      PACK_BENCHMARK_COPIES = 8;
+constexpr int              PACK_BENCHMARK_PASSES = 5;
+constexpr std::string_view PACK_BENCHMARK_PREFIX = "pack_benchmark";
+
+// benchmark_decoders also decodes images tiled from grass.jpg to this size,
+// written to the working directory as PNG and JPEG and removed afterwards
+constexpr GLuint           DECODE_CORPUS_SIZE      = 2048;
+constexpr std::string_view DECODE_CORPUS_PREFIX    = "decode_benchmark";
+constexpr int              DECODE_BENCHMARK_PASSES = 5;
+
+// benchmark_uploads streams this many copies of its image at one frame
+constexpr std::size_t UPLOAD_BENCHMARK_TEXTURES = 16;
+constexpr int         UPLOAD_BENCHMARK_FRAMES   = 120;
+constexpr int         UPLOAD_BENCHMARK_START    = 10;
+
+// upload work per frame of the queued benchmark run
+constexpr lupload_budget UPLOAD_BUDGET = {1024 * 1024,
+                                          std::chrono::microseconds(2000)};
+
+// uploads of every format timed by benchmark_formats
+constexpr int FORMAT_BENCHMARK_PASSES = 20;
+
+// frames of every format recorded by benchmark_capture
+constexpr int CAPTURE_BENCHMARK_FRAMES = 120;
+
+// screenshots and recordings of the keys, QOI encodes fast enough to record
+// every frame
+constexpr std::string_view SCREENSHOT_PREFIX = "screenshot_";
+constexpr std::string_view RECORDING_PREFIX  = "recording_";
+
+static std::unique_ptr<lrenderer> g_renderer;
+static lasset_pack                g_assets;
+static ltexture                   g_circle_texture;
+
+// circle pixels still hold the color key, the renderer drops it
+static bool g_circle_keyed_on_gpu = false;
+
+// reads back screenshots and recordings
+static lcapture g_capture;
+static int      g_screenshots = 0;
+
+// procedural backdrop, cached in a render target
+static ltexture g_backdrop;
+static bool     g_backdrop_dirty = true;
+static int      g_frame          = 0;
+
+// diagonal stripes of the backdrop, over a clear of the backdrop color
+void
+draw_stripes(lrenderer& renderer, GLfloat width, GLfloat height, GLfloat shift)
+{
+    // plain colored quads
+    const GLuint color = pack_color(STRIPE_COLOR);
+    for (GLfloat x = shift - height; x < width; x += 2.f * BACKDROP_STRIPE) {
+        renderer.draw(
+            0,
+            {{{x, 0.f, 0.f, 0.f, color},
+              {x + BACKDROP_STRIPE, 0.f, 0.f, 0.f, color},
+              {x + BACKDROP_STRIPE + height, height, 0.f, 0.f, color},
+              {x + height, height, 0.f, 0.f, color}}});
+    }
+}
+
+// the scene render draws, with the circle texture of given name
+void
+draw_scene(
+    lrenderer& renderer, GLuint circle, std::array<GLuint, 2> dims, bool keyed)
+{
+    const auto width  = gsl::narrow<GLfloat>(SCREEN_WIDTH);
+    const auto height = gsl::narrow<GLfloat>(SCREEN_HEIGHT);
+    draw_stripes(renderer, width, height, 0.f);
+
+    // half transparent circle
+    if (keyed) renderer.set_color_key(dims, CIRCLE_COLOR_KEY);
+    renderer.draw_sprite(
+        circle,
+        dims,
+        {(width - gsl::narrow<GLfloat>(Wv(dims))) / 2.f,
+         (height - gsl::narrow<GLfloat>(Hv(dims))) / 2.f,
+         {0.f,
+          0.f,
+          gsl::narrow<GLfloat>(Wv(dims)),
+          gsl::narrow<GLfloat>(Hv(dims))},
+         0.f,
+         pack_color(CIRCLE_TINT)});
+    if (keyed) renderer.set_color_key(dims, std::nullopt);
+
+    renderer.flush();
+}
+
+// cyan or multi-colored quad of the polygons tutorial, centered on the
+// screen under a projection of given scale
+void
+draw_polygon(lrenderer& renderer, GLfloat scale, bool multi_colored)
+{
+    lmatrix view = IDENTITY_MATRIX;
+    view[12]     = gsl::narrow<GLfloat>(SCREEN_WIDTH) / 2.f;
+    view[13]     = gsl::narrow<GLfloat>(SCREEN_HEIGHT) / 2.f;
+    renderer.set_camera(
+        ortho_matrix(
+            0.f,
+            gsl::narrow<GLfloat>(SCREEN_WIDTH) * scale,
+            gsl::narrow<GLfloat>(SCREEN_HEIGHT) * scale,
+            0.f),
+        view);
+
+    std::array<GLuint, 4> colors;
+    for (std::size_t i = 0; i < colors.size(); ++i) {
+        colors[i] = pack_color(
+            multi_colored ? POLYGON_CORNERS[i] : POLYGON_CYAN);
+    }
 
+    const GLfloat size = POLYGON_HALF_SIZE;
+    renderer.draw(
+        0,
+        {{{-size, -size, 0.f, 0.f, colors[0]},
+          {size, -size, 0.f, 0.f, colors[1]},
+          {size, size, 0.f, 0.f, colors[2]},
+          {-size, size, 0.f, 0.f, colors[3]}}});
+    renderer.flush();
 }
 
+// RGBA8 pixels of the default framebuffer, row 0 at the top
+std::vector<GLuint>
+read_screen()
+{
+    std::vector<GLuint> pixels(std::size_t{SCREEN_WIDTH} * SCREEN_HEIGHT);
+    glReadPixels(
+        0,
+        0,
+        SCREEN_WIDTH,
+        SCREEN_HEIGHT,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        pixels.data());
+
+    // GL rows start at the bottom
+    for (std::size_t y = 0; y < SCREEN_HEIGHT / 2; ++y) {
+        GLuint* top    = &pixels[y * SCREEN_WIDTH];
+        GLuint* bottom = &pixels[(SCREEN_HEIGHT - 1 - y) * SCREEN_WIDTH];
+        std::swap_ranges(top, top + SCREEN_WIDTH, bottom);
+    }
+    return pixels;
+}
+
+// reports how far the frames differ, RGB only since the window may lack an
+// alpha channel; returns true if they are within tolerance
 bool
-initGL()
+compare_frames(
+    const std::vector<GLuint>&       gl_pixels,
+    const lpixel_view<const GLuint>& software)
 {
-    // set the viewport
-    glViewport(0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT);
+    int         max_difference = 0;
+    std::size_t over_tolerance = 0;
+    for (std::size_t y = 0; y < software.height(); ++y) {
+        const GLuint* gl_row = &gl_pixels[y * software.width()];
+        const GLuint* row    = software.row(y);
+        for (std::size_t x = 0; x < software.width(); ++x) {
+            int difference = 0;
+            for (GLuint shift = 0; shift < 24; shift += 8) {
+                const int a = static_cast<int>((gl_row[x] >> shift) & 0xffu);
+                const int b = static_cast<int>((row[x] >> shift) & 0xffu);
+                difference  = std::max(difference, std::abs(a - b));
+            }
+            max_difference = std::max(max_difference, difference);
+            if (difference > SOFTWARE_PARITY_TOLERANCE) ++over_tolerance;
+        }
+    }
+
+    std::cout << "max channel difference " << max_difference
+              << ", " << over_tolerance << " pixels over "
+              << SOFTWARE_PARITY_TOLERANCE << '\n';
+    return over_tolerance == 0;
+}
 
-    // initialize projection matrix
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(0.0, SCREEN_WIDTH, SCREEN_HEIGHT, 0.0, 1.0, -1.0);
+void
+draw_backdrop()
+{
+    if (!g_backdrop.begin_render(*g_renderer)) return;
+
+    // diagonal stripes, shifted once per refresh
+    const auto& dims   = g_backdrop.get_dimensions();
+    const auto  width  = gsl::narrow<GLfloat>(Wv(dims));
+    const auto  height = gsl::narrow<GLfloat>(Hv(dims));
+    const auto  shift =
+        g_frame / BACKDROP_REFRESH_FRAMES % 2 ? BACKDROP_STRIPE : 0.f;
+
+    glClearColor(
+        Rc(BACKDROP_COLOR),
+        Gc(BACKDROP_COLOR),
+        Bc(BACKDROP_COLOR),
+        Ac(BACKDROP_COLOR));
+    glClear(GL_COLOR_BUFFER_BIT);
+    draw_stripes(*g_renderer, width, height, shift);
 
-    // initialize model-view matrix
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    // restore state
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+
+    g_backdrop.end_render(*g_renderer);
+}
+
+bool
+write_ppm(std::string_view path, const lpixel_view<const GLuint>& pixels)
+{
+    std::FILE* file = std::fopen(path.data(), "wb");
+    if (!file) return false;
+
+    std::fprintf(file, "P6\n%zu %zu\n255\n", pixels.width(), pixels.height());
+    std::vector<GLubyte> rgb(pixels.width() * 3);
+    for (std::size_t y = 0; y < pixels.height(); ++y) {
+        const GLuint* row = pixels.row(y);
+        for (std::size_t x = 0; x < pixels.width(); ++x) {
+            rgb[x * 3]     = static_cast<GLubyte>(row[x]);
+            rgb[x * 3 + 1] = static_cast<GLubyte>(row[x] >> 8);
+            rgb[x * 3 + 2] = static_cast<GLubyte>(row[x] >> 16);
+        }
+        std::fwrite(rgb.data(), 1, rgb.size(), file);
+    }
+
+    return std::fclose(file) == 0;
+}
+
+#ifdef HAVE_LIBJPEG
+
+// baseline JPEG at the default quality, libjpeg exits on errors
+bool
+write_jpeg(std::string_view path, const lpixel_view<const GLuint>& pixels)
+{
+    std::FILE* file = std::fopen(path.data(), "wb");
+    if (!file) return false;
+
+    jpeg_compress_struct info;
+    jpeg_error_mgr       error;
+    info.err = jpeg_std_error(&error);
+    jpeg_create_compress(&info);
+    jpeg_stdio_dest(&info, file);
+
+    info.image_width      = gsl::narrow<JDIMENSION>(pixels.width());
+    info.image_height     = gsl::narrow<JDIMENSION>(pixels.height());
+    info.input_components = 3;
+    info.in_color_space   = JCS_RGB;
+    jpeg_set_defaults(&info);
+    jpeg_start_compress(&info, TRUE);
+
+    std::vector<JSAMPLE> rgb(pixels.width() * 3);
+    while (info.next_scanline < info.image_height) {
+        const GLuint* row = pixels.row(info.next_scanline);
+        for (std::size_t x = 0; x < pixels.width(); ++x) {
+            rgb[x * 3]     = static_cast<JSAMPLE>(row[x]);
+            rgb[x * 3 + 1] = static_cast<JSAMPLE>(row[x] >> 8);
+            rgb[x * 3 + 2] = static_cast<JSAMPLE>(row[x] >> 16);
+        }
+        JSAMPROW out = rgb.data();
+        jpeg_write_scanlines(&info, &out, 1);
+    }
+
+    jpeg_finish_compress(&info);
+    jpeg_destroy_compress(&info);
+    return std::fclose(file) == 0;
+}
+
+#endif // HAVE_LIBJPEG
+
+/*
+Writes images of DECODE_CORPUS_SIZE tiled from the given one in every format
+an encoder is built in for, appends their paths. Tiles keep the content of a
+photo while making decodes long enough to time.
+*/
+bool
+write_decode_corpus(const limage& tile, std::vector<std::string>& paths)
+{
+    const std::size_t size   = DECODE_CORPUS_SIZE;
+    const std::size_t tile_w = Wv(tile.dimensions);
+    const std::size_t tile_h = Hv(tile.dimensions);
+
+    std::vector<GLuint> pixels(size * size);
+    for (std::size_t y = 0; y < size; ++y) {
+        const GLuint* row = tile.pixels.get() + (y % tile_h) * tile_w;
+        for (std::size_t x = 0; x < size; ++x) {
+            pixels[y * size + x] = row[x % tile_w];
+        }
+    }
+    const std::array<GLuint, 2> dims = {DECODE_CORPUS_SIZE, DECODE_CORPUS_SIZE};
+
+    if (lcapture::format_supported(CAPTURE_FORMAT_PNG)) {
+        const std::string path = std::string(DECODE_CORPUS_PREFIX) + ".png";
+        std::vector<GLubyte> bytes(pixels.size() * sizeof(GLuint));
+        std::memcpy(bytes.data(), pixels.data(), bytes.size());
+        if (save_capture(path, CAPTURE_FORMAT_PNG, dims, bytes) == 0) {
+            return false;
+        }
+        paths.push_back(path);
+    }
+
+#ifdef HAVE_LIBJPEG
+    const std::string path = std::string(DECODE_CORPUS_PREFIX) + ".jpg";
+    if (!write_jpeg(path, {pixels.data(), dims})) {
+        std::cerr << "unable to write " << path << '\n';
+        return false;
+    }
+    paths.push_back(path);
+#endif
+
+    return true;
+}
+
+// copies a file byte for byte
+bool
+copy_file(std::string_view from, const std::string& to)
+{
+    std::FILE* in = std::fopen(from.data(), "rb");
+    if (!in) return false;
+    auto _ = gsl::finally([in]() { std::fclose(in); });
+
+    std::FILE* out = std::fopen(to.c_str(), "wb");
+    if (!out) return false;
+
+    std::array<char, 65536> buffer;
+    bool                    copied = true;
+    std::size_t             read   = 0;
+    while ((read = std::fread(buffer.data(), 1, buffer.size(), in)) != 0) {
+        copied = copied && std::fwrite(buffer.data(), 1, read, out) == read;
+    }
+    return std::fclose(out) == 0 && copied;
+}
+
+// drops the cached pages of a file, so the next read goes to the disk
+bool
+evict_from_page_cache(const std::string& path)
+{
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    // dirty pages stay cached, write them out first
+    const bool evicted = fdatasync(file) == 0 &&
+                         posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(file);
+    return evicted;
+}
+
+// frame times sorted in ascending order
+double
+percentile(const std::vector<double>& frame_ms, double p)
+{
+    return frame_ms[static_cast<std::size_t>(
+        p / 100. * static_cast<double>(frame_ms.size() - 1))];
+}
+
+// renders given number of frames, returns their times sorted
+std::vector<double>
+time_frames(int frames)
+{
+    std::vector<double> frame_ms;
+    for (int frame = 0; frame < frames; ++frame) {
+        const auto start = std::chrono::steady_clock::now();
+
+        update();
+        render();
+        glFinish();
+
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        frame_ms.push_back(elapsed.count());
+    }
+
+    std::sort(frame_ms.begin(), frame_ms.end());
+    return frame_ms;
+}
+
+void
+print_capture_stats(const lcapture_stats& stats)
+{
+    const double pixel_mb = static_cast<double>(stats.pixel_bytes) / 1e6;
+    std::cout << stats.frames_written << " of " << stats.frames_requested
+              << " frames written, dropped " << stats.dropped_readback
+              << " waiting for the GPU and " << stats.dropped_encoder
+              << " waiting for the encoder\n";
+    if (stats.frames_requested != 0) {
+        std::cout << "GL thread: "
+                  << stats.capture_seconds * 1e3 /
+                         static_cast<double>(stats.frames_requested)
+                  << " ms per captured frame\n";
+    }
+    if (stats.encode_seconds > 0.) {
+        std::cout << "encoder: "
+                  << static_cast<double>(stats.frames_written) /
+                         stats.encode_seconds
+                  << " frames/s, " << pixel_mb / stats.encode_seconds
+                  << " MB/s of pixels, "
+                  << static_cast<double>(stats.encoded_bytes) / 1e6
+                  << " MB written\n";
+    }
+}
+
+} // namespace
+
+bool
+initGL(bool programmable, bool instancing)
+{
+    // set the viewport
+    glViewport(0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT);
 
     // initialize clear color
     glClearColor(0.f, 0.f, 0.f, 1.f);
 
-    // enable texturing
-    glEnable(GL_TEXTURE_2D);
+    // pick the renderer, screen coordinates with the origin at the top left
+    g_renderer = make_renderer(programmable, instancing);
+    g_renderer->set_camera(
+        ortho_matrix(
+            0.f,
+            gsl::narrow<GLfloat>(SCREEN_WIDTH),
+            gsl::narrow<GLfloat>(SCREEN_HEIGHT),
+            0.f),
+        IDENTITY_MATRIX);
+
+    // screenshots and recordings are optional, they need pack buffers
+    if (!g_capture.init({SCREEN_WIDTH, SCREEN_HEIGHT})) {
+        std::cerr << "rendering without capture\n";
+    }
 
     // set blending
     glEnable(GL_BLEND);
     glDisable(GL_DEPTH_TEST);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // check for error
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cerr << "error initializing OpenGL! " << gluErrorString(error)
-                  << '\n';
+    // report errors through debug callbacks when available, then check for
+    // errors of the initialization
+    gl_errors_init();
+    if (gl_errors_flush("initGL") != 0) {
+        std::cerr << "error initializing OpenGL!\n";
         return false;
     }
 
@@ -70,22 +540,75 @@ initGL()
 }
 
 bool
-load_media(std::string_view path)
+load_media(std::string_view path, bool gpu_color_key)
 {
+    // load pixels live until their upload, take them from an arena and drop
+    // them all at once when loading is done, its block fits the first image
+    larena_allocator load_arena;
+    set_pixel_allocator(&load_arena);
+    auto _ = gsl::finally([]() { set_pixel_allocator(nullptr); });
+
+    // the sprite program keys the circle per fragment, so it is uploaded as
+    // decoded; without shaders every pixel is keyed on the CPU first
+    g_circle_keyed_on_gpu = gpu_color_key && g_renderer->supports_color_key();
+
+    // prefer the asset pack, its circle is already color keyed
+    const auto start  = std::chrono::steady_clock::now();
+    bool       loaded = false;
+    if (g_assets.open(ASSET_PACK_PATH)) {
+        if (auto asset = g_assets.find("circle.png")) {
+            loaded = g_circle_texture.load_from_asset(*asset);
+        }
+    }
+
+    const bool from_pack = loaded;
+    if (from_pack) {
+        g_circle_keyed_on_gpu = false;
+    } else {
+        loaded = g_circle_keyed_on_gpu
+                     ? g_circle_texture.load_from_file(path)
+                     : g_circle_texture.load_from_file_with_color_key(
+                           path, CIRCLE_COLOR_KEY);
+    }
+
     // load texture
-    if (!g_circle_texture.load_from_file_with_color_key(
-            path, {0, 0xff, 0xff})) {
+    if (!loaded) {
         std::cerr << "unable to load file texture\n";
+
+        // pixels kept on failure come from the arena
+        g_circle_texture.free_texture();
+        return false;
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "loaded circle from " << (from_pack ? "asset pack" : path)
+              << " in " << elapsed.count() << " ms, color key applied "
+              << (from_pack               ? "when the pack was built"
+                  : g_circle_keyed_on_gpu ? "per fragment"
+                                          : "on the CPU")
+              << '\n';
+
+    // one error check for the whole load instead of one per texture
+    if (gl_errors_flush("load_media") != 0) {
+        std::cerr << "unable to upload circle texture\n";
+        g_circle_texture.free_texture();
         return false;
     }
 
+    // backdrop is optional, it needs framebuffer objects
+    if (!g_backdrop.create_render_target({SCREEN_WIDTH, SCREEN_HEIGHT})) {
+        std::cerr << "rendering without backdrop\n";
+    }
+
     return true;
 }
 
 void
 update()
 {
-    // TBD
+    // the backdrop animates at a lower rate than the screen
+    if (++g_frame % BACKDROP_REFRESH_FRAMES == 0) { g_backdrop_dirty = true; }
 }
 
 void
@@ -94,15 +617,776 @@ render()
     // clear color buffer
     glClear(GL_COLOR_BUFFER_BIT);
 
-    const auto& dims = g_circle_texture.get_dimensions();
+    // re-render backdrop only when it changed
+    if (g_backdrop_dirty) {
+        draw_backdrop();
+        g_backdrop_dirty = false;
+    }
+
+    // render cached backdrop
+    g_backdrop.render(*g_renderer, {0.f, 0.f});
 
-    glColor4f(1.f, 1.f, 1.f, 0.5f);
+    const auto& dims = g_circle_texture.get_dimensions();
 
-    // render circle
+    // render half transparent circle
+    if (g_circle_keyed_on_gpu) {
+        g_renderer->set_color_key(dims, CIRCLE_COLOR_KEY);
+    }
     g_circle_texture.render(
+        *g_renderer,
         {gsl::narrow<float>(SCREEN_WIDTH - Wv(dims)) / 2.f,
-         gsl::narrow<float>(SCREEN_HEIGHT - Hv(dims)) / 2.f});
+         gsl::narrow<float>(SCREEN_HEIGHT - Hv(dims)) / 2.f},
+        std::nullopt,
+        CIRCLE_TINT);
+    if (g_circle_keyed_on_gpu) g_renderer->set_color_key(dims, std::nullopt);
+
+    // submit the frame
+    g_renderer->flush();
+
+    // read the frame back if a screenshot or recording wants it
+    g_capture.capture_frame();
 
     // update screen
     glutSwapBuffers();
+
+    // report errors of the frame
+    gl_errors_flush("render");
+
+    // frame boundary of the GL call counters
+    gl_stats_end_frame();
+}
+
+void
+handle_keys(unsigned char key, int, int)
+{
+    const auto format = lcapture::format_supported(CAPTURE_FORMAT_PNG)
+                            ? CAPTURE_FORMAT_PNG
+                            : CAPTURE_FORMAT_QOI;
+
+    // p saves the next frame
+    if (key == 'p') {
+        std::string path(SCREENSHOT_PREFIX);
+        path += std::to_string(g_screenshots++);
+        path += format == CAPTURE_FORMAT_PNG ? ".png" : ".qoi";
+        g_capture.screenshot(path, format);
+    }
+
+    // r starts and stops recording every frame
+    if (key == 'r') {
+        if (!g_capture.is_recording()) {
+            g_capture.reset_stats();
+            g_capture.start_recording(
+                std::string(RECORDING_PREFIX), CAPTURE_FORMAT_QOI);
+        } else {
+            g_capture.stop_recording();
+            g_capture.finish();
+            print_capture_stats(g_capture.stats());
+        }
+    }
+}
+
+bool
+render_software(std::string_view path, std::string_view output)
+{
+    // DevIL decodes formats the built-in decoders lack
+    ilInit();
+
+    // the software renderer keys the circle while sampling, like the sprite
+    // program
+    limage circle;
+    if (!decode_image(path, circle)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+
+    lsoft_renderer renderer({SCREEN_WIDTH, SCREEN_HEIGHT});
+    const GLuint   texture = renderer.add_texture(
+        lpixel_view<const GLuint>(circle.pixels.get(), circle.dimensions));
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < SOFTWARE_FRAMES; ++frame) {
+        renderer.clear(BACKDROP_COLOR);
+        draw_scene(renderer, texture, circle.dimensions, true);
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    const double pixels =
+        double{SCREEN_WIDTH} * SCREEN_HEIGHT * SOFTWARE_FRAMES;
+    std::cout << "software renderer: " << pixels / 1e6 / elapsed.count()
+              << " Mpixels/s of framebuffer\n";
+
+    if (!write_ppm(output, renderer.pixels())) {
+        std::cerr << "unable to write " << output << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+bool
+benchmark_software(std::string_view path)
+{
+    // DevIL decodes formats the built-in decoders lack
+    ilInit();
+
+    limage circle;
+    if (!decode_image(path, circle)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+
+    const auto width  = gsl::narrow<GLfloat>(SCREEN_WIDTH);
+    const auto height = gsl::narrow<GLfloat>(SCREEN_HEIGHT);
+
+    // full screen layers, corners colored like the polygons tutorial
+    std::array<GLuint, 4> corners;
+    for (std::size_t i = 0; i < corners.size(); ++i) {
+        auto color = POLYGON_CORNERS[i];
+        Ac(color)  = 0.5f;
+        corners[i] = pack_color(color);
+    }
+    const auto layer = [&](GLuint tint) {
+        return std::array<lvertex, 4>{{{0.f, 0.f, 0.f, 0.f, corners[0]},
+                                       {width, 0.f, 1.f, 0.f, corners[1]},
+                                       {width, height, 1.f, 1.f, tint},
+                                       {0.f, height, 0.f, 1.f, corners[3]}}};
+    };
+
+    const std::size_t hardware =
+        std::max(1u, std::thread::hardware_concurrency());
+    for (const std::size_t threads : {std::size_t{1}, hardware}) {
+        lsoft_renderer renderer({SCREEN_WIDTH, SCREEN_HEIGHT}, threads);
+        const GLuint   texture = renderer.add_texture(
+            lpixel_view<const GLuint>(circle.pixels.get(), circle.dimensions));
+
+        const auto time = [&](std::string_view workload, auto draw) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < SOFTWARE_FRAMES; ++frame) {
+                renderer.clear(BACKDROP_COLOR);
+                draw();
+                renderer.flush();
+            }
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            return std::pair(workload, elapsed.count() / SOFTWARE_FRAMES);
+        };
+
+        const auto gouraud = time("gouraud", [&]() {
+            for (int i = 0; i < SOFTWARE_BENCHMARK_LAYERS; ++i) {
+                renderer.draw(0, layer(corners[2]));
+            }
+        });
+        const auto textured = time("textured, keyed", [&]() {
+            renderer.set_color_key(circle.dimensions, CIRCLE_COLOR_KEY);
+            for (int i = 0; i < SOFTWARE_BENCHMARK_LAYERS; ++i) {
+                renderer.draw(texture, layer(pack_color(CIRCLE_TINT)));
+            }
+            renderer.set_color_key(circle.dimensions, std::nullopt);
+        });
+
+        std::cout << threads << " threads:\n";
+        for (const auto& [workload, seconds] : {gouraud, textured}) {
+            const double pixels = double{SCREEN_WIDTH} * SCREEN_HEIGHT *
+                                  SOFTWARE_BENCHMARK_LAYERS;
+            std::cout << "    " << workload << ": " << seconds * 1e3
+                      << " ms per frame, " << pixels / 1e6 / seconds
+                      << " Mpixels/s\n";
+        }
+
+        const auto scene = time("scene", [&]() {
+            draw_scene(renderer, texture, circle.dimensions, true);
+        });
+        std::cout << "    " << scene.first << ": " << scene.second * 1e3
+                  << " ms per frame\n";
+    }
+
+    return true;
+}
+
+bool
+compare_software(std::string_view path)
+{
+    // renderers without shaders draw the circle keyed on the CPU, so both
+    // sides get the same pixels
+    limage circle;
+    if (!decode_image(path, circle)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+    const bool keyed = g_renderer->supports_color_key();
+    if (!keyed) {
+        transform(
+            lpixel_view<GLuint>(circle.pixels.get(), circle.dimensions),
+            [](GLuint pixel) {
+                // cyan, red in the lowest byte
+                return (pixel & 0x00ffffffu) == 0x00ffff00u ? 0x00ffffffu
+                                                            : pixel;
+            });
+    }
+
+    ltexture texture;
+    if (!texture.load_from_pixels(
+            circle.pixels.get(), circle.dimensions, PIXEL_FORMAT_RGBA8)) {
+        return false;
+    }
+
+    lsoft_renderer software({SCREEN_WIDTH, SCREEN_HEIGHT});
+    const GLuint   software_texture = software.add_texture(
+        lpixel_view<const GLuint>(circle.pixels.get(), circle.dimensions));
+
+    const auto projection = g_renderer->projection();
+    const auto view       = g_renderer->view();
+    bool       matching   = true;
+
+    // the scene of render, without the cached backdrop
+    glClearColor(
+        Rc(BACKDROP_COLOR),
+        Gc(BACKDROP_COLOR),
+        Bc(BACKDROP_COLOR),
+        Ac(BACKDROP_COLOR));
+    glClear(GL_COLOR_BUFFER_BIT);
+    draw_scene(
+        *g_renderer, texture.get_texture_id(), circle.dimensions, keyed);
+    software.clear(BACKDROP_COLOR);
+    draw_scene(software, software_texture, circle.dimensions, keyed);
+    std::cout << "scene: ";
+    matching &= compare_frames(read_screen(), software.pixels());
+
+    // Gouraud shaded quads of the polygons tutorial
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+    for (const GLfloat scale : POLYGON_SCALES) {
+        for (const bool multi_colored : {false, true}) {
+            glClear(GL_COLOR_BUFFER_BIT);
+            draw_polygon(*g_renderer, scale, multi_colored);
+            software.clear({0.f, 0.f, 0.f, 1.f});
+            draw_polygon(software, scale, multi_colored);
+
+            std::cout << (multi_colored ? "multi-colored" : "cyan")
+                      << " quad at scale " << scale << ": ";
+            matching &= compare_frames(read_screen(), software.pixels());
+        }
+    }
+
+    g_renderer->set_camera(projection, view);
+    return gl_errors_flush("compare_software") == 0 && matching;
+}
+
+bool
+benchmark_uploads(std::string_view path)
+{
+    // decoding is not timed, it would happen off the frame either way
+    limage image;
+    if (!decode_image(path, image)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+    const std::size_t pixel_count =
+        std::size_t{Wv(image.dimensions)} * Hv(image.dimensions);
+
+    for (const bool queued : {false, true}) {
+        std::array<ltexture, UPLOAD_BENCHMARK_TEXTURES> textures;
+        lupload_queue                                   uploads(UPLOAD_BUDGET);
+
+        // the queue takes the pixels of every texture
+        std::vector<limage> copies;
+        for (std::size_t i = 0; queued && i < textures.size(); ++i) {
+            limage copy{make_pixel_buffer(pixel_count), image.dimensions};
+            std::copy_n(image.pixels.get(), pixel_count, copy.pixels.get());
+            copies.push_back(std::move(copy));
+        }
+
+        std::size_t         ready       = 0;
+        int                 ready_frame = 0;
+        std::vector<double> frame_ms;
+        for (int frame = 0; frame < UPLOAD_BENCHMARK_FRAMES; ++frame) {
+            const auto start = std::chrono::steady_clock::now();
+
+            // textures needed mid-game, all at once
+            if (frame == UPLOAD_BENCHMARK_START) {
+                for (std::size_t i = 0; i < textures.size(); ++i) {
+                    if (!queued) {
+                        textures[i].load_from_pixels(
+                            image.pixels.get(),
+                            image.dimensions,
+                            PIXEL_FORMAT_RGBA8);
+                        ready_frame = frame;
+                    } else if (!uploads.enqueue(
+                                   textures[i],
+                                   std::move(copies[i]),
+                                   [&ready, &ready_frame, &frame](ltexture&) {
+                                       ++ready;
+                                       ready_frame = frame;
+                                   })) {
+                        return false;
+                    }
+                }
+            }
+            uploads.update();
+
+            update();
+            render();
+            glFinish();
+
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            frame_ms.push_back(elapsed.count());
+        }
+
+        if (queued && ready != textures.size()) {
+            std::cerr << "uploads did not finish in "
+                      << UPLOAD_BENCHMARK_FRAMES << " frames\n";
+            return false;
+        }
+
+        std::sort(frame_ms.begin(), frame_ms.end());
+        std::cout << (queued ? "queued" : "synchronous") << " uploads of "
+                  << textures.size() << ' ' << Wv(image.dimensions) << 'x'
+                  << Hv(image.dimensions) << " textures: frame ms p50 "
+                  << percentile(frame_ms, 50.) << ", p95 "
+                  << percentile(frame_ms, 95.) << ", p99 "
+                  << percentile(frame_ms, 99.) << ", max " << frame_ms.back()
+                  << ", ready " << ready_frame - UPLOAD_BENCHMARK_START
+                  << " frames after the request\n";
+    }
+
+    return true;
+}
+
+bool
+benchmark_formats(std::string_view path)
+{
+    limage image;
+    if (!decode_image(path, image)) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+    const std::size_t pixel_count =
+        std::size_t{Wv(image.dimensions)} * Hv(image.dimensions);
+
+    // average ms of the passes of given work
+    const auto time_passes = [](auto&& work) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < FORMAT_BENCHMARK_PASSES; ++pass) work();
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return elapsed.count() / FORMAT_BENCHMARK_PASSES;
+    };
+
+    std::cout << "uploads of " << Wv(image.dimensions) << 'x'
+              << Hv(image.dimensions) << " pixels, ms per pass:\n";
+    for (const auto format : {PIXEL_FORMAT_RGBA8,
+                              PIXEL_FORMAT_R8,
+                              PIXEL_FORMAT_RG8,
+                              PIXEL_FORMAT_RGB565,
+                              PIXEL_FORMAT_RGBA16F}) {
+        const auto&          info = pixel_format_info(format);
+        std::vector<GLubyte> converted(pixel_count * info.bytes_per_pixel);
+
+        const double convert_ms = time_passes([&]() {
+            convert_pixels(
+                image.pixels.get(),
+                PIXEL_FORMAT_RGBA8,
+                converted.data(),
+                format,
+                pixel_count);
+        });
+
+        // untimed first upload, formats GL lacks end up as RGBA8 and there
+        // is nothing to compare
+        ltexture texture;
+        if (!texture.load_from_pixels(
+                converted.data(), image.dimensions, format)) {
+            return false;
+        }
+        glFinish();
+        if (texture.get_format() != format) continue;
+
+        // pixels already in the upload format, as from an asset pack, the
+        // first passes warm up the driver allocations
+        const auto upload = [&]() {
+            texture.load_from_pixels(
+                converted.data(), image.dimensions, format);
+            glFinish();
+        };
+        time_passes(upload);
+        const double upload_ms = time_passes(upload);
+
+        // decoded RGBA8 pixels, converted on the way
+        const double load_ms = time_passes([&]() {
+            texture.load_from_pixels32(
+                image.pixels.get(), image.dimensions, format);
+            glFinish();
+        });
+
+        std::cout << info.name << ": convert " << convert_ms << ", upload "
+                  << upload_ms << ", convert and upload " << load_ms << ", "
+                  << converted.size() << " client bytes, "
+                  << texture.memory_size() << " texture bytes\n";
+    }
+
+    return gl_errors_flush("benchmark_formats") == 0;
+}
+
+bool
+benchmark_loads()
+{
+    // every allocation from the heap, the default pool and a level arena
+    lpool_allocator  heap(0);
+    larena_allocator arena;
+    const std::array<std::pair<const char*, lpixel_allocator*>, 3> modes = {
+        {{"heap", &heap}, {"pool", &pixel_allocator()}, {"arena", &arena}}};
+
+    // peak resident set size of the process in KiB, it never goes down, so
+    // a mode only raises it by what it needs beyond the modes before it
+    const auto max_rss = []() {
+        rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    };
+
+    for (const auto& [name, allocator] : modes) {
+        const auto before     = allocator->stats();
+        const auto rss_before = max_rss();
+        set_pixel_allocator(allocator);
+        auto _ = gsl::finally([]() { set_pixel_allocator(nullptr); });
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < LOAD_BENCHMARK_PASSES; ++pass) {
+            std::array<ltexture, LOAD_BENCHMARK_PATHS.size()> textures;
+            for (std::size_t i = 0; i < textures.size(); ++i) {
+                if (!textures[i].load_from_file_with_color_key(
+                        LOAD_BENCHMARK_PATHS[i], CIRCLE_COLOR_KEY)) {
+                    return false;
+                }
+            }
+            arena.reset();
+        }
+        glFinish();
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        const auto stats = allocator->stats();
+        std::cout << name << ": "
+                  << elapsed.count() / LOAD_BENCHMARK_PASSES
+                  << " ms per pass, "
+                  << stats.allocations - before.allocations
+                  << " allocations, "
+                  << stats.system_allocations - before.system_allocations
+                  << " from the system, peak " << stats.peak_bytes_in_use
+                  << " bytes in use, process peak RSS " << max_rss()
+                  << " KiB (+" << max_rss() - rss_before << ')';
+        if (allocator == &arena) {
+            std::cout << ", " << arena.capacity() * sizeof(GLuint)
+                      << " bytes reserved";
+        }
+        std::cout << '\n';
+    }
+
+    return gl_errors_flush("benchmark_loads") == 0;
+}
+
+bool
+benchmark_packs()
+{
+    // copies of the benchmark images as files and as assets of one pack
+    const std::string pack_path = std::string(PACK_BENCHMARK_PREFIX) + ".pack";
+    std::vector<std::string>   files;
+    std::vector<lasset_source> sources;
+    auto _ = gsl::finally([&files, &pack_path]() {
+        for (const auto& path : files) std::remove(path.c_str());
+        std::remove(pack_path.c_str());
+    });
+
+    for (const auto path : LOAD_BENCHMARK_PATHS) {
+        limage image;
+        if (!decode_image(path, image)) {
+            std::cerr << "unable to load " << path << '\n';
+            return false;
+        }
+        const auto*       bytes = reinterpret_cast<const GLubyte*>(
+            image.pixels.get());
+        const std::size_t size  = std::size_t{Wv(image.dimensions)} *
+                                 Hv(image.dimensions) * sizeof(GLuint);
+
+        for (std::size_t copy = 0; copy < PACK_BENCHMARK_COPIES; ++copy) {
+            const std::string name =
+                std::to_string(copy) + '_' +
+                std::string(path.substr(path.find_last_of('/') + 1));
+            files.push_back(std::string(PACK_BENCHMARK_PREFIX) + '_' + name);
+            if (!copy_file(path, files.back())) {
+                std::cerr << "unable to write " << files.back() << '\n';
+                return false;
+            }
+            sources.push_back(
+                {name,
+                 PIXEL_FORMAT_RGBA8,
+                 image.dimensions,
+                 {bytes, bytes + size}});
+        }
+    }
+    if (!write_asset_pack(pack_path, std::move(sources))) return false;
+
+    // every asset into a texture, as a level would load them
+    const auto load_files = [&files]() {
+        std::vector<ltexture> textures(files.size());
+        for (std::size_t i = 0; i < files.size(); ++i) {
+            if (!textures[i].load_from_file(files[i])) return false;
+        }
+        glFinish();
+        return true;
+    };
+    const auto load_pack = [&pack_path]() {
+        lasset_pack pack;
+        if (!pack.open(pack_path)) return false;
+        std::vector<ltexture> textures(pack.size());
+        for (std::size_t i = 0; i < pack.size(); ++i) {
+            if (!textures[i].load_from_asset(pack.at(i))) return false;
+        }
+        glFinish();
+        return true;
+    };
+
+    // each mode is loaded cold right after its pages were dropped, then
+    // warm from the pages the cold load read
+    bool evicted = true;
+    std::array<std::chrono::duration<double, std::milli>, 4> elapsed = {};
+    for (int pass = 0; pass < PACK_BENCHMARK_PASSES; ++pass) {
+        for (std::size_t mode = 0; mode < 2; ++mode) {
+            const bool from_pack = mode == 1;
+            if (from_pack) {
+                evicted = evict_from_page_cache(pack_path) && evicted;
+            } else {
+                for (const auto& path : files) {
+                    evicted = evict_from_page_cache(path) && evicted;
+                }
+            }
+
+            for (std::size_t warm = 0; warm < 2; ++warm) {
+                const auto start = std::chrono::steady_clock::now();
+                if (!(from_pack ? load_pack() : load_files())) return false;
+                elapsed[mode * 2 + warm] +=
+                    std::chrono::steady_clock::now() - start;
+            }
+        }
+    }
+
+    if (!evicted) {
+        std::cerr << "unable to drop cached pages, cold loads may be warm\n";
+    }
+    const std::array<const char*, 2> names = {"files", "pack"};
+    for (std::size_t mode = 0; mode < names.size(); ++mode) {
+        std::cout << names[mode] << ": " << files.size() << " assets, cold "
+                  << elapsed[mode * 2].count() / PACK_BENCHMARK_PASSES
+                  << " ms, warm "
+                  << elapsed[mode * 2 + 1].count() / PACK_BENCHMARK_PASSES
+                  << " ms per load\n";
+    }
+
+    return gl_errors_flush("benchmark_packs") == 0;
+}
+
+bool
+benchmark_decoders()
+{
+    // the tutorial textures and a generated corpus of large images
+    std::vector<std::string> generated;
+    {
+        limage grass;
+        if (!decode_image(LOAD_BENCHMARK_PATHS.back(), grass)) {
+            std::cerr << "unable to load " << LOAD_BENCHMARK_PATHS.back()
+                      << '\n';
+            return false;
+        }
+        if (!write_decode_corpus(grass, generated)) return false;
+    }
+    auto _ = gsl::finally([&generated]() {
+        for (const auto& path : generated) std::remove(path.c_str());
+    });
+
+    const std::vector<std::string> textures(
+        LOAD_BENCHMARK_PATHS.begin(), LOAD_BENCHMARK_PATHS.end());
+    const std::array<std::pair<const char*, const std::vector<std::string>*>, 2>
+        corpora = {{{"textures", &textures}, {"generated", &generated}}};
+
+    // files are decoded once untimed first, so all of them come from the
+    // page cache
+    std::cout << "decodes of every file a backend accepts, "
+              << DECODE_BENCHMARK_PASSES << " passes:\n";
+    for (const limage_decoder* decoder : image_decoders()) {
+        for (const auto& [corpus, paths] : corpora) {
+            std::size_t file_bytes  = 0;
+            std::size_t pixel_bytes = 0;
+            std::size_t files       = 0;
+
+            std::chrono::duration<double> elapsed{0};
+
+            for (const auto& path : *paths) {
+                // header picks the files, as decode_image does
+                unsigned char header[16] = {0};
+                std::size_t   size       = 0;
+                long          length     = 0;
+                if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+                    size = std::fread(header, 1, sizeof(header), file);
+                    std::fseek(file, 0, SEEK_END);
+                    length = std::ftell(file);
+                    std::fclose(file);
+                }
+
+                limage image;
+                if (!decoder->accepts(header, size) ||
+                    !decoder->decode(path, image)) {
+                    continue;
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                for (int pass = 0; pass < DECODE_BENCHMARK_PASSES; ++pass) {
+                    if (!decoder->decode(path, image)) return false;
+                }
+                elapsed += std::chrono::steady_clock::now() - start;
+
+                ++files;
+                file_bytes += gsl::narrow<std::size_t>(length);
+                pixel_bytes += std::size_t{Wv(image.dimensions)} *
+                               Hv(image.dimensions) * sizeof(GLuint);
+            }
+
+            std::cout << decoder->name() << " on " << corpus << ": " << files
+                      << " files";
+            if (files != 0) {
+                // MB per second of the passes
+                const double scale = DECODE_BENCHMARK_PASSES /
+                                     (1024. * 1024. * elapsed.count());
+                std::cout << ", " << static_cast<double>(file_bytes) * scale
+                          << " MB/s read, "
+                          << static_cast<double>(pixel_bytes) * scale
+                          << " MB/s decoded";
+            }
+            std::cout << '\n';
+        }
+    }
+
+    return true;
+}
+
+bool
+benchmark_error_checks()
+{
+    // decoding is not timed, only uploads and their error checks
+    std::array<limage, LOAD_BENCHMARK_PATHS.size()> images;
+    for (std::size_t i = 0; i < images.size(); ++i) {
+        if (!decode_image(LOAD_BENCHMARK_PATHS[i], images[i])) {
+            std::cerr << "unable to load " << LOAD_BENCHMARK_PATHS[i] << '\n';
+            return false;
+        }
+    }
+
+    // errors latched before the benchmark would be counted against the
+    // first per upload check
+    gl_errors_flush("before benchmark_error_checks");
+
+    // per upload checks first, then one batched flush
+    const std::array<const char*, 2> names = {
+        "glGetError per upload", "batched flush"};
+    std::array<std::chrono::duration<double, std::milli>, 2> uploads = {};
+    std::array<std::chrono::duration<double, std::micro>, 2> checks  = {};
+    std::array<std::size_t, 2>                               errors  = {};
+
+    // modes alternate every pass, so driver warm-up and memory reuse do not
+    // favor the one timed last
+    for (int pass = 0; pass < LOAD_BENCHMARK_PASSES; ++pass) {
+        for (std::size_t mode = 0; mode < names.size(); ++mode) {
+            const bool per_upload = mode == 0;
+
+            // times the error check of the uploads before it
+            const auto check = [&]() {
+                const auto start = std::chrono::steady_clock::now();
+                if (per_upload) {
+                    // the check ltexture made after every upload
+                    if (glGetError() != GL_NO_ERROR) ++errors[mode];
+                } else {
+                    errors[mode] += gl_errors_flush("benchmark_error_checks");
+                }
+                checks[mode] += std::chrono::steady_clock::now() - start;
+            };
+
+            const auto start = std::chrono::steady_clock::now();
+            {
+                std::array<ltexture, LOAD_BENCHMARK_PATHS.size()> textures;
+                for (std::size_t i = 0; i < textures.size(); ++i) {
+                    if (!textures[i].load_from_pixels(
+                            images[i].pixels.get(),
+                            images[i].dimensions,
+                            PIXEL_FORMAT_RGBA8)) {
+                        return false;
+                    }
+                    if (per_upload) check();
+                }
+                if (!per_upload) check();
+            }
+            glFinish();
+            uploads[mode] += std::chrono::steady_clock::now() - start;
+        }
+    }
+
+    for (std::size_t mode = 0; mode < names.size(); ++mode) {
+        std::cout << names[mode] << ": "
+                  << uploads[mode].count() / LOAD_BENCHMARK_PASSES
+                  << " ms per pass, checks took "
+                  << checks[mode].count() / LOAD_BENCHMARK_PASSES
+                  << " us per pass, " << errors[mode] << " errors\n";
+    }
+
+    return gl_errors_flush("benchmark_error_checks") == 0;
+}
+
+bool
+benchmark_capture(std::string_view prefix)
+{
+    if (!lcapture::supported()) {
+        std::cerr << "unable to capture without pixel buffer objects\n";
+        return false;
+    }
+
+    // frame times of the scene alone to compare against
+    auto frame_ms = time_frames(CAPTURE_BENCHMARK_FRAMES);
+    std::cout << "no capture: frame ms p50 " << percentile(frame_ms, 50.)
+              << ", p99 " << percentile(frame_ms, 99.) << ", max "
+              << frame_ms.back() << '\n';
+
+    for (const auto format :
+         {CAPTURE_FORMAT_RAW, CAPTURE_FORMAT_QOI, CAPTURE_FORMAT_PNG}) {
+        if (!lcapture::format_supported(format)) continue;
+
+        const char* name = format == CAPTURE_FORMAT_RAW   ? "raw"
+                           : format == CAPTURE_FORMAT_QOI ? "qoi"
+                                                          : "png";
+        for (const bool synchronous : {true, false}) {
+            g_capture.reset_stats();
+            g_capture.set_synchronous(synchronous);
+            if (!g_capture.start_recording(
+                    std::string(prefix) + name + '_', format)) {
+                return false;
+            }
+            frame_ms = time_frames(CAPTURE_BENCHMARK_FRAMES);
+            g_capture.stop_recording();
+
+            // frames still reading or encoding when recording stopped
+            const auto start = std::chrono::steady_clock::now();
+            g_capture.finish();
+            const std::chrono::duration<double, std::milli> drain =
+                std::chrono::steady_clock::now() - start;
+
+            std::cout << (synchronous ? "synchronous " : "asynchronous ")
+                      << name << " recording: frame ms p50 "
+                      << percentile(frame_ms, 50.) << ", p99 "
+                      << percentile(frame_ms, 99.) << ", max "
+                      << frame_ms.back() << ", " << drain.count()
+                      << " ms to drain\n";
+            print_capture_stats(g_capture.stats());
+        }
+    }
+
+    g_capture.set_synchronous(false);
+    return true;
 }
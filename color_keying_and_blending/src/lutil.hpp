@@ -14,28 +14,31 @@ constexpr int SCREEN_FPS    = 60;
 pre-conditions:
     * a valid OpenGL context
 post-conditions:
-    * initializes matrices and clear color
+    * picks the programmable renderer if requested and supported, the
+      fixed-function one otherwise
+    * draws sprites instanced if requested and supported
+    * sets up the renderer camera and clear color
+    * sets up GL error reporting, see lgl_errors.hpp
     * reports to console if there was an OpenGL error
     * returns false if there was an error in initialization
 side-effects:
-    * projection matrix is set to identity matrix
-    * Modelview matrix is set to identity matrix
-    * matrix mode is set to modelview
     * clear color is set to black
-    * texturing is enabled
+    * blending is enabled
 */
-bool initGL();
+bool initGL(bool programmable = true, bool instancing = true);
 
 /*
 pre-conditions:
     * a valid OpenGL context
 post-conditions:
     * loads media to use in the program
+    * color keys images with the renderer if requested and supported,
+      otherwise rewrites their pixels on the CPU
     * reports to console if there was an error in loading the media
     * returns true if the media loaded successfully
 side-effects: n/a
 */
-bool load_media(std::string_view path);
+bool load_media(std::string_view path, bool gpu_color_key = true);
 
 /*
 pre-conditions: n/a
@@ -48,13 +51,173 @@ void update();
 /*
 pre-conditions:
     * a valid OpenGL context
-    * active modelview matrix
+    * initGL succeeded
 post-conditions:
     * renders the scene
+    * captures the frame if a screenshot or recording wants it
 side-effects:
     * clears the color buffer
     * swaps the front/back buffer
+    * reports GL errors of the frame
+    * ends the frame of the GL call counters
 */
 void render();
 
+/*
+pre-conditions:
+    * a valid OpenGL context
+post-conditions:
+    * saves the next frame as a screenshot when the user presses p, PNG if
+      libpng is available and QOI otherwise
+    * starts recording every frame as QOI when the user presses r, stops
+      and reports capture stats to console on the next press
+side-effects: n/a
+*/
+void handle_keys(unsigned char key, int x, int y);
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * load_media succeeded
+post-conditions:
+    * renders frames which need copies of the image at given path mid-game,
+      once uploading them at once and once through an upload queue
+    * reports frame time percentiles of both to console
+    * returns false if the image could not be loaded
+side-effects:
+    * see render
+*/
+bool benchmark_uploads(std::string_view path);
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+post-conditions:
+    * uploads the image at given path in every supported pixel format, from
+      pixels already in the format and from RGBA8 pixels converted first
+    * reports conversion and upload times, client bytes and the texture
+      bytes GL reports of every format to console
+    * returns false if the image could not be loaded or GL reported errors
+side-effects:
+    * binds a null-texture
+*/
+bool benchmark_formats(std::string_view path);
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initialized DevIL, for files no other decoder accepts
+post-conditions:
+    * loads the same set of color keyed textures repeatedly with pixels from
+      the heap, the default pool and an arena reset after every pass
+    * reports load times, allocation counts and process peak RSS after each
+      to console
+    * returns false if an image could not be loaded or GL reported errors
+side-effects:
+    * binds a null-texture
+*/
+bool benchmark_loads();
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initialized DevIL, for files no other decoder accepts
+post-conditions:
+    * writes copies of the load benchmark images to the working directory,
+      as files and as one asset pack of decoded pixels, removes them when
+      done
+    * loads all of them into textures from the files and from the pack,
+      each once after dropping its pages from the page cache and once again
+      right after
+    * reports cold and warm load times of both to console
+    * returns false if the copies could not be written or loaded, or GL
+      reported errors
+side-effects:
+    * binds a null-texture
+*/
+bool benchmark_packs();
+
+/*
+pre-conditions:
+    * initialized DevIL
+post-conditions:
+    * writes large images tiled from grass.jpg to the working directory in
+      the formats encoders are built in for, removes them when done
+    * decodes the tutorial textures and the large images with every
+      decoder backend, each file it accepts repeatedly
+    * reports compressed and decoded MB/s of every backend to console
+    * returns false if the images could not be written or decoded
+side-effects: n/a
+*/
+bool benchmark_decoders();
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initialized DevIL, for files no other decoder accepts
+post-conditions:
+    * uploads the same set of textures repeatedly, once calling glGetError
+      after every upload and once flushing errors after each set
+    * reports upload and error check times of both to console
+    * returns false if an image could not be loaded or GL reported errors
+side-effects:
+    * binds a null-texture
+*/
+bool benchmark_error_checks();
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * load_media succeeded
+post-conditions:
+    * records frames to files starting with given prefix in every supported
+      format, once reading back and encoding on the GL thread and once
+      through pack buffers and the encoder thread
+    * reports frame time percentiles, dropped frames and encoder throughput
+      of both to console
+    * returns false if capture is not available
+side-effects:
+    * see render
+*/
+bool benchmark_capture(std::string_view prefix);
+
+/*
+pre-conditions:
+    * no GL context needed
+post-conditions:
+    * renders the scene with the software renderer and writes it to the
+      given path as a binary PPM
+    * reports rasterizer throughput to console
+side-effects: n/a
+*/
+bool render_software(std::string_view path, std::string_view output);
+
+/*
+pre-conditions:
+    * no GL context needed
+post-conditions:
+    * times the software renderer on full screen Gouraud shaded quads,
+      textured and color keyed quads and the scene, on one thread and on one
+      per hardware thread
+    * reports frame times and throughput to console
+    * returns false if the image at given path could not be loaded
+side-effects: n/a
+*/
+bool benchmark_software(std::string_view path);
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+post-conditions:
+    * renders the scene and the quads of the polygons tutorial with the GL
+      renderer and the software renderer, reads back the GL frames
+    * reports the largest channel difference and the pixels differing more
+      than the tolerance per frame to console
+    * returns false if any pixel differs more than the tolerance or GL
+      reported errors
+side-effects:
+    * clears the screen, binds a null-texture
+*/
+bool compare_software(std::string_view path);
+
 #endif // LUTIL_HPP
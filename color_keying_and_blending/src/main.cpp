@@ -1,6 +1,8 @@
+#include "lgl_stats.hpp"
 #include "lutil.hpp"
 
 #include <cstdlib> // for EXIT_SUCCESS and EXIT_FAILURE
+#include <string_view>
 
 /*
 pre-condition:
@@ -21,32 +23,119 @@ make diagonal stripe pattern on it.
 int
 main(int argc, char** args)
 {
+    // --software <image.ppm> renders with the CPU rasterizer, without a
+    // window or GPU
+    if (argc == 3 && std::string_view(args[1]) == "--software") {
+        return render_software("../textures/circle.png", args[2])
+                   ? EXIT_SUCCESS
+                   : EXIT_FAILURE;
+    }
+
+    // --software-benchmark times the CPU rasterizer on one and all threads
+    if (argc == 2 && std::string_view(args[1]) == "--software-benchmark") {
+        return benchmark_software("../textures/circle.png") ? EXIT_SUCCESS
+                                                            : EXIT_FAILURE;
+    }
+
+    // --gl-stats <file.csv> logs GL calls and bytes of every frame, builds
+    // without LGL_STATS refuse it
+    if (argc == 3 && std::string_view(args[1]) == "--gl-stats" &&
+        !gl_stats_open_log(args[2])) {
+        return EXIT_FAILURE;
+    }
+
     // initialize freeGLUT
     glutInit(&argc, args);
 
     // create opengl 2.1 context
     glutInitContextVersion(2, 1);
 
+#ifndef LGL_NO_ERROR_CHECKS
+    // debug contexts report errors through KHR_debug callbacks
+    glutInitContextFlags(GLUT_DEBUG);
+#endif
+
     // create double-buffered window
     glutInitDisplayMode(GLUT_DOUBLE);
     glutInitWindowSize(SCREEN_WIDTH, SCREEN_HEIGHT);
     glutCreateWindow("Color keying and blending");
 
-    // do post window/context creation initialization
-    if (!initGL()) {
+    // do post window/context creation initialization, --fixed-function
+    // renders without shaders and --no-instancing expands sprites on the CPU
+    // to compare frame times
+    const bool fixed_function =
+        argc == 2 && std::string_view(args[1]) == "--fixed-function";
+    const bool no_instancing =
+        argc == 2 && std::string_view(args[1]) == "--no-instancing";
+    if (!initGL(!fixed_function, !no_instancing)) {
         std::cerr << "unable to initialize graphics library\n";
         return EXIT_FAILURE;
     }
 
-    // load media
-    if (!load_media("../textures/circle.png")) {
+    // load media, --cpu-key keys images on the CPU to compare load times
+    const bool cpu_key = argc == 2 && std::string_view(args[1]) == "--cpu-key";
+    if (!load_media("../textures/circle.png", !cpu_key)) {
         std::cerr << "unable to load media\n";
         return EXIT_FAILURE;
     }
 
+    // --software-parity compares frames of the software renderer with GL
+    // readbacks, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--software-parity") {
+        return compare_software("../textures/circle.png") ? EXIT_SUCCESS
+                                                          : EXIT_FAILURE;
+    }
+
+    // --upload-benchmark compares frame times of uploading textures at once
+    // and through the upload queue, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--upload-benchmark") {
+        return benchmark_uploads("../textures/grass.jpg") ? EXIT_SUCCESS
+                                                          : EXIT_FAILURE;
+    }
+
+    // --format-benchmark compares conversion, upload times and texture sizes
+    // of the pixel formats, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--format-benchmark") {
+        return benchmark_formats("../textures/grass.jpg") ? EXIT_SUCCESS
+                                                          : EXIT_FAILURE;
+    }
+
+    // --load-benchmark compares load times and allocations of pixels taken
+    // from the heap, the pool and an arena, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--load-benchmark") {
+        return benchmark_loads() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --pack-benchmark compares cold and warm load times of assets from
+    // files and from an asset pack, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--pack-benchmark") {
+        return benchmark_packs() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --decode-benchmark compares decode throughput of the image decoder
+    // backends, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--decode-benchmark") {
+        return benchmark_decoders() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --error-check-benchmark compares upload times with glGetError after
+    // every upload and with one batched error flush, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--error-check-benchmark") {
+        return benchmark_error_checks() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --capture-benchmark <prefix> compares frame times of recording frames
+    // on the GL thread and through pack buffers, then exits
+    if (argc == 3 && std::string_view(args[1]) == "--capture-benchmark") {
+        return benchmark_capture(args[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // set rendering function
     glutDisplayFunc(render);
 
+    // set keyboard handler, p saves a screenshot and r toggles recording
+    glutKeyboardFunc(handle_keys);
+
     // set main loop
     glutTimerFunc(1000 / SCREEN_FPS, run_main_loop, 0);
 
@@ -0,0 +1,140 @@
+#include <cstdlib> // for EXIT_SUCCESS, EXIT_FAILURE and std::strtoul
+#include <optional>
+#include <string_view>
+
+#include <IL/il.h>
+
+#include "lasset_pack.hpp"
+#include "limage_decoder.hpp"
+#include "lpixel_view.hpp"
+#include "macro_helpers.hpp"
+
+namespace {
+
+void
+usage()
+{
+    std::cerr << "usage: make_asset_pack <pack> [[-f format] [-k rrggbb] "
+                 "image]...\n"
+                 "    -f  format of following images: RGBA8 (default), R8, "
+                 "RG8, RGB565, RGBA16F\n"
+                 "    -k  make following images transparent where they have "
+                 "the given color\n";
+}
+
+std::optional<lpixel_format>
+parse_format(std::string_view name)
+{
+    for (auto format :
+         {PIXEL_FORMAT_RGBA8,
+          PIXEL_FORMAT_R8,
+          PIXEL_FORMAT_RG8,
+          PIXEL_FORMAT_RGB565,
+          PIXEL_FORMAT_RGBA16F}) {
+        if (name == pixel_format_info(format).name) return format;
+    }
+    return std::nullopt;
+}
+
+// same rule as ltexture::load_from_file_with_color_key
+void
+apply_color_key(limage& image, std::array<GLubyte, 3> rgb)
+{
+    transform(
+        lpixel_view<GLuint>(image.pixels.get(), image.dimensions),
+        [rgb](GLuint pixel) {
+            GLubyte* colors = reinterpret_cast<GLubyte*>(&pixel);
+            if (Rc(colors) == Rc(rgb) && Gc(colors) == Gc(rgb) &&
+                Bc(colors) == Bc(rgb)) {
+                return GLuint{0x00ffffff};
+            }
+            return pixel;
+        });
+}
+
+// asset name is the file name without directories
+std::string
+asset_name(std::string_view path)
+{
+    const auto slash = path.find_last_of('/');
+    return std::string(
+        slash == std::string_view::npos ? path : path.substr(slash + 1));
+}
+
+} // namespace
+
+/*
+Builds an asset pack from image files: decodes them, applies color keys and
+converts them to their pack format up front, so loading the pack is a single
+mapping with no decoding.
+*/
+int
+main(int argc, char** args)
+{
+    if (argc < 3) {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    // DevIL decodes formats the built-in decoders lack
+    ilInit();
+
+    std::vector<lasset_source>            sources;
+    lpixel_format                         format = PIXEL_FORMAT_RGBA8;
+    std::optional<std::array<GLubyte, 3>> color_key;
+
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = args[i];
+
+        // options apply to the images after them
+        if ((arg == "-f" || arg == "-k") && i + 1 == argc) {
+            usage();
+            return EXIT_FAILURE;
+        }
+        if (arg == "-f") {
+            auto parsed = parse_format(args[++i]);
+            if (!parsed) {
+                usage();
+                return EXIT_FAILURE;
+            }
+            format = *parsed;
+            continue;
+        }
+        if (arg == "-k") {
+            const auto rgb = std::strtoul(args[++i], nullptr, 16);
+            color_key      = std::array{
+                static_cast<GLubyte>(rgb >> 16 & 0xff),
+                static_cast<GLubyte>(rgb >> 8 & 0xff),
+                static_cast<GLubyte>(rgb & 0xff)};
+            continue;
+        }
+
+        limage image;
+        if (!decode_image(arg, image)) {
+            std::cerr << "unable to load " << arg << '\n';
+            return EXIT_FAILURE;
+        }
+        if (color_key) apply_color_key(image, *color_key);
+
+        lasset_source source;
+        source.name       = asset_name(arg);
+        source.format     = format;
+        source.dimensions = image.dimensions;
+
+        const auto count =
+            std::size_t{Wv(image.dimensions)} * Hv(image.dimensions);
+        source.pixels.resize(count * pixel_format_info(format).bytes_per_pixel);
+        convert_pixels(
+            image.pixels.get(),
+            PIXEL_FORMAT_RGBA8,
+            source.pixels.data(),
+            format,
+            count);
+
+        sources.push_back(std::move(source));
+    }
+
+    if (!write_asset_pack(args[1], std::move(sources))) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -1,10 +1,16 @@
 #include "lutil.hpp"
 
+#include "lmesh.hpp"
+
 namespace {
 
 static int     g_color_mode       = COLOR_MODE_CYAN;
 static GLfloat g_projection_scale = 1.f;
 
+// quad geometry per color mode, uploaded once
+static lmesh g_cyan_quad;
+static lmesh g_multi_quad;
+
 } // namespace
 
 bool
@@ -30,7 +36,23 @@ initGL()
         return false;
     }
 
-    return true;
+    // solid cyan
+    bool loaded = g_cyan_quad.load(
+        GL_QUADS,
+        {{{-50.f, -50.f}, {0.f, 1.f, 1.f}},
+         {{50.f, -50.f}, {0.f, 1.f, 1.f}},
+         {{50.f, 50.f}, {0.f, 1.f, 1.f}},
+         {{-50.f, 50.f}, {0.f, 1.f, 1.f}}});
+
+    // RYGB mix
+    loaded = loaded && g_multi_quad.load(
+                           GL_QUADS,
+                           {{{-50.f, -50.f}, {1.f, 0.f, 0.f}},
+                            {{50.f, -50.f}, {1.f, 1.f, 0.f}},
+                            {{50.f, 50.f}, {0.f, 1.f, 0.f}},
+                            {{-50.f, 50.f}, {0.f, 0.f, 1.f}}});
+
+    return loaded;
 }
 
 void
@@ -54,28 +76,9 @@ render()
 
     // render quad
     if (g_color_mode == COLOR_MODE_CYAN) {
-        // solid cyan
-        // clang-format off
-        glBegin(GL_QUADS);
-            glColor3f(0.f, 1.f, 1.f);
-            glVertex2f(-50.f, -50.f);
-            glVertex2f( 50.f, -50.f);
-            glVertex2f( 50.f,  50.f);
-            glVertex2f(-50.f,  50.f);
-        glEnd();
-        // clang-format on
+        g_cyan_quad.render();
     } else {
-        // RYGB mix
-        glBegin(GL_QUADS);
-        glColor3f(1.f, 0.f, 0.f);
-        glVertex2f(-50.f, -50.f);
-        glColor3f(1.f, 1.f, 0.f);
-        glVertex2f(50.f, -50.f);
-        glColor3f(0.f, 1.f, 0.f);
-        glVertex2f(50.f, 50.f);
-        glColor3f(0.f, 0.f, 1.f);
-        glVertex2f(-50.f, 50.f);
-        glEnd();
+        g_multi_quad.render();
     }
 
     glutSwapBuffers();
@@ -0,0 +1,146 @@
+#include "lmesh.hpp"
+
+#include <cstddef> // for offsetof
+#include <cstdio>  // for std::sscanf
+#include <utility>
+
+lmesh::lmesh() = default;
+
+lmesh::~lmesh()
+{
+    // free buffers if needed
+    free_mesh();
+}
+
+bool
+lmesh::vbo_supported()
+{
+    // buffer objects are core since OpenGL 1.5
+    auto version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    int  major   = 0;
+    int  minor   = 0;
+    if (!version || std::sscanf(version, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+
+    return major > 1 || (major == 1 && minor >= 5);
+}
+
+bool
+lmesh::load(
+    GLenum               mode,
+    std::vector<lvertex> vertices,
+    std::vector<GLuint>  indices,
+    bool                 use_buffers)
+{
+    // free mesh if it exists
+    free_mesh();
+
+    _mode  = mode;
+    _count = static_cast<GLsizei>(
+        indices.empty() ? vertices.size() : indices.size());
+
+    // immediate mode fallback keeps the geometry around
+    if (!use_buffers || !vbo_supported()) {
+        _vertices = std::move(vertices);
+        _indices  = std::move(indices);
+        return true;
+    }
+
+    // upload vertices
+    glGenBuffers(1, &_vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertex_buffer);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        static_cast<GLsizeiptr>(vertices.size() * sizeof(lvertex)),
+        vertices.data(),
+        GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // upload indices
+    if (!indices.empty()) {
+        glGenBuffers(1, &_index_buffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+        glBufferData(
+            GL_ELEMENT_ARRAY_BUFFER,
+            static_cast<GLsizeiptr>(indices.size() * sizeof(GLuint)),
+            indices.data(),
+            GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    // check for error
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "error creating mesh buffers: " << gluErrorString(error)
+                  << '\n';
+        free_mesh();
+        return false;
+    }
+
+    return true;
+}
+
+void
+lmesh::free_mesh()
+{
+    // delete buffers
+    if (_vertex_buffer != 0) {
+        glDeleteBuffers(1, &_vertex_buffer);
+        _vertex_buffer = 0;
+    }
+    if (_index_buffer != 0) {
+        glDeleteBuffers(1, &_index_buffer);
+        _index_buffer = 0;
+    }
+
+    _vertices.clear();
+    _indices.clear();
+    _count = 0;
+}
+
+void
+lmesh::render() const
+{
+    // immediate mode fallback
+    if (_vertex_buffer == 0) {
+        glBegin(_mode);
+        for (GLsizei i = 0; i < _count; ++i) {
+            const auto  index  = static_cast<std::size_t>(i);
+            const auto& vertex = _vertices[_indices.empty() ? index
+                                                            : _indices[index]];
+            glColor3f(vertex.color[0], vertex.color[1], vertex.color[2]);
+            glVertex2f(vertex.position[0], vertex.position[1]);
+        }
+        glEnd();
+        return;
+    }
+
+    // set interleaved vertex data
+    glBindBuffer(GL_ARRAY_BUFFER, _vertex_buffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(
+        2,
+        GL_FLOAT,
+        sizeof(lvertex),
+        reinterpret_cast<const void*>(offsetof(lvertex, position)));
+    glColorPointer(
+        3,
+        GL_FLOAT,
+        sizeof(lvertex),
+        reinterpret_cast<const void*>(offsetof(lvertex, color)));
+
+    // draw
+    if (_index_buffer != 0) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _index_buffer);
+        glDrawElements(_mode, _count, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        glDrawArrays(_mode, 0, _count);
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
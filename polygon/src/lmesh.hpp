@@ -0,0 +1,87 @@
+#ifndef LMESH_HPP
+#define LMESH_HPP
+
+#include "lopengl.hpp"
+
+#include <array>
+#include <vector>
+
+// interleaved vertex: position followed by color
+struct lvertex {
+    std::array<GLfloat, 2> position;
+    std::array<GLfloat, 3> color;
+};
+
+class lmesh {
+    // vertex and index buffer names, 0 while drawing from client memory
+    GLuint _vertex_buffer = {0};
+    GLuint _index_buffer  = {0};
+
+    // primitive type and number of vertices/indices to draw
+    GLenum  _mode  = {GL_QUADS};
+    GLsizei _count = {0};
+
+    // client copies, only kept for the immediate mode fallback
+    std::vector<lvertex> _vertices;
+    std::vector<GLuint>  _indices;
+
+public:
+    lmesh();
+    ~lmesh();
+
+    lmesh(const lmesh&) = delete;
+    lmesh& operator=(const lmesh&) = delete;
+
+    static bool vbo_supported();
+    /*
+    Pre Condition:
+     -A valid OpenGL context
+    Post Condition:
+     -Returns true if the context provides vertex buffer objects
+    Side Effects:
+     -None
+    */
+
+    bool load(
+        GLenum               mode,
+        std::vector<lvertex> vertices,
+        std::vector<GLuint>  indices     = {},
+        bool                 use_buffers = true);
+    /*
+    Pre Condition:
+     -A valid OpenGL context
+    Post Condition:
+     -Uploads the geometry once into vertex (and index) buffer objects
+     -Keeps the geometry in client memory if buffers are unsupported or
+      not wanted, the mesh is then drawn in immediate mode
+     -Without indices vertices are drawn in order
+     -Reports to console if there was an OpenGL error
+    Side Effects:
+     -Binds a null vertex and index buffer
+    */
+
+    void free_mesh();
+    /*
+    Pre Condition:
+     -A valid OpenGL context
+    Post Condition:
+     -Deletes buffers and client copies of the geometry
+    Side Effects:
+     -None
+    */
+
+    void render() const;
+    /*
+    Pre Condition:
+     -A valid OpenGL context
+     -Active modelview matrix
+    Post Condition:
+     -Draws the mesh with glDrawElements/glDrawArrays from buffers, or with
+      glBegin/glEnd in fallback mode
+    Side Effects:
+     -Binds a null vertex and index buffer
+     -Current color is left at the color of the last vertex
+    */
+};
+
+#endif // LMESH_HPP
@@ -1,5 +1,41 @@
 #include "lutil.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "lmesh.hpp"
+
+namespace {
+
+// quad geometry, uploaded once
+static lmesh g_quad;
+
+// grids of quads drawn by benchmark_meshes, cells per side, and indices
+// drawn per frame whatever the grid
+constexpr std::array<GLuint, 3> MESH_BENCHMARK_GRIDS   = {1, 8, 64};
+constexpr std::size_t           MESH_BENCHMARK_INDICES = 64 * 64 * 6;
+constexpr int                   MESH_BENCHMARK_FRAMES  = 100;
+
+// grids shrink to a few pixels so drawing costs vertices rather than fill
+constexpr GLfloat MESH_BENCHMARK_SCALE = 1.f / 32.f;
+
+bool load_grid(lmesh& mesh, GLuint cells, bool use_buffers);
+/*
+Pre Condition:
+ -A valid OpenGL context
+Post Condition:
+ -Loads a grid of given cells per side over the quad, two indexed triangles
+  per cell with colors blending across the grid
+ -Returns false if the mesh could not be loaded
+Side Effects:
+ -Binds a null vertex and index buffer
+*/
+
+} // namespace
+
 bool
 initGL()
 {
@@ -22,7 +58,14 @@ initGL()
         return false;
     }
 
-    return true;
+    // upload quad as two indexed triangles
+    return g_quad.load(
+        GL_TRIANGLES,
+        {{{-0.5f, -0.5f}, {1.f, 1.f, 1.f}},
+         {{0.5f, -0.5f}, {1.f, 1.f, 1.f}},
+         {{0.5f, 0.5f}, {1.f, 1.f, 1.f}},
+         {{-0.5f, 0.5f}, {1.f, 1.f, 1.f}}},
+        {0, 1, 2, 0, 2, 3});
 }
 
 void
@@ -38,14 +81,96 @@ render()
     glClear(GL_COLOR_BUFFER_BIT);
 
     // render quad
-    // clang-format off
-    glBegin(GL_QUADS);
-        glVertex2f(-0.5f, -0.5f);
-        glVertex2f( 0.5f, -0.5f);
-        glVertex2f( 0.5f,  0.5f);
-        glVertex2f(-0.5f,  0.5f);
-    glEnd();
-    // clang-format on
+    g_quad.render();
 
     glutSwapBuffers();
-}
\ No newline at end of file
+}
+
+bool
+benchmark_meshes()
+{
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glScalef(MESH_BENCHMARK_SCALE, MESH_BENCHMARK_SCALE, 1.f);
+
+    for (const auto cells : MESH_BENCHMARK_GRIDS) {
+        const std::size_t indices = std::size_t{cells} * cells * 6;
+        const std::size_t draws   = MESH_BENCHMARK_INDICES / indices;
+
+        for (const bool use_buffers : {false, true}) {
+            lmesh mesh;
+            if (!load_grid(mesh, cells, use_buffers)) return false;
+
+            // submission returns before the frame is drawn, the finish
+            // waits for it
+            double submit_ms = 0.0;
+            double frame_ms  = 0.0;
+            for (int frame = 0; frame < MESH_BENCHMARK_FRAMES; ++frame) {
+                const auto start = std::chrono::steady_clock::now();
+                glClear(GL_COLOR_BUFFER_BIT);
+                for (std::size_t draw = 0; draw < draws; ++draw) {
+                    mesh.render();
+                }
+                const auto submitted = std::chrono::steady_clock::now();
+                glFinish();
+                const auto end = std::chrono::steady_clock::now();
+
+                const std::chrono::duration<double, std::milli> submit =
+                    submitted - start;
+                const std::chrono::duration<double, std::milli> total =
+                    end - start;
+                submit_ms += submit.count();
+                frame_ms += total.count();
+            }
+            submit_ms /= MESH_BENCHMARK_FRAMES;
+            frame_ms /= MESH_BENCHMARK_FRAMES;
+
+            std::cout << cells << 'x' << cells << " grid, " << draws
+                      << " draws per frame, "
+                      << (use_buffers ? "buffers" : "immediate mode")
+                      << ": submit " << submit_ms << " ms, frame " << frame_ms
+                      << " ms, "
+                      << static_cast<double>(draws * indices) / frame_ms / 1e3
+                      << " M vertices/s\n";
+        }
+    }
+
+    glLoadIdentity();
+    return true;
+}
+
+namespace {
+
+bool
+load_grid(lmesh& mesh, GLuint cells, bool use_buffers)
+{
+    std::vector<lvertex> vertices;
+    std::vector<GLuint>  indices;
+    const GLuint         side = cells + 1;
+    const GLfloat        step = 1.f / static_cast<GLfloat>(cells);
+    for (GLuint y = 0; y < side; ++y) {
+        for (GLuint x = 0; x < side; ++x) {
+            const GLfloat u = static_cast<GLfloat>(x) * step;
+            const GLfloat v = static_cast<GLfloat>(y) * step;
+            vertices.push_back({{u - 0.5f, v - 0.5f}, {u, v, 1.f - u}});
+        }
+    }
+    for (GLuint y = 0; y < cells; ++y) {
+        for (GLuint x = 0; x < cells; ++x) {
+            const GLuint corner = y * side + x;
+            indices.insert(
+                indices.end(),
+                {corner,
+                 corner + 1,
+                 corner + side + 1,
+                 corner,
+                 corner + side + 1,
+                 corner + side});
+        }
+    }
+
+    return mesh.load(
+        GL_TRIANGLES, std::move(vertices), std::move(indices), use_buffers);
+}
+
+} // namespace
@@ -44,4 +44,19 @@ Side Effects:
  -Swaps the front/back buffer
 */
 
+bool benchmark_meshes();
+/*
+Pre Condition:
+ -A valid OpenGL context
+ -initGL succeeded
+Post Condition:
+ -Draws grids of 1 to 4096 small quads, the same number of vertices per
+  frame, in immediate mode and from buffers
+ -Reports submission and frame times of both to console
+ -Returns false if a mesh could not be loaded
+Side Effects:
+ -Clears the color buffer
+ -Binds a null vertex and index buffer
+*/
+
 #endif // LUTIL_HPP
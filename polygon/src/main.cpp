@@ -1,6 +1,7 @@
 #include "lutil.hpp"
 
 #include <cstdlib> // for EXIT_SUCCESS and EXIT_FAILURE
+#include <string_view>
 
 void run_main_loop(int);
 /*
@@ -31,6 +32,12 @@ main(int argc, char** args)
         return EXIT_FAILURE;
     }
 
+    // --mesh-benchmark compares drawing from buffers against immediate mode,
+    // then exits
+    if (argc == 2 && std::string_view(args[1]) == "--mesh-benchmark") {
+        return benchmark_meshes() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // set rendering function
     glutDisplayFunc(render);
 
@@ -0,0 +1,154 @@
+#ifndef LINPUT_LOG_HPP
+#define LINPUT_LOG_HPP
+
+#include "lopengl.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+/*
+Input log layout, all integers little-endian: the magic "LINP", a version
+and the frame rate it was recorded at (4 bytes each), followed by 12 byte
+events in the order they happened.
+*/
+enum linput_event_type : std::uint8_t {
+    INPUT_EVENT_KEY   = 1, // key press passed to the key handler
+    INPUT_EVENT_FRAME = 2  // start of a frame, before update and render
+};
+
+struct linput_event {
+    std::uint8_t  type;
+    std::uint8_t  key;
+    std::int16_t  x;
+    std::int16_t  y;
+    std::uint16_t reserved;
+    std::uint32_t time_us; // since recording started
+};
+
+class linput_recorder {
+    std::FILE*                            _file = {nullptr};
+    std::chrono::steady_clock::time_point _start;
+
+    void write(linput_event_type, unsigned char key, int x, int y);
+
+public:
+    linput_recorder() = default;
+    ~linput_recorder();
+
+    linput_recorder(const linput_recorder&) = delete;
+    linput_recorder& operator=(const linput_recorder&) = delete;
+
+    bool open(std::string_view path, int fps);
+    /*
+    Pre Condition:
+     -Null-terminated path
+    Post Condition:
+     -Starts a new log at given path, recorded at given frame rate
+     -Reports to console if the log could not be created or written
+    Side Effects:
+     -None
+    */
+
+    void close();
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Flushes and closes the log
+     -Reports to console if buffered events could not be written
+    Side Effects:
+     -None
+    */
+
+    bool is_open() const;
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Returns true if events are being recorded
+    Side Effects:
+     -None
+    */
+
+    void key(unsigned char key, int x, int y);
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Logs a key press with its time, if recording
+     -Stops recording and reports to console if the log could not be
+      written
+    Side Effects:
+     -None
+    */
+
+    void frame();
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Logs the start of a frame with its time, if recording
+     -Stops recording and reports to console if the log could not be
+      written
+    Side Effects:
+     -None
+    */
+};
+
+// timing of a replay
+struct lreplay_stats {
+    std::size_t frames        = {0};
+    double      total_ms      = {0.0};
+    double      slowest_ms    = {0.0};
+    std::size_t slowest_frame = {0};
+};
+
+class linput_log {
+    std::vector<linput_event> _events;
+    int                       _fps = {0};
+
+public:
+    bool load(std::string_view path);
+    /*
+    Pre Condition:
+     -Null-terminated path
+    Post Condition:
+     -Reads all events of the log at given path
+     -Reports to console if the log could not be read
+    Side Effects:
+     -None
+    */
+
+    int fps() const;
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Returns frame rate the log was recorded at
+    Side Effects:
+     -None
+    */
+
+    lreplay_stats replay(
+        void (*handle_keys)(unsigned char, int, int),
+        void (*update)(),
+        void (*render)()) const;
+    /*
+    Pre Condition:
+     -Functions may be called back to back, without waiting for the frame
+      rate
+    Post Condition:
+     -Runs every recorded frame as fast as possible: key events recorded
+      before the frame are passed to handle_keys, then update and render
+      are called
+     -Returns the time taken, including the slowest frame to bisect with
+    Side Effects:
+     -Side effects of the given functions
+    */
+};
+
+#endif // LINPUT_LOG_HPP
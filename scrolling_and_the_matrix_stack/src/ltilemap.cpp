@@ -0,0 +1,136 @@
+#include "ltilemap.hpp"
+
+#include <algorithm>
+#include <cmath> // for std::floor
+#include <utility>
+
+void
+ltilemap::create(
+    GLuint                              width,
+    GLuint                              height,
+    GLfloat                             tile_size,
+    std::vector<std::array<GLfloat, 3>> palette)
+{
+    _width     = width;
+    _height    = height;
+    _tile_size = tile_size;
+    _palette   = std::move(palette);
+    _tiles.assign(std::size_t{width} * height, 0);
+
+    // partial chunks cover the map edges
+    _chunks_x = (width + TILEMAP_CHUNK_TILES - 1) / TILEMAP_CHUNK_TILES;
+    _chunks_y = (height + TILEMAP_CHUNK_TILES - 1) / TILEMAP_CHUNK_TILES;
+
+    const auto chunks = std::size_t{_chunks_x} * _chunks_y;
+    _chunks.clear();
+    _chunks.resize(chunks);
+    _dirty.assign(chunks, true);
+    _empty.assign(chunks, true);
+    _drawn = 0;
+}
+
+ltile
+ltilemap::tile(GLuint x, GLuint y) const
+{
+    return _tiles[std::size_t{y} * _width + x];
+}
+
+void
+ltilemap::set_tile(GLuint x, GLuint y, ltile type)
+{
+    auto& current = _tiles[std::size_t{y} * _width + x];
+    if (current == type) return;
+
+    current = type;
+    _dirty[std::size_t{y / TILEMAP_CHUNK_TILES} * _chunks_x +
+           x / TILEMAP_CHUNK_TILES] = true;
+}
+
+void
+ltilemap::bake(GLuint chunk_x, GLuint chunk_y)
+{
+    const auto chunk = std::size_t{chunk_y} * _chunks_x + chunk_x;
+
+    const GLuint left   = chunk_x * TILEMAP_CHUNK_TILES;
+    const GLuint top    = chunk_y * TILEMAP_CHUNK_TILES;
+    const GLuint right  = std::min(left + TILEMAP_CHUNK_TILES, _width);
+    const GLuint bottom = std::min(top + TILEMAP_CHUNK_TILES, _height);
+
+    // runs of equal tiles in a row share one quad
+    std::vector<lvertex> vertices;
+    for (GLuint y = top; y < bottom; ++y) {
+        const ltile* row = &_tiles[std::size_t{y} * _width];
+        for (GLuint x = left; x < right;) {
+            const ltile type = row[x];
+            GLuint      end  = x + 1;
+            while (end < right && row[end] == type) { ++end; }
+
+            if (type != 0) {
+                const auto& color = _palette[type];
+                const auto  x0    = static_cast<GLfloat>(x) * _tile_size;
+                const auto  x1    = static_cast<GLfloat>(end) * _tile_size;
+                const auto  y0    = static_cast<GLfloat>(y) * _tile_size;
+                const auto  y1    = y0 + _tile_size;
+                vertices.push_back({{x0, y0}, color});
+                vertices.push_back({{x1, y0}, color});
+                vertices.push_back({{x1, y1}, color});
+                vertices.push_back({{x0, y1}, color});
+            }
+
+            x = end;
+        }
+    }
+
+    _empty[chunk] = vertices.empty();
+    _dirty[chunk] = false;
+
+    if (!_chunks[chunk]) _chunks[chunk] = std::make_unique<lmesh>();
+    if (_empty[chunk]) {
+        _chunks[chunk]->free_mesh();
+    } else {
+        _chunks[chunk]->load(GL_QUADS, std::move(vertices));
+    }
+}
+
+void
+ltilemap::render(const std::array<GLfloat, 4>& view)
+{
+    _drawn = 0;
+    if (_chunks.empty()) return;
+
+    // chunk range under the view, clamped to the map
+    const auto chunk_size = _tile_size * TILEMAP_CHUNK_TILES;
+    auto       chunk_at   = [chunk_size](GLfloat position, GLuint count) {
+        const auto c = std::floor(position / chunk_size);
+        return static_cast<GLuint>(
+            std::clamp(c, 0.f, static_cast<GLfloat>(count)));
+    };
+
+    const GLuint x_begin = chunk_at(view[0], _chunks_x);
+    const GLuint x_end   = chunk_at(view[0] + view[2] + chunk_size, _chunks_x);
+    const GLuint y_begin = chunk_at(view[1], _chunks_y);
+    const GLuint y_end   = chunk_at(view[1] + view[3] + chunk_size, _chunks_y);
+
+    for (GLuint y = y_begin; y < y_end; ++y) {
+        for (GLuint x = x_begin; x < x_end; ++x) {
+            const auto chunk = std::size_t{y} * _chunks_x + x;
+            if (_dirty[chunk]) bake(x, y);
+            if (_empty[chunk]) continue;
+
+            _chunks[chunk]->render();
+            ++_drawn;
+        }
+    }
+}
+
+std::size_t
+ltilemap::chunks_drawn() const
+{
+    return _drawn;
+}
+
+std::array<GLuint, 2>
+ltilemap::size() const
+{
+    return {_width, _height};
+}
@@ -0,0 +1,118 @@
+#ifndef LTILEMAP_HPP
+#define LTILEMAP_HPP
+
+#include "lmesh.hpp"
+#include "lopengl.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// tile type, index into the tile palette; type 0 is empty and not drawn
+using ltile = std::uint8_t;
+
+// tiles per chunk side
+constexpr GLuint TILEMAP_CHUNK_TILES = 32;
+
+class ltilemap {
+    // map size in tiles and tile size in pixels
+    GLuint  _width     = {0};
+    GLuint  _height    = {0};
+    GLfloat _tile_size = {0.f};
+
+    // tile types, row by row
+    std::vector<ltile> _tiles;
+
+    // color of each tile type
+    std::vector<std::array<GLfloat, 3>> _palette;
+
+    // chunk geometry in world space, baked when first seen and rebaked
+    // when one of its tiles changed
+    std::vector<std::unique_ptr<lmesh>> _chunks;
+    std::vector<bool>                   _dirty;
+    std::vector<bool>                   _empty;
+
+    // chunk grid size
+    GLuint _chunks_x = {0};
+    GLuint _chunks_y = {0};
+
+    // chunks drawn by the last render
+    std::size_t _drawn = {0};
+
+    void bake(GLuint chunk_x, GLuint chunk_y);
+
+public:
+    void create(
+        GLuint                              width,
+        GLuint                              height,
+        GLfloat                             tile_size,
+        std::vector<std::array<GLfloat, 3>> palette);
+    /*
+    Pre Condition:
+     -Palette has an entry for every tile type used
+    Post Condition:
+     -Creates an empty map of given size in tiles
+     -Frees geometry of the previous map
+    Side Effects:
+     -None
+    */
+
+    ltile tile(GLuint x, GLuint y) const;
+    /*
+    Pre Condition:
+     -Position lies within the map
+    Post Condition:
+     -Returns tile type at given position
+    Side Effects:
+     -None
+    */
+
+    void set_tile(GLuint x, GLuint y, ltile);
+    /*
+    Pre Condition:
+     -Position lies within the map
+    Post Condition:
+     -Sets tile type at given position
+     -Only the chunk holding the tile is rebaked, on its next render
+    Side Effects:
+     -None
+    */
+
+    void render(const std::array<GLfloat, 4>& view);
+    /*
+    Pre Condition:
+     -A valid OpenGL context
+     -Active modelview matrix mapping world space to the screen
+    Post Condition:
+     -Draws chunks overlapping the view rectangle {x, y, w, h} in world
+      space, each with a single draw call
+     -Bakes visible chunks which have no geometry yet or were edited
+    Side Effects:
+     -Binds a null vertex and index buffer
+     -Current color is left undefined
+    */
+
+    std::size_t chunks_drawn() const;
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Returns number of chunks drawn by the last render
+    Side Effects:
+     -None
+    */
+
+    std::array<GLuint, 2> size() const;
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Returns map size in tiles
+    Side Effects:
+     -None
+    */
+};
+
+#endif // LTILEMAP_HPP
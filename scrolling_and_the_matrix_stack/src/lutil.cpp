@@ -1,23 +1,129 @@
 #include "lutil.hpp"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath> // for std::sin and std::cos
+#include <vector>
+
+#include "ltilemap.hpp"
 
 namespace {
 
 static GLfloat g_camera_x = 0.f, g_camera_y = 0.f;
 
-inline void
-draw_quad(const std::array<float, 3u>& color)
+// map size in tiles and tile size in pixels
+constexpr GLuint  MAP_TILES = 1024;
+constexpr GLfloat TILE_SIZE = 16.f;
+
+// tile types
+constexpr ltile TILE_WATER  = 1;
+constexpr ltile TILE_SAND   = 2;
+constexpr ltile TILE_GRASS  = 3;
+constexpr ltile TILE_ROCK   = 4;
+constexpr ltile TILE_MARKER = 5;
+
+static ltilemap g_map;
+
+// benchmark_tilemap map size and frames per run, the camera crosses the map
+// diagonally once per run
+constexpr GLuint BENCHMARK_TILES  = 4096;
+constexpr int    BENCHMARK_FRAMES = 256;
+
+// tile colors
+const std::vector<std::array<GLfloat, 3>> PALETTE = {{0.f, 0.f, 0.f},
+                                                     {0.1f, 0.3f, 0.8f},
+                                                     {0.9f, 0.8f, 0.5f},
+                                                     {0.2f, 0.6f, 0.2f},
+                                                     {0.5f, 0.5f, 0.5f},
+                                                     {1.f, 0.f, 0.f}};
+
+// rolling terrain from a few overlapping waves
+ltile
+terrain(GLuint x, GLuint y)
 {
-    // clang-format off
-    glBegin(GL_QUADS);
-        glColor3f(color[0], color[1], color[2]);
-        glVertex2f(-SCREEN_WIDTH / 4.f, -SCREEN_HEIGHT / 4.f);
-        glVertex2f( SCREEN_WIDTH / 4.f, -SCREEN_HEIGHT / 4.f);
-        glVertex2f( SCREEN_WIDTH / 4.f,  SCREEN_HEIGHT / 4.f);
-        glVertex2f(-SCREEN_WIDTH / 4.f,  SCREEN_HEIGHT / 4.f);
-    glEnd();
-    // clang-format on
+    const auto fx     = static_cast<GLfloat>(x);
+    const auto fy     = static_cast<GLfloat>(y);
+    const auto height = std::sin(fx * 0.05f) + std::cos(fy * 0.07f) +
+                        std::sin((fx + fy) * 0.021f);
+
+    if (height < -0.5f) return TILE_WATER;
+    if (height < -0.2f) return TILE_SAND;
+    if (height < 1.4f) return TILE_GRASS;
+    return TILE_ROCK;
+}
+
+// camera position of given benchmark frame
+std::array<GLfloat, 2>
+benchmark_camera(int frame)
+{
+    const auto span = static_cast<GLfloat>(BENCHMARK_TILES) * TILE_SIZE;
+    const auto t = static_cast<GLfloat>(frame) / BENCHMARK_FRAMES;
+    return {t * (span - SCREEN_WIDTH), t * (span - SCREEN_HEIGHT)};
+}
+
+// draws every visible tile as its own quad at its own translation, the way
+// the tutorial drew its quads before the tile map
+void
+draw_tiles(const ltilemap& map, const std::array<GLfloat, 2>& camera)
+{
+    const auto first_x = static_cast<GLuint>(camera[0] / TILE_SIZE);
+    const auto first_y = static_cast<GLuint>(camera[1] / TILE_SIZE);
+    const auto last_x  = std::min(
+        static_cast<GLuint>((camera[0] + SCREEN_WIDTH) / TILE_SIZE) + 1,
+        BENCHMARK_TILES);
+    const auto last_y = std::min(
+        static_cast<GLuint>((camera[1] + SCREEN_HEIGHT) / TILE_SIZE) + 1,
+        BENCHMARK_TILES);
+
+    for (GLuint y = first_y; y < last_y; ++y) {
+        for (GLuint x = first_x; x < last_x; ++x) {
+            const auto& color = PALETTE[map.tile(x, y)];
+
+            glLoadIdentity();
+            glTranslatef(
+                static_cast<GLfloat>(x) * TILE_SIZE - camera[0],
+                static_cast<GLfloat>(y) * TILE_SIZE - camera[1],
+                0.f);
+            glColor3f(color[0], color[1], color[2]);
+            glBegin(GL_QUADS);
+            glVertex2f(0.f, 0.f);
+            glVertex2f(TILE_SIZE, 0.f);
+            glVertex2f(TILE_SIZE, TILE_SIZE);
+            glVertex2f(0.f, TILE_SIZE);
+            glEnd();
+        }
+    }
+}
+
+// renders a camera run over the map, returns frame times sorted
+template <typename Draw>
+std::vector<double>
+time_camera_run(Draw&& draw)
+{
+    std::vector<double> frame_ms;
+    for (int frame = 0; frame < BENCHMARK_FRAMES; ++frame) {
+        const auto start  = std::chrono::steady_clock::now();
+        const auto camera = benchmark_camera(frame);
+
+        glClear(GL_COLOR_BUFFER_BIT);
+        draw(camera, frame);
+        glFinish();
+
+        const std::chrono::duration<double, std::milli> elapsed =
+            std::chrono::steady_clock::now() - start;
+        frame_ms.push_back(elapsed.count());
+    }
+
+    std::sort(frame_ms.begin(), frame_ms.end());
+    return frame_ms;
+}
+
+void
+print_run(const char* name, const std::vector<double>& frame_ms)
+{
+    std::cout << name << ": frame ms p50 " << frame_ms[frame_ms.size() / 2]
+              << ", max " << frame_ms.back() << '\n';
 }
 
 } // namespace
@@ -43,6 +149,14 @@ initGL()
     // initialize clear color
     glClearColor(0.f, 0.f, 0.f, 1.f);
 
+    // generate map
+    g_map.create(MAP_TILES, MAP_TILES, TILE_SIZE, PALETTE);
+    for (GLuint y = 0; y < MAP_TILES; ++y) {
+        for (GLuint x = 0; x < MAP_TILES; ++x) {
+            g_map.set_tile(x, y, terrain(x, y));
+        }
+    }
+
     // check for error
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
@@ -73,29 +187,8 @@ render()
     // save default matrix again
     glPushMatrix();
 
-    // move to center of the screen
-    glTranslatef(SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f, 0.f);
-
-    // red quad
-    draw_quad({1.f, 0.f, 0.f});
-
-    // move to the right of the screen
-    glTranslatef(SCREEN_WIDTH, 0.f, 0.f);
-
-    // green quad
-    draw_quad({0.f, 1.f, 0.f});
-
-    // move to the lower right of the screen
-    glTranslatef(0.f, SCREEN_HEIGHT, 0.f);
-
-    // blue quad
-    draw_quad({0.f, 0.f, 1.f});
-
-    // move below the screen
-    glTranslatef(-SCREEN_WIDTH, 0.f, 0.f);
-
-    // yellow quad
-    draw_quad({1.f, 1.f, 0.f});
+    // draw the part of the map under the camera
+    g_map.render({g_camera_x, g_camera_y, SCREEN_WIDTH, SCREEN_HEIGHT});
 
     glutSwapBuffers();
 }
@@ -112,6 +205,20 @@ handle_keys(unsigned char key, int, int)
         g_camera_y -= 16.f;
     } else if (key == 'd') {
         g_camera_x -= 16.f;
+    } else if (key == ' ') {
+        // toggle a marker on the tile at the center of the screen, only
+        // its chunk is rebaked
+        const auto x = (g_camera_x + SCREEN_WIDTH / 2.f) / TILE_SIZE;
+        const auto y = (g_camera_y + SCREEN_HEIGHT / 2.f) / TILE_SIZE;
+        if (x >= 0.f && y >= 0.f && x < MAP_TILES && y < MAP_TILES) {
+            const auto tx = static_cast<GLuint>(x);
+            const auto ty = static_cast<GLuint>(y);
+            g_map.set_tile(
+                tx,
+                ty,
+                g_map.tile(tx, ty) == TILE_MARKER ? terrain(tx, ty)
+                                                  : TILE_MARKER);
+        }
     }
 
     // take save matrix off the stack and reset it
@@ -125,3 +232,68 @@ handle_keys(unsigned char key, int, int)
     // save default matrix again with camera translation
     glPushMatrix();
 }
+
+bool
+benchmark_tilemap()
+{
+    // map generation, not part of any frame
+    const auto start = std::chrono::steady_clock::now();
+    ltilemap   map;
+    map.create(BENCHMARK_TILES, BENCHMARK_TILES, TILE_SIZE, PALETTE);
+    for (GLuint y = 0; y < BENCHMARK_TILES; ++y) {
+        for (GLuint x = 0; x < BENCHMARK_TILES; ++x) {
+            map.set_tile(x, y, terrain(x, y));
+        }
+    }
+    const std::chrono::duration<double, std::milli> generated =
+        std::chrono::steady_clock::now() - start;
+    std::cout << BENCHMARK_TILES << 'x' << BENCHMARK_TILES
+              << " map generated in " << generated.count() << " ms\n";
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+
+    // chunks the camera sees for the first time are baked in its frame
+    std::size_t chunks = 0;
+    const auto  draw_chunks = [&map, &chunks](
+                                 const std::array<GLfloat, 2>& camera, int) {
+        glLoadIdentity();
+        glTranslatef(-camera[0], -camera[1], 0.f);
+        map.render({camera[0], camera[1], SCREEN_WIDTH, SCREEN_HEIGHT});
+        chunks = std::max(chunks, map.chunks_drawn());
+    };
+    print_run("chunks, baking", time_camera_run(draw_chunks));
+    print_run("chunks, baked", time_camera_run(draw_chunks));
+
+    // one edited tile per frame, rebaking the chunk holding it
+    print_run(
+        "chunks, one edit per frame",
+        time_camera_run([&map, &draw_chunks](
+                            const std::array<GLfloat, 2>& camera, int frame) {
+            const auto x = static_cast<GLuint>(
+                (camera[0] + SCREEN_WIDTH / 2.f) / TILE_SIZE);
+            const auto y = static_cast<GLuint>(
+                (camera[1] + SCREEN_HEIGHT / 2.f) / TILE_SIZE);
+            map.set_tile(x, y, frame % 2 ? TILE_MARKER : terrain(x, y));
+            draw_chunks(camera, frame);
+        }));
+    std::cout << "at most " << chunks << " chunks drawn per frame\n";
+
+    print_run(
+        "tiles",
+        time_camera_run([&map](const std::array<GLfloat, 2>& camera, int) {
+            draw_tiles(map, camera);
+        }));
+
+    glPopMatrix();
+
+    // check for error
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "error running tile map benchmark! "
+                  << gluErrorString(error) << '\n';
+        return false;
+    }
+
+    return true;
+}
@@ -14,6 +14,7 @@ Pre Condition:
  -A valid OpenGL context
 Post Condition:
  -Initializes matrices and clear color
+ -Generates the tile map
  -Reports to console if there was an OpenGL error
  -Returns false if there was an error in initialization
 Side Effects:
@@ -50,10 +51,26 @@ void handle_keys(unsigned char key, int x, int y);
 Pre Condition:
  -None
 Post Condition:
- -Toggles the color mode when the user presses q
- -Cycles through different projection scales when the user presses e
+ -Moves the camera when the user presses w/a/s/d
+ -Toggles a marker tile at the center of the screen when the user presses
+  space
 Side Effects:
- -If the user presses e, the matrix mode is set to projection
+ -Matrix mode is set to modelview
+*/
+
+bool benchmark_tilemap();
+/*
+Pre Condition:
+ -A valid OpenGL context
+Post Condition:
+ -Scrolls across a 4096x4096 tile map drawn from chunks while they are baked,
+  once they are baked and with a tile edited every frame, then drawn one
+  tile at a time
+ -Reports frame times of each run to console
+ -Returns false if there was an OpenGL error
+Side Effects:
+ -Modelview matrix is left as it was
+ -Clears the color buffer
 */
 
 #endif // LUTIL_HPP
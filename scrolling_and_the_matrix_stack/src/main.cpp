@@ -1,6 +1,25 @@
+#include "linput_log.hpp"
 #include "lutil.hpp"
 
 #include <cstdlib> // for EXIT_SUCCESS and EXIT_FAILURE
+#include <string_view>
+
+namespace {
+
+// records input and frames when run with --record <log>
+static linput_recorder g_recorder;
+
+} // namespace
+
+void handle_recorded_keys(unsigned char key, int x, int y);
+/*
+Pre Condition:
+ -None
+Post Condition:
+ -Records the key press and passes it on to handle_keys
+Side Effects:
+ -Side effects of handle_keys
+*/
 
 void run_main_loop(int);
 /*
@@ -17,6 +36,30 @@ main(int argc, char** args)
     // initialize freeGLUT
     glutInit(&argc, args);
 
+    // --record <log> logs input and frames, --replay <log> plays a log back
+    // as fast as possible, --tilemap-benchmark times scrolling a large map
+    std::string_view record_path, replay_path;
+    bool             benchmark = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view option = args[i];
+        if (option == "--tilemap-benchmark") {
+            benchmark = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            std::cerr << "missing log path after " << option << '\n';
+            return EXIT_FAILURE;
+        }
+        if (option == "--record") {
+            record_path = args[++i];
+        } else if (option == "--replay") {
+            replay_path = args[++i];
+        } else {
+            std::cerr << "unknown option " << option << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
     // create opengl 2.1 context
     glutInitContextVersion(2, 1);
 
@@ -31,8 +74,33 @@ main(int argc, char** args)
         return EXIT_FAILURE;
     }
 
+    // the benchmark runs without the main loop
+    if (benchmark) {
+        glutHideWindow();
+        return benchmark_tilemap() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // replay runs the logged frames without the main loop
+    if (!replay_path.empty()) {
+        linput_log log;
+        if (!log.load(replay_path)) return EXIT_FAILURE;
+
+        glutHideWindow();
+        const auto stats = log.replay(handle_keys, update, render);
+        std::cout << "replayed " << stats.frames << " frames in "
+                  << stats.total_ms << " ms, slowest frame "
+                  << stats.slowest_frame << " took " << stats.slowest_ms
+                  << " ms\n";
+        return EXIT_SUCCESS;
+    }
+
     // set keyboard handler
-    glutKeyboardFunc(handle_keys);
+    if (!record_path.empty()) {
+        if (!g_recorder.open(record_path, SCREEN_FPS)) return EXIT_FAILURE;
+        glutKeyboardFunc(handle_recorded_keys);
+    } else {
+        glutKeyboardFunc(handle_keys);
+    }
 
     // set rendering function
     glutDisplayFunc(render);
@@ -49,6 +117,9 @@ main(int argc, char** args)
 void
 run_main_loop(int val)
 {
+    // mark frame boundary in the input log
+    g_recorder.frame();
+
     // frame logic
     update();
     render();
@@ -56,3 +127,10 @@ run_main_loop(int val)
     // run frame once more time
     glutTimerFunc(1000 / SCREEN_FPS, run_main_loop, val);
 }
+
+void
+handle_recorded_keys(unsigned char key, int x, int y)
+{
+    g_recorder.key(key, x, y);
+    handle_keys(key, x, y);
+}
@@ -0,0 +1,62 @@
+#include "ldraw_list.hpp"
+
+#include "lmesh.hpp"
+
+void
+ldraw_list::begin(const std::array<GLfloat, 4>& bounds)
+{
+    _items.clear();
+    _bounds = bounds;
+}
+
+void
+ldraw_list::add(
+    const lmesh&                  mesh,
+    const std::array<GLfloat, 2>& position,
+    const std::array<GLfloat, 2>& half_extent,
+    GLuint                        layers)
+{
+    // cull items outside of the visible area
+    if (position[0] + half_extent[0] < _bounds[0] ||
+        position[1] + half_extent[1] < _bounds[1] ||
+        position[0] - half_extent[0] > _bounds[2] ||
+        position[1] - half_extent[1] > _bounds[3]) {
+        return;
+    }
+
+    _items.push_back({&mesh, position, layers});
+}
+
+std::size_t
+ldraw_list::size() const
+{
+    return _items.size();
+}
+
+void
+ldraw_list::render(const std::vector<lview>& views) const
+{
+    glMatrixMode(GL_MODELVIEW);
+
+    for (const auto& view : views) {
+        glViewport(
+            view.viewport[0],
+            view.viewport[1],
+            view.viewport[2],
+            view.viewport[3]);
+
+        // per-view transform
+        glLoadIdentity();
+        glTranslatef(view.offset[0], view.offset[1], 0.f);
+        glScalef(view.scale, view.scale, 1.f);
+
+        for (const auto& item : _items) {
+            if (!(item.layers & view.layers)) continue;
+
+            glPushMatrix();
+            glTranslatef(item.position[0], item.position[1], 0.f);
+            item.mesh->render();
+            glPopMatrix();
+        }
+    }
+}
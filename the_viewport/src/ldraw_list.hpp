@@ -0,0 +1,92 @@
+#ifndef LDRAW_LIST_HPP
+#define LDRAW_LIST_HPP
+
+#include "lopengl.hpp"
+
+#include <array>
+#include <vector>
+
+class lmesh;
+
+// every layer
+constexpr GLuint LAYER_ALL = ~0u;
+
+// a view of the scene: viewport rectangle plus per-view transform
+struct lview {
+    // x, y, width, height in window pixels
+    std::array<GLint, 4> viewport = {0, 0, 0, 0};
+
+    // applied on top of item positions: scale, then translate
+    std::array<GLfloat, 2> offset = {0.f, 0.f};
+    GLfloat                scale  = {1.f};
+
+    // layers this view shows
+    GLuint layers = {LAYER_ALL};
+};
+
+// a mesh placed in the scene
+struct ldraw_item {
+    const lmesh*           mesh     = {nullptr};
+    std::array<GLfloat, 2> position = {0.f, 0.f};
+    GLuint                 layers   = {LAYER_ALL};
+};
+
+class ldraw_list {
+    // items which passed culling
+    std::vector<ldraw_item> _items;
+
+    // visible area, left, top, right, bottom
+    std::array<GLfloat, 4> _bounds = {0.f, 0.f, 0.f, 0.f};
+
+public:
+    void begin(const std::array<GLfloat, 4>& bounds);
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Removes all items, following items are culled against given area
+      {left, top, right, bottom}
+    Side Effects:
+     -None
+    */
+
+    void add(
+        const lmesh&                  mesh,
+        const std::array<GLfloat, 2>& position,
+        const std::array<GLfloat, 2>& half_extent,
+        GLuint                        layers = LAYER_ALL);
+    /*
+    Pre Condition:
+     -Mesh outlives the draw list contents
+    Post Condition:
+     -Adds mesh at given position unless its bounds lie outside the visible
+      area
+    Side Effects:
+     -None
+    */
+
+    std::size_t size() const;
+    /*
+    Pre Condition:
+     -None
+    Post Condition:
+     -Returns number of items which passed culling
+    Side Effects:
+     -None
+    */
+
+    void render(const std::vector<lview>& views) const;
+    /*
+    Pre Condition:
+     -A valid OpenGL context
+    Post Condition:
+     -Replays the list once per view with the view's viewport and transform,
+      the scene is not traversed again
+    Side Effects:
+     -Matrix mode is set to modelview
+     -Modelview matrix is left at the last view's transform
+     -Viewport is left at the last view's rectangle
+    */
+};
+
+#endif // LDRAW_LIST_HPP
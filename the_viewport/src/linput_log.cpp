@@ -0,0 +1,182 @@
+#include "linput_log.hpp"
+
+#include <algorithm>
+#include <cstring> // for std::memcmp
+
+namespace {
+
+constexpr char          INPUT_LOG_MAGIC[4] = {'L', 'I', 'N', 'P'};
+constexpr std::uint32_t INPUT_LOG_VERSION  = 1;
+
+struct linput_log_header {
+    char          magic[4];
+    std::uint32_t version;
+    std::uint32_t fps;
+};
+
+std::int16_t
+clamp_coordinate(int value)
+{
+    return static_cast<std::int16_t>(std::clamp(value, -32768, 32767));
+}
+
+} // namespace
+
+linput_recorder::~linput_recorder()
+{
+    close();
+}
+
+bool
+linput_recorder::open(std::string_view path, int fps)
+{
+    close();
+
+    _file = std::fopen(path.data(), "wb");
+    if (!_file) {
+        std::cerr << "unable to create input log " << path << '\n';
+        return false;
+    }
+
+    linput_log_header header = {};
+    std::memcpy(header.magic, INPUT_LOG_MAGIC, 4);
+    header.version = INPUT_LOG_VERSION;
+    header.fps     = static_cast<std::uint32_t>(fps);
+    if (std::fwrite(&header, sizeof(header), 1, _file) != 1) {
+        std::cerr << "unable to write input log " << path << '\n';
+        close();
+        return false;
+    }
+
+    _start = std::chrono::steady_clock::now();
+    return true;
+}
+
+void
+linput_recorder::close()
+{
+    // buffered events are written on close, they can fail too
+    if (_file && std::fclose(_file) != 0) {
+        std::cerr << "unable to finish input log, it is truncated\n";
+    }
+    _file = nullptr;
+}
+
+bool
+linput_recorder::is_open() const
+{
+    return _file != nullptr;
+}
+
+void
+linput_recorder::write(linput_event_type type, unsigned char key, int x, int y)
+{
+    if (!_file) return;
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start);
+
+    linput_event event = {};
+    event.type         = type;
+    event.key          = key;
+    event.x            = clamp_coordinate(x);
+    event.y            = clamp_coordinate(y);
+    event.time_us      = static_cast<std::uint32_t>(elapsed.count());
+
+    // buffered by stdio, the log hits the disk in large blocks; a log with
+    // holes would replay wrongly, so stop at the first failed write
+    if (std::fwrite(&event, sizeof(event), 1, _file) != 1) {
+        std::cerr << "unable to write input log, recording stopped\n";
+        close();
+    }
+}
+
+void
+linput_recorder::key(unsigned char key, int x, int y)
+{
+    write(INPUT_EVENT_KEY, key, x, y);
+}
+
+void
+linput_recorder::frame()
+{
+    write(INPUT_EVENT_FRAME, 0, 0, 0);
+}
+
+bool
+linput_log::load(std::string_view path)
+{
+    _events.clear();
+
+    std::FILE* file = std::fopen(path.data(), "rb");
+    if (!file) {
+        std::cerr << "unable to open input log " << path << '\n';
+        return false;
+    }
+
+    linput_log_header header = {};
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, INPUT_LOG_MAGIC, 4) == 0 &&
+                 header.version == INPUT_LOG_VERSION;
+
+    linput_event event = {};
+    while (valid && std::fread(&event, sizeof(event), 1, file) == 1) {
+        _events.push_back(event);
+    }
+    std::fclose(file);
+
+    if (!valid) {
+        std::cerr << path << " is not an input log\n";
+        _events.clear();
+        return false;
+    }
+
+    _fps = static_cast<int>(header.fps);
+    return true;
+}
+
+int
+linput_log::fps() const
+{
+    return _fps;
+}
+
+lreplay_stats
+linput_log::replay(
+    void (*handle_keys)(unsigned char, int, int),
+    void (*update)(),
+    void (*render)()) const
+{
+    using clock = std::chrono::steady_clock;
+
+    lreplay_stats stats;
+    const auto    start = clock::now();
+
+    for (const auto& event : _events) {
+        if (event.type == INPUT_EVENT_KEY) {
+            handle_keys(event.key, event.x, event.y);
+            continue;
+        }
+        if (event.type != INPUT_EVENT_FRAME) continue;
+
+        const auto frame_start = clock::now();
+        update();
+        render();
+
+        // wait for GL, so slow frames show up where they happen
+        glFinish();
+
+        const std::chrono::duration<double, std::milli> frame_time =
+            clock::now() - frame_start;
+        if (frame_time.count() > stats.slowest_ms) {
+            stats.slowest_ms    = frame_time.count();
+            stats.slowest_frame = stats.frames;
+        }
+        ++stats.frames;
+    }
+
+    const std::chrono::duration<double, std::milli> total =
+        clock::now() - start;
+    stats.total_ms = total.count();
+    return stats;
+}
@@ -1,43 +1,145 @@
 #include "lutil.hpp"
 
 #include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "ldraw_list.hpp"
+#include "lmesh.hpp"
 
 namespace {
 
 static int g_viewport_mode = VIEWPORT_MODE_FULL;
 
-inline void
-draw_quad(const std::array<float, 3u>& color)
+// full screen quads, uploaded once
+static lmesh g_red_quad;
+static lmesh g_green_quad;
+static lmesh g_blue_quad;
+static lmesh g_yellow_quad;
+
+// radar quads, uploaded once
+static lmesh g_radar_quads;
+
+// layers of the quad mode
+constexpr GLuint LAYER_RED    = 1u << 0;
+constexpr GLuint LAYER_GREEN  = 1u << 1;
+constexpr GLuint LAYER_BLUE   = 1u << 2;
+constexpr GLuint LAYER_YELLOW = 1u << 3;
+
+// scene of benchmark_views: quads of VIEWS_BENCHMARK_HALF half extent
+// scattered over twice the screen in each direction, so about a quarter of
+// them pass culling, drawn in split screens of 1 to 8 views
+constexpr std::size_t           VIEWS_BENCHMARK_ITEMS  = 20000;
+constexpr GLfloat               VIEWS_BENCHMARK_HALF   = 2.f;
+constexpr std::array<GLuint, 4> VIEWS_BENCHMARK_COUNTS = {1, 2, 4, 8};
+constexpr int                   VIEWS_BENCHMARK_FRAMES = 20;
+
+// culled scene, built once per frame and replayed per view
+static ldraw_list g_draw_list;
+
+// views of each viewport mode, bottom-up window coordinates
+static const std::vector<lview> g_full_views = {
+    {{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}}};
+
+static const std::vector<lview> g_half_center_views = {
+    {{SCREEN_WIDTH / 4,
+      SCREEN_HEIGHT / 4,
+      SCREEN_WIDTH / 2,
+      SCREEN_HEIGHT / 2}}};
+
+static const std::vector<lview> g_half_top_views = {
+    {{SCREEN_WIDTH / 4,
+      SCREEN_HEIGHT / 2,
+      SCREEN_WIDTH / 2,
+      SCREEN_HEIGHT / 2}}};
+
+static const std::vector<lview> g_quad_views = {
+    {{0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2},
+     {0.f, 0.f},
+     1.f,
+     LAYER_RED},
+    {{SCREEN_WIDTH / 2, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2},
+     {0.f, 0.f},
+     1.f,
+     LAYER_GREEN},
+    {{0, SCREEN_HEIGHT / 2, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2},
+     {0.f, 0.f},
+     1.f,
+     LAYER_BLUE},
+    {{SCREEN_WIDTH / 2,
+      SCREEN_HEIGHT / 2,
+      SCREEN_WIDTH / 2,
+      SCREEN_HEIGHT / 2},
+     {0.f, 0.f},
+     1.f,
+     LAYER_YELLOW}};
+
+static const std::vector<lview> g_radar_views = {
+    {{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}},
+    {{SCREEN_WIDTH / 2,
+      SCREEN_HEIGHT / 2,
+      SCREEN_WIDTH / 2,
+      SCREEN_HEIGHT / 2}}};
+
+bool
+load_quad(lmesh& mesh, const std::array<float, 3u>& color)
 {
     // clang-format off
-    glBegin(GL_QUADS);
-        glColor3f(color[0], color[1], color[2]);
-        glVertex2f(-SCREEN_WIDTH / 2.f, -SCREEN_HEIGHT / 2.f);
-        glVertex2f( SCREEN_WIDTH / 2.f, -SCREEN_HEIGHT / 2.f);
-        glVertex2f( SCREEN_WIDTH / 2.f,  SCREEN_HEIGHT / 2.f);
-        glVertex2f(-SCREEN_WIDTH / 2.f,  SCREEN_HEIGHT / 2.f);
-    glEnd();
+    return mesh.load(
+        GL_QUADS,
+        {{{-SCREEN_WIDTH / 2.f, -SCREEN_HEIGHT / 2.f}, color},
+         {{ SCREEN_WIDTH / 2.f, -SCREEN_HEIGHT / 2.f}, color},
+         {{ SCREEN_WIDTH / 2.f,  SCREEN_HEIGHT / 2.f}, color},
+         {{-SCREEN_WIDTH / 2.f,  SCREEN_HEIGHT / 2.f}, color}});
     // clang-format on
 }
 
-inline void
-double_quads(
-    const std::array<float, 3u>& color1, const std::array<float, 3u>& color2)
+/*
+Pre Condition:
+ -None
+Post Condition:
+ -Returns given number of views side by side in columns of two rows, each
+  showing the whole screen scaled into its viewport
+Side Effects:
+ -None
+*/
+std::vector<lview>
+split_views(GLuint count)
+{
+    const GLint rows    = count > 1 ? 2 : 1;
+    const GLint columns = static_cast<GLint>(count) / rows;
+    const GLint width   = SCREEN_WIDTH / columns;
+    const GLint height  = SCREEN_HEIGHT / rows;
+
+    std::vector<lview> views;
+    for (GLint i = 0; i < static_cast<GLint>(count); ++i) {
+        views.push_back(
+            {{i % columns * width, i / columns * height, width, height},
+             {0.f, 0.f},
+             1.f});
+    }
+    return views;
+}
+
+bool
+load_double_quads(
+    lmesh&                       mesh,
+    const std::array<float, 3u>& color1,
+    const std::array<float, 3u>& color2)
 {
     // clang-format off
-    glBegin(GL_QUADS);
-        glColor3f(color1[0], color1[1], color1[2]);
-        glVertex2f(-SCREEN_WIDTH / 8.f, -SCREEN_HEIGHT / 8.f);
-        glVertex2f( SCREEN_WIDTH / 8.f, -SCREEN_HEIGHT / 8.f);
-        glVertex2f( SCREEN_WIDTH / 8.f,  SCREEN_HEIGHT / 8.f);
-        glVertex2f(-SCREEN_WIDTH / 8.f,  SCREEN_HEIGHT / 8.f);
-        glColor3f(color2[0], color2[1], color2[2]);
-        glVertex2f(-SCREEN_WIDTH / 16.f, -SCREEN_HEIGHT / 16.f);
-        glVertex2f( SCREEN_WIDTH / 16.f, -SCREEN_HEIGHT / 16.f);
-        glVertex2f( SCREEN_WIDTH / 16.f,  SCREEN_HEIGHT / 16.f);
-        glVertex2f(-SCREEN_WIDTH / 16.f,  SCREEN_HEIGHT / 16.f);
-    glEnd();
-    // clang-format off
+    return mesh.load(
+        GL_QUADS,
+        {{{-SCREEN_WIDTH / 8.f, -SCREEN_HEIGHT / 8.f}, color1},
+         {{ SCREEN_WIDTH / 8.f, -SCREEN_HEIGHT / 8.f}, color1},
+         {{ SCREEN_WIDTH / 8.f,  SCREEN_HEIGHT / 8.f}, color1},
+         {{-SCREEN_WIDTH / 8.f,  SCREEN_HEIGHT / 8.f}, color1},
+         {{-SCREEN_WIDTH / 16.f, -SCREEN_HEIGHT / 16.f}, color2},
+         {{ SCREEN_WIDTH / 16.f, -SCREEN_HEIGHT / 16.f}, color2},
+         {{ SCREEN_WIDTH / 16.f,  SCREEN_HEIGHT / 16.f}, color2},
+         {{-SCREEN_WIDTH / 16.f,  SCREEN_HEIGHT / 16.f}, color2}});
+    // clang-format on
 }
 
 } // namespace
@@ -68,6 +170,99 @@ initGL()
         return false;
     }
 
+    // upload static geometry
+    return load_quad(g_red_quad, {1.f, 0.f, 0.f}) &&
+           load_quad(g_green_quad, {0.f, 1.f, 0.f}) &&
+           load_quad(g_blue_quad, {0.f, 0.f, 1.f}) &&
+           load_quad(g_yellow_quad, {1.f, 1.f, 0.f}) &&
+           load_double_quads(g_radar_quads, {1.f, 1.f, 1.f}, {0.f, 0.f, 0.f});
+}
+
+bool
+benchmark_views()
+{
+    // quads of a few pixels, so frames cost submission rather than fill
+    constexpr GLfloat half = VIEWS_BENCHMARK_HALF;
+    lmesh             item;
+    // clang-format off
+    if (!item.load(
+            GL_QUADS,
+            {{{-half, -half}, {1.f, 1.f, 1.f}},
+             {{ half, -half}, {1.f, 1.f, 1.f}},
+             {{ half,  half}, {1.f, 1.f, 1.f}},
+             {{-half,  half}, {1.f, 1.f, 1.f}}})) {
+        return false;
+    }
+    // clang-format on
+
+    // scattered from half a screen before to half a screen after it
+    std::vector<std::array<GLfloat, 2>> positions(VIEWS_BENCHMARK_ITEMS);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        positions[i] = {
+            static_cast<GLfloat>(i * 7919 % (SCREEN_WIDTH * 2)) -
+                SCREEN_WIDTH / 2.f,
+            static_cast<GLfloat>(i * 104729 % (SCREEN_HEIGHT * 2)) -
+                SCREEN_HEIGHT / 2.f};
+    }
+
+    // the scene traversal: cull every item into the list
+    ldraw_list list;
+    const auto build = [&]() {
+        list.begin({0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT});
+        for (const auto& position : positions) {
+            list.add(item, position, {half, half});
+        }
+    };
+
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    for (const auto count : VIEWS_BENCHMARK_COUNTS) {
+        const auto views = split_views(count);
+
+        // the list built once and replayed per view, against the scene
+        // traversed again for every view
+        for (const bool per_view : {false, true}) {
+            milliseconds build_ms{0};
+            milliseconds replay_ms{0};
+            milliseconds frame_ms{0};
+            for (int frame = 0; frame < VIEWS_BENCHMARK_FRAMES; ++frame) {
+                const auto start = std::chrono::steady_clock::now();
+                glClear(GL_COLOR_BUFFER_BIT);
+
+                for (std::size_t v = 0; v < (per_view ? views.size() : 1);
+                     ++v) {
+                    const auto traversal = std::chrono::steady_clock::now();
+                    build();
+                    const auto built = std::chrono::steady_clock::now();
+                    if (per_view) {
+                        list.render({views[v]});
+                    } else {
+                        list.render(views);
+                    }
+                    build_ms += built - traversal;
+                    replay_ms += std::chrono::steady_clock::now() - built;
+                }
+
+                glFinish();
+                frame_ms += std::chrono::steady_clock::now() - start;
+            }
+
+            std::cout << count << (count == 1 ? " view, " : " views, ")
+                      << (per_view ? "scene traversed per view"
+                                   : "draw list replayed")
+                      << ": build "
+                      << build_ms.count() / VIEWS_BENCHMARK_FRAMES
+                      << " ms, replay "
+                      << replay_ms.count() / VIEWS_BENCHMARK_FRAMES
+                      << " ms, frame "
+                      << frame_ms.count() / VIEWS_BENCHMARK_FRAMES << " ms, "
+                      << list.size() << " of " << positions.size()
+                      << " items visible\n";
+        }
+    }
+
+    // restore the window viewport and transform
+    glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glLoadIdentity();
     return true;
 }
 
@@ -83,73 +278,44 @@ render()
     // clear color buffer
     glClear(GL_COLOR_BUFFER_BIT);
 
-    // reset modelview matrix
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    // build the draw list once, culled against the screen
+    const auto  center = std::array{SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f};
+    const auto& full_extent = center; // full screen quads are centered
+    g_draw_list.begin({0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT});
 
-    // move to center of the screen
-    glTranslatef(SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f, 0.f);
-
-    // full view
+    const std::vector<lview>* views = &g_full_views;
     if (g_viewport_mode == VIEWPORT_MODE_FULL) {
-        // fill the screen
-        glViewport(0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT);
-        draw_quad({1.f, 0.f, 0.f}); // red quad
+        // fill the screen with a red quad
+        g_draw_list.add(g_red_quad, center, full_extent);
     } else if (g_viewport_mode == VIEWPORT_MODE_HALF_CENTER) {
-        // center viewport
-        glViewport(
-            SCREEN_WIDTH / 4.f,
-            SCREEN_HEIGHT / 4.f,
-            SCREEN_WIDTH / 2.f,
-            SCREEN_HEIGHT / 2.f);
-        draw_quad({0.f, 1.f, 0.f}); // green quad
-        // clang-format on
+        // green quad in the center viewport
+        g_draw_list.add(g_green_quad, center, full_extent);
+        views = &g_half_center_views;
     } else if (g_viewport_mode == VIEWPORT_MODE_HALF_TOP) {
-        // viewport at top
-        glViewport(
-            SCREEN_WIDTH / 4.f,
-            SCREEN_HEIGHT / 2.f,
-            SCREEN_WIDTH / 2.f,
-            SCREEN_HEIGHT / 2.f);
-        draw_quad({0.f, 0.f, 1.f}); // blue quad
-    }                               /* four viewports at the same time */
+        // blue quad in the viewport at top
+        g_draw_list.add(g_blue_quad, center, full_extent);
+        views = &g_half_top_views;
+    } /* four viewports at the same time */
     else if (g_viewport_mode == VIEWPORT_MODE_QUAD) {
-        // bottom left red quad
-        glViewport(0.f, 0.f, SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f);
-        draw_quad({1.f, 0.f, 0.f});
-
-        // bottom right green quad
-        glViewport(
-            SCREEN_WIDTH / 2.f, 0.f, SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f);
-        draw_quad({0.f, 1.f, 0.f});
-
-        // top left blue quad
-        glViewport(
-            0.f, SCREEN_HEIGHT / 2.f, SCREEN_WIDTH / 2.f, SCREEN_HEIGHT / 2.f);
-        draw_quad({0.f, 0.f, 1.f});
-
-        // top right yellow quad
-        glViewport(
-            SCREEN_WIDTH / 2.f,
-            SCREEN_HEIGHT / 2.f,
-            SCREEN_WIDTH / 2.f,
-            SCREEN_HEIGHT / 2.f);
-        draw_quad({1.f, 1.f, 0.f});
+        // each viewport shows its own layer
+        g_draw_list.add(g_red_quad, center, full_extent, LAYER_RED);
+        g_draw_list.add(g_green_quad, center, full_extent, LAYER_GREEN);
+        g_draw_list.add(g_blue_quad, center, full_extent, LAYER_BLUE);
+        g_draw_list.add(g_yellow_quad, center, full_extent, LAYER_YELLOW);
+        views = &g_quad_views;
     } /* viewport with radar subview port */
     else if (g_viewport_mode == VIEWPORT_MODE_RADAR) {
-        // full size quad
-        glViewport(0.f, 0.f, SCREEN_WIDTH, SCREEN_HEIGHT);
-        double_quads({1.f, 1.f, 1.f}, {0.f, 0.f, 0.f});
-
-        // radar quad
-        glViewport(
-            SCREEN_WIDTH / 2.f,
-            SCREEN_HEIGHT / 2.f,
-            SCREEN_WIDTH / 2.f,
-            SCREEN_HEIGHT / 2.f);
-        double_quads({1.f, 1.f, 1.f}, {0.f, 0.f, 0.f});
+        // the same scene in the full and the radar viewport
+        g_draw_list.add(
+            g_radar_quads,
+            center,
+            {SCREEN_WIDTH / 8.f, SCREEN_HEIGHT / 8.f});
+        views = &g_radar_views;
     }
 
+    // replay the list per view
+    g_draw_list.render(*views);
+
     glutSwapBuffers();
 }
 
@@ -35,6 +35,22 @@ Side Effects:
  -Clear color is set to black
 */
 
+bool benchmark_views();
+/*
+Pre Condition:
+ -A valid OpenGL context
+ -initGL succeeded
+Post Condition:
+ -Draws a scene of many small quads in split screens of 1, 2, 4 and 8
+  views, once building the draw list once per frame and replaying it per
+  view, once traversing the scene again for every view
+ -Reports build, replay and frame times of both to console
+ -Returns false if the quad mesh could not be loaded
+Side Effects:
+ -Clears the color buffer
+ -Viewport is set to the window, modelview matrix to identity
+*/
+
 void update();
 /*
 Pre Condition:
@@ -1,6 +1,9 @@
 #ifndef LOPENGL_HPP
 #define LOPENGL_HPP
 
+// declare pixel buffer object entry points from GL/glext.h
+#define GL_GLEXT_PROTOTYPES
+
 // clang-format off
 #include <GL/freeglut.h>
 #include <GL/gl.h>
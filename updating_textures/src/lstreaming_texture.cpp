@@ -0,0 +1,408 @@
+#include "lstreaming_texture.hpp"
+
+#include <algorithm>
+#include <cstdio>  // for std::sscanf
+#include <cstring> // for std::strstr
+#include <optional>
+
+#include <gsl/gsl_util> // for gsl::narrow
+
+#include "macro_helpers.hpp"
+
+namespace {
+
+bool
+version_at_least(int major_version, int minor_version)
+{
+    auto version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    int  major   = 0;
+    int  minor   = 0;
+    return version && std::sscanf(version, "%d.%d", &major, &minor) == 2 &&
+           (major > major_version ||
+            (major == major_version && minor >= minor_version));
+}
+
+double
+seconds_between(
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end)
+{
+    const std::chrono::duration<double> elapsed = end - start;
+    return elapsed.count();
+}
+
+} // namespace
+
+lstreaming_texture::lstreaming_texture() = default;
+
+lstreaming_texture::~lstreaming_texture()
+{
+    close();
+}
+
+bool
+lstreaming_texture::supported()
+{
+    auto extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    return version_at_least(2, 1) ||
+           (extensions &&
+            std::strstr(extensions, "GL_ARB_pixel_buffer_object"));
+}
+
+bool
+lstreaming_texture::open(
+    std::array<GLuint, 2> dimensions,
+    frame_source          source,
+    double                fps,
+    std::size_t           ring_frames,
+    bool                  unpack_buffers)
+{
+    close();
+
+    _dimensions = dimensions;
+
+    // storage only, frames arrive through update
+    glGenTextures(1, &_texture_id);
+    glBindTexture(GL_TEXTURE_2D, _texture_id);
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RGBA,
+        gsl::narrow<GLsizei>(Wv(_dimensions)),
+        gsl::narrow<GLsizei>(Hv(_dimensions)),
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // check for error
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "error creating " << Wv(_dimensions) << 'x'
+                  << Hv(_dimensions)
+                  << " streaming texture: " << gluErrorString(error) << '\n';
+        close();
+        return false;
+    }
+
+    // the ring, mapped as the stream thread gets to decode into it
+    const std::size_t pixel_count =
+        std::size_t{Wv(_dimensions)} * Hv(_dimensions);
+    const bool buffered = unpack_buffers && supported();
+    auto extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    _invalidate = version_at_least(3, 0) ||
+                  (extensions &&
+                   std::strstr(extensions, "GL_ARB_map_buffer_range"));
+    _frames.resize(std::max<std::size_t>(ring_frames, 2));
+    for (std::size_t i = 0; i < _frames.size(); ++i) {
+        auto& frame = _frames[i];
+        if (buffered) {
+            glGenBuffers(1, &frame.buffer);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, frame.buffer);
+            glBufferData(
+                GL_PIXEL_UNPACK_BUFFER,
+                gsl::narrow<GLsizeiptr>(pixel_count * sizeof(GLuint)),
+                nullptr,
+                GL_STREAM_DRAW);
+            _unmapped.push_back(i);
+        } else {
+            frame.storage.resize(pixel_count);
+            frame.pixels = frame.storage.data();
+            _free.push_back(i);
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    _source = std::move(source);
+    _fps    = fps;
+    _start  = std::chrono::steady_clock::now();
+    _worker = std::thread([this]() { decode(); });
+
+    return true;
+}
+
+void
+lstreaming_texture::close()
+{
+    if (_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_one();
+        _worker.join();
+    }
+
+    if (_texture_id != 0) {
+        glDeleteTextures(1, &_texture_id);
+        _texture_id = 0;
+    }
+
+    // deleting a mapped buffer unmaps it
+    for (auto& frame : _frames) {
+        if (frame.buffer != 0) glDeleteBuffers(1, &frame.buffer);
+    }
+
+    _dimensions = {0, 0};
+    _has_frame  = false;
+    _shown      = 0;
+    _last_due   = 0;
+    _frames.clear();
+    _unmapped.clear();
+    _ready.clear();
+    _free.clear();
+    _invalidate = false;
+    _stop       = false;
+    _ended  = false;
+    _stats  = {};
+    _source = nullptr;
+}
+
+std::chrono::steady_clock::time_point
+lstreaming_texture::due_time(std::size_t frame) const
+{
+    return _start + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>(
+                            static_cast<double>(frame) / _fps));
+}
+
+std::size_t
+lstreaming_texture::due(std::chrono::steady_clock::time_point now) const
+{
+    return static_cast<std::size_t>(seconds_between(_start, now) * _fps);
+}
+
+bool
+lstreaming_texture::update()
+{
+    if (!_texture_id) return false;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // hand slots uploaded from back to the stream thread, invalidated or
+    // orphaned so mapping does not wait for the GPU to read them; slots which
+    // fail to map stay unmapped and are retried by the next update
+    if (!_unmapped.empty()) {
+        const auto bytes = gsl::narrow<GLsizeiptr>(
+            std::size_t{Wv(_dimensions)} * Hv(_dimensions) * sizeof(GLuint));
+        std::size_t failed = 0;
+        for (auto i : _unmapped) {
+            auto& frame = _frames[i];
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, frame.buffer);
+            if (_invalidate) {
+                frame.pixels = static_cast<GLuint*>(glMapBufferRange(
+                    GL_PIXEL_UNPACK_BUFFER,
+                    0,
+                    bytes,
+                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            } else {
+                glBufferData(
+                    GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+                frame.pixels = static_cast<GLuint*>(
+                    glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+            }
+            if (!frame.pixels) {
+                // reported once until the slot maps again
+                if (!frame.map_failed) {
+                    std::cerr << "unable to map streaming texture buffer, "
+                                 "retrying next update\n";
+                }
+                frame.map_failed    = true;
+                _unmapped[failed++] = i;
+                continue;
+            }
+            frame.map_failed = false;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _free.push_back(i);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        _unmapped.resize(failed);
+        _wake.notify_one();
+    }
+
+    const std::size_t due_frame = due(start);
+
+    // newest decoded frame which is due, the ones before it are dropped and
+    // their slots stay mapped
+    std::optional<std::size_t> found;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        while (!_ready.empty() && _frames[_ready.front()].number <= due_frame) {
+            if (found) {
+                ++_stats.frames_dropped;
+                _free.push_back(*found);
+            }
+            found = _ready.front();
+            _ready.pop_front();
+        }
+
+        // counted once per due frame, not per refresh
+        if (!found && !_ended && due_frame != _last_due &&
+            (!_has_frame || _shown < due_frame)) {
+            ++_stats.frames_late;
+        }
+    }
+    _last_due = due_frame;
+
+    if (!found) {
+        const auto end = std::chrono::steady_clock::now();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats.upload_seconds += seconds_between(start, end);
+        return false;
+    }
+
+    auto& frame = _frames[*found];
+    upload(frame);
+    const auto end = std::chrono::steady_clock::now();
+
+    _shown     = frame.number;
+    _has_frame = true;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.frames_uploaded;
+        _stats.upload_bytes +=
+            std::size_t{Wv(_dimensions)} * Hv(_dimensions) * sizeof(GLuint);
+        _stats.upload_seconds += seconds_between(start, end);
+
+        const double latency = seconds_between(due_time(frame.number), end);
+        _stats.latency_seconds += latency;
+        _stats.max_latency_seconds =
+            std::max(_stats.max_latency_seconds, latency);
+        _stats.queued_seconds += seconds_between(frame.decoded, end);
+
+        // client memory is free again at once, buffers once mapped again
+        if (frame.buffer == 0) _free.push_back(*found);
+    }
+    if (frame.buffer == 0) {
+        _wake.notify_one();
+    } else {
+        _unmapped.push_back(*found);
+    }
+
+    return true;
+}
+
+void
+lstreaming_texture::upload(lframe& frame)
+{
+    // pixels come from the offset of the bound unpack buffer
+    const GLvoid* pixels = frame.pixels;
+    if (frame.buffer != 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, frame.buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        frame.pixels = nullptr;
+        pixels       = nullptr;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, _texture_id);
+    glTexSubImage2D(
+        GL_TEXTURE_2D,
+        0,
+        0,
+        0,
+        gsl::narrow<GLsizei>(Wv(_dimensions)),
+        gsl::narrow<GLsizei>(Hv(_dimensions)),
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (frame.buffer != 0) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void
+lstreaming_texture::render(
+    std::array<GLfloat, 2> point, std::array<GLfloat, 2> size)
+{
+    // nothing to show yet
+    if (!_has_frame) return;
+
+    // remove any previous transformations
+    glLoadIdentity();
+
+    // move to rendering point
+    glTranslatef(Xc(point), Yc(point), 0.f);
+
+    // set texture id
+    glBindTexture(GL_TEXTURE_2D, _texture_id);
+
+    // render texture quad, frames are stored top row first
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.f, 0.f);
+    glVertex2f(0.f, 0.f);
+    glTexCoord2f(1.f, 0.f);
+    glVertex2f(Wv(size), 0.f);
+    glTexCoord2f(1.f, 1.f);
+    glVertex2f(Wv(size), Hv(size));
+    glTexCoord2f(0.f, 1.f);
+    glVertex2f(0.f, Hv(size));
+    glEnd();
+}
+
+bool
+lstreaming_texture::ended() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _ended && _ready.empty();
+}
+
+lstream_stats
+lstreaming_texture::stats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+std::array<GLuint, 2>
+lstreaming_texture::get_dimensions() const
+{
+    return _dimensions;
+}
+
+void
+lstreaming_texture::decode()
+{
+    std::size_t next = 0;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _wake.wait(lock, [this]() { return _stop || !_free.empty(); });
+        if (_stop) return;
+
+        const std::size_t slot = _free.back();
+        _free.pop_back();
+
+        // frames already overdue are not decoded at all
+        const std::size_t due_frame = due(std::chrono::steady_clock::now());
+        if (due_frame > next) {
+            _stats.frames_dropped += due_frame - next;
+            next = due_frame;
+        }
+
+        // the GL thread leaves slots alone until they are ready
+        auto& frame = _frames[slot];
+        lock.unlock();
+        const auto start   = std::chrono::steady_clock::now();
+        const bool decoded = _source(next, {frame.pixels, _dimensions});
+        const auto end     = std::chrono::steady_clock::now();
+        lock.lock();
+
+        if (!decoded) {
+            _ended = true;
+            _free.push_back(slot);
+            return;
+        }
+
+        frame.number  = next++;
+        frame.decoded = end;
+        ++_stats.frames_decoded;
+        _stats.decode_seconds += seconds_between(start, end);
+        _ready.push_back(slot);
+    }
+}
@@ -0,0 +1,209 @@
+#ifndef LSTREAMING_TEXTURE_HPP
+#define LSTREAMING_TEXTURE_HPP
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lopengl.hpp"
+#include "lpixel_view.hpp"
+
+// counters since the stream was opened
+struct lstream_stats {
+    std::size_t frames_decoded  = {0};
+    std::size_t frames_uploaded = {0};
+
+    // frames skipped because a later one was due, before or after decoding
+    std::size_t frames_dropped = {0};
+
+    // refreshes where the due frame was not decoded yet, the shown frame
+    // stayed up
+    std::size_t frames_late = {0};
+
+    std::size_t upload_bytes = {0};
+
+    // time the GL thread spent mapping and uploading, the stream thread
+    // decoding
+    double upload_seconds = {0};
+    double decode_seconds = {0};
+
+    // from the time a frame was due to it being uploaded
+    double latency_seconds     = {0};
+    double max_latency_seconds = {0};
+
+    // from a frame being decoded to it being uploaded, the decode-ahead
+    double queued_seconds = {0};
+};
+
+/*
+Texture whose pixels change every frame, for image sequences, recorded
+camera feeds or effects generated on the CPU. A stream thread decodes frames
+ahead into a bounded ring while the frames before them are shown; every
+update uploads the newest frame which is due. The ring is made of pixel
+unpack buffers which the GL thread invalidates and maps for the stream thread to
+decode into directly, so frames are not copied on the CPU and uploading one
+never waits for the GPU to finish reading the previous one. Frames play at
+the rate of the stream, independent of the screen: when decoding or
+uploading falls behind, overdue frames are dropped instead of played late.
+*/
+class lstreaming_texture {
+public:
+    /*
+    fills given RGBA pixels with the frame of given number, returns false
+    when the stream has no such frame; called on the stream thread
+    */
+    using frame_source =
+        std::function<bool(std::size_t frame, lpixel_view<GLuint> pixels)>;
+
+private:
+    // a slot of the ring
+    struct lframe {
+        // unpack buffer, 0 when uploading from client memory
+        GLuint buffer = {0};
+
+        // mapped buffer or storage, null while the buffer is unmapped
+        GLuint*             pixels = {nullptr};
+        std::vector<GLuint> storage;
+
+        // last attempt to map the buffer failed
+        bool map_failed = {false};
+
+        std::size_t                           number = {0};
+        std::chrono::steady_clock::time_point decoded;
+    };
+
+    GLuint                _texture_id = {0};
+    std::array<GLuint, 2> _dimensions = {0, 0};
+
+    // slots uploaded from, mapped again by the next update, or by the
+    // updates after it while mapping fails
+    std::vector<lframe>      _frames;
+    std::vector<std::size_t> _unmapped;
+
+    // map with glMapBufferRange invalidating, instead of orphaning first
+    bool _invalidate = {false};
+
+    // playback clock
+    std::chrono::steady_clock::time_point _start;
+    double                                _fps = {0};
+
+    // frame on the texture, none before the first upload
+    std::size_t _shown     = {0};
+    bool        _has_frame = {false};
+    std::size_t _last_due  = {0};
+
+    // state shared with the stream thread, slots by index
+    mutable std::mutex       _mutex;
+    std::condition_variable  _wake;
+    std::deque<std::size_t>  _ready;
+    std::vector<std::size_t> _free;
+    bool                     _stop  = {false};
+    bool                     _ended = {false};
+    lstream_stats            _stats;
+    frame_source             _source;
+    std::thread              _worker;
+
+    std::chrono::steady_clock::time_point due_time(std::size_t frame) const;
+    std::size_t due(std::chrono::steady_clock::time_point) const;
+    void        upload(lframe&);
+    void        decode();
+
+public:
+    lstreaming_texture();
+    ~lstreaming_texture();
+
+    lstreaming_texture(const lstreaming_texture&) = delete;
+    lstreaming_texture& operator=(const lstreaming_texture&) = delete;
+
+    /*
+    pre-conditions: valid GL context
+    post-conditions: returns true if the context has pixel buffer objects
+    side-effects: n/a
+    */
+    static bool supported();
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * given fps is positive and given ring holds at least two frames
+    post-conditions:
+        * creates a texture of given dimensions and starts decoding frames
+          from given source, at most given number of frames ahead
+        * plays frames at given rate from now on, uploading through unpack
+          buffers if requested and supported
+        * reports error to console if the texture could not be created
+    side-effects:
+        * binds a null-texture
+    */
+    bool open(
+        std::array<GLuint, 2> dimensions,
+        frame_source          source,
+        double                fps,
+        std::size_t           ring_frames    = 4,
+        bool                  unpack_buffers = true);
+
+    /*
+    pre-conditions: valid GL context
+    post-conditions:
+        * stops the stream thread, deletes the texture and unpack buffers
+    side-effects: n/a
+    */
+    void close();
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * called once per frame from the GL thread
+    post-conditions:
+        * uploads the newest decoded frame which is due, dropping the
+          decoded frames before it
+        * maps the slots of the ring uploaded from for the stream thread
+        * returns true if the texture changed
+    side-effects:
+        * binds a null-texture and a null unpack buffer
+    */
+    bool update();
+
+    /*
+    pre-conditions:
+        * valid GL context
+        * active modelview matrix
+    post-conditions:
+        * renders the shown frame as a quad of given size at given position,
+          nothing before the first frame arrived
+    side-effects:
+        * binds member texture id
+    */
+    void render(std::array<GLfloat, 2> point, std::array<GLfloat, 2> size);
+
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns true once the source ran out of frames and the last one is
+          shown
+    side-effects: n/a
+    */
+    bool ended() const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns counters since open
+    side-effects: n/a
+    */
+    lstream_stats stats() const;
+
+    /*
+    pre-conditions: n/a
+    post-conditions: returns texture dimensions
+    side-effects: n/a
+    */
+    std::array<GLuint, 2> get_dimensions() const;
+};
+
+#endif // LSTREAMING_TEXTURE_HPP
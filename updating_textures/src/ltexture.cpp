@@ -105,6 +105,12 @@ ltexture::data()
     return _pixels.get();
 }
 
+lpixel_view<GLuint>
+ltexture::pixels()
+{
+    return {_pixels.get(), _dimensions};
+}
+
 GLuint
 ltexture::pixel(const std::array<GLuint, 2>& point) const
 {
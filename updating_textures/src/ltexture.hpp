@@ -6,6 +6,7 @@
 #include <optional>
 
 #include "lopengl.hpp"
+#include "lpixel_view.hpp"
 #include "lrect.hpp"
 
 class ltexture {
@@ -53,6 +54,15 @@ public:
     */
     GLuint* data();
 
+    /*
+    pre-conditions: n/a
+    post-conditions:
+        * returns view of member pixels
+        * view is empty if the texture is not locked
+    side-effects: n/a
+    */
+    lpixel_view<GLuint> pixels();
+
     /*
     pre-conditions:
         * pixels available
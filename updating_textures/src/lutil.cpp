@@ -2,23 +2,123 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstring>
 #include <gsl/gsl_util>
 #include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include <IL/il.h>
 #include <IL/ilu.h>
 
 #include "lrect.hpp"
+#include "lstreaming_texture.hpp"
 #include "ltexture.hpp"
 #include "macro_helpers.hpp"
 
 namespace {
 
-static ltexture g_circle_texture;
+// frame rate of streamed image sequences
+constexpr double SEQUENCE_FPS = 30.;
 
+// benchmark_streaming plays generated frames of these sizes
+constexpr std::array<std::array<GLuint, 2>, 2> STREAM_BENCHMARK_SIZES = {
+    {{1920, 1080}, {3840, 2160}}};
+constexpr double      STREAM_BENCHMARK_FPS     = 30.;
+constexpr int         STREAM_BENCHMARK_SECONDS = 4;
+constexpr std::size_t STREAM_BENCHMARK_RING    = 4;
+
+// benchmark_pixels passes over textures of this size
+constexpr std::array<GLuint, 2> PIXEL_BENCHMARK_SIZE   = {2048, 2048};
+constexpr int                   PIXEL_BENCHMARK_PASSES = 10;
+
+static ltexture           g_circle_texture;
+static lstreaming_texture g_stream;
+
+/*
+pre-conditions:
+    * DevIL is initialized and used by no other thread
+post-conditions:
+    * decodes image at given path to RGBA into given pixels
+    * returns false if the image could not be loaded or differs in size
+side-effects: n/a
+*/
+bool
+decode_frame(std::string_view path, lpixel_view<GLuint> pixels)
+{
+    ILuint img_id = 0;
+    ilGenImages(1, &img_id);
+    ilBindImage(img_id);
+    auto _ = gsl::finally([&img_id]() { ilDeleteImages(1, &img_id); });
+
+    if (ilLoadImage(path.data()) != IL_TRUE ||
+        ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE) != IL_TRUE) {
+        std::cerr << "unable to load " << path << '\n';
+        return false;
+    }
+
+    const auto width  = static_cast<std::size_t>(ilGetInteger(IL_IMAGE_WIDTH));
+    const auto height = static_cast<std::size_t>(ilGetInteger(IL_IMAGE_HEIGHT));
+    if (width != pixels.width() || height != pixels.height()) {
+        std::cerr << path << " differs in size from the sequence\n";
+        return false;
+    }
+
+    copy(
+        lpixel_view<const GLuint>(
+            reinterpret_cast<const GLuint*>(ilGetData()),
+            width,
+            height,
+            width),
+        pixels);
+    return true;
+}
+
+/*
+pre-conditions: n/a
+post-conditions:
+    * draws frame of a moving pattern into given pixels, cheap enough to
+      stand in for a decoder
+side-effects: n/a
+*/
+bool
+generate_frame(std::size_t frame, lpixel_view<GLuint> pixels)
+{
+    const auto shift = static_cast<GLuint>(frame * 8);
+    for (std::size_t y = 0; y < pixels.height(); ++y) {
+        GLuint*      row = pixels.row(y);
+        const GLuint fy  = static_cast<GLuint>(y) + shift;
+        for (std::size_t x = 0; x < pixels.width(); ++x) {
+            const GLuint fx = static_cast<GLuint>(x) + shift;
+            row[x] = 0xff000000u | ((fx ^ fy) & 0xffu) << 16 |
+                     (fx & 0xffu) << 8 | (fy & 0xffu);
+        }
+    }
+    return true;
 }
 
+/*
+pre-conditions: n/a
+post-conditions:
+    * runs given pass over a texture the benchmark number of times, returns
+      milliseconds per pass
+side-effects: n/a
+*/
+template <typename Pass>
+double
+time_pixel_passes(Pass pass)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PIXEL_BENCHMARK_PASSES; ++i) { pass(); }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / PIXEL_BENCHMARK_PASSES;
+}
+
+} // namespace
+
 bool
 initGL()
 {
@@ -85,21 +185,16 @@ load_media(std::string_view path)
     Ac(colors)      = 0xff;
 
     // replace target color with transparent black
-    GLuint*     pixels      = g_circle_texture.data();
-    const auto& dims        = g_circle_texture.get_dimensions();
-    GLuint      pixel_count = Wv(dims) * Hv(dims);
-
-    for (int i = 0; i != gsl::narrow<int>(pixel_count); ++i) {
-        pixels[i] = pixels[i] == target_color ? 0x0 : pixels[i];
-    }
+    auto pixels = g_circle_texture.pixels();
+    transform(pixels, [target_color](GLuint pixel) {
+        return pixel == target_color ? 0u : pixel;
+    });
 
     // diagonal lines
-    for (int y = 0; y < gsl::narrow<int>(Hv(dims)); ++y) {
-        for (int x = 0; x < gsl::narrow<int>(Wv(dims)); ++x) {
-            if (y % 10 != x % 10) {
-                g_circle_texture.set_pixel(
-                    {gsl::narrow<GLuint>(x), gsl::narrow<GLuint>(y)}, 0);
-            }
+    for (std::size_t y = 0; y < pixels.height(); ++y) {
+        GLuint* row = pixels.row(y);
+        for (std::size_t x = 0; x < pixels.width(); ++x) {
+            if (y % 10 != x % 10) { row[x] = 0; }
         }
     }
 
@@ -109,10 +204,40 @@ load_media(std::string_view path)
     return true;
 }
 
+bool
+load_sequence(const std::vector<std::string_view>& paths)
+{
+    if (paths.empty()) return false;
+
+    // the first frame gives the size of the sequence
+    ILuint img_id = 0;
+    ilGenImages(1, &img_id);
+    ilBindImage(img_id);
+    const bool loaded = ilLoadImage(paths.front().data()) == IL_TRUE;
+    const std::array<GLuint, 2> dims = {
+        static_cast<GLuint>(ilGetInteger(IL_IMAGE_WIDTH)),
+        static_cast<GLuint>(ilGetInteger(IL_IMAGE_HEIGHT))};
+    ilDeleteImages(1, &img_id);
+
+    if (!loaded) {
+        std::cerr << "unable to load " << paths.front() << '\n';
+        return false;
+    }
+
+    // loops over the files, decoded on the stream thread only
+    return g_stream.open(
+        dims,
+        [paths](std::size_t frame, lpixel_view<GLuint> pixels) {
+            return decode_frame(paths[frame % paths.size()], pixels);
+        },
+        SEQUENCE_FPS);
+}
+
 void
 update()
 {
-    // TBD
+    // next frame of the sequence if one is due
+    g_stream.update();
 }
 
 void
@@ -121,13 +246,158 @@ render()
     // clear color buffer
     glClear(GL_COLOR_BUFFER_BIT);
 
-    const auto& dims = g_circle_texture.get_dimensions();
+    // a sequence takes the whole screen, the circle is shown otherwise
+    if (Wv(g_stream.get_dimensions()) != 0) {
+        g_stream.render(
+            {0.f, 0.f},
+            {gsl::narrow<GLfloat>(SCREEN_WIDTH),
+             gsl::narrow<GLfloat>(SCREEN_HEIGHT)});
+    } else {
+        const auto& dims = g_circle_texture.get_dimensions();
 
-    // render texture
-    g_circle_texture.render(
-        {gsl::narrow<float>(SCREEN_WIDTH - Wv(dims)) / 2.f,
-         gsl::narrow<float>(SCREEN_HEIGHT - Hv(dims)) / 2.f});
+        // render texture
+        g_circle_texture.render(
+            {gsl::narrow<float>(SCREEN_WIDTH - Wv(dims)) / 2.f,
+             gsl::narrow<float>(SCREEN_HEIGHT - Hv(dims)) / 2.f});
+    }
 
     // update screen
     glutSwapBuffers();
 }
+
+bool
+benchmark_streaming()
+{
+    for (const auto& dims : STREAM_BENCHMARK_SIZES) {
+        for (const bool unpack_buffers : {false, true}) {
+            if (!g_stream.open(
+                    dims,
+                    generate_frame,
+                    STREAM_BENCHMARK_FPS,
+                    STREAM_BENCHMARK_RING,
+                    unpack_buffers)) {
+                return false;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            int        frames = 0;
+            while (std::chrono::steady_clock::now() - start <
+                   std::chrono::seconds(STREAM_BENCHMARK_SECONDS)) {
+                update();
+                render();
+                glFinish();
+                ++frames;
+            }
+
+            const auto   stats    = g_stream.stats();
+            const double uploaded = static_cast<double>(stats.frames_uploaded);
+            std::cout << Wv(dims) << 'x' << Hv(dims) << " at "
+                      << STREAM_BENCHMARK_FPS << " fps, "
+                      << (unpack_buffers ? "unpack buffers" : "direct")
+                      << ": " << stats.frames_uploaded << " frames shown, "
+                      << stats.frames_dropped << " dropped, "
+                      << stats.frames_late << " late over " << frames
+                      << " refreshes\n"
+                      << "upload " << stats.upload_seconds * 1e3 / uploaded
+                      << " ms per frame, "
+                      << static_cast<double>(stats.upload_bytes) / 1e6 /
+                             stats.upload_seconds
+                      << " MB/s; decode "
+                      << stats.decode_seconds * 1e3 /
+                             static_cast<double>(stats.frames_decoded)
+                      << " ms per frame; latency "
+                      << stats.latency_seconds * 1e3 / uploaded
+                      << " ms average, " << stats.max_latency_seconds * 1e3
+                      << " ms max; decoded "
+                      << stats.queued_seconds * 1e3 / uploaded
+                      << " ms ahead\n";
+        }
+    }
+
+    // back to the circle
+    g_stream.close();
+    return true;
+}
+
+bool
+benchmark_pixels()
+{
+    // a pattern to key out and copy from
+    std::vector<GLuint> pattern(
+        std::size_t{Wv(PIXEL_BENCHMARK_SIZE)} * Hv(PIXEL_BENCHMARK_SIZE));
+    generate_frame(0, {pattern.data(), PIXEL_BENCHMARK_SIZE});
+
+    ltexture source;
+    ltexture dest;
+    if (!source.load_from_pixels32(pattern.data(), PIXEL_BENCHMARK_SIZE) ||
+        !dest.load_from_pixels32(pattern.data(), PIXEL_BENCHMARK_SIZE) ||
+        !source.lock() || !dest.lock()) {
+        return false;
+    }
+
+    // per-pixel passes are written the way load_media used to, coordinates
+    // narrowed and the index recomputed for every pixel
+    const auto width     = gsl::narrow<int>(Wv(PIXEL_BENCHMARK_SIZE));
+    const auto height    = gsl::narrow<int>(Hv(PIXEL_BENCHMARK_SIZE));
+    const auto per_pixel = [&](auto function) {
+        return time_pixel_passes([&]() {
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    const std::array<GLuint, 2> point = {
+                        gsl::narrow<GLuint>(x), gsl::narrow<GLuint>(y)};
+                    function(point, x, y);
+                }
+            }
+        });
+    };
+
+    const GLuint key    = pattern[0];
+    const auto   pixels = dest.pixels();
+    const auto   passes = std::array{
+        std::tuple{
+            "fill",
+            per_pixel([&](auto point, int, int) { dest.set_pixel(point, 0); }),
+            time_pixel_passes([&]() { fill(pixels, 0u); })},
+        std::tuple{
+            "color key",
+            per_pixel([&](auto point, int, int) {
+                const GLuint pixel = dest.pixel(point);
+                dest.set_pixel(point, pixel == key ? 0u : pixel);
+            }),
+            time_pixel_passes([&]() {
+                transform(pixels, [key](GLuint pixel) {
+                    return pixel == key ? 0u : pixel;
+                });
+            })},
+        std::tuple{
+            "stripes",
+            per_pixel([&](auto point, int x, int y) {
+                if (y % 10 != x % 10) { dest.set_pixel(point, 0); }
+            }),
+            time_pixel_passes([&]() {
+                for (std::size_t y = 0; y < pixels.height(); ++y) {
+                    GLuint* row = pixels.row(y);
+                    for (std::size_t x = 0; x < pixels.width(); ++x) {
+                        if (y % 10 != x % 10) { row[x] = 0; }
+                    }
+                }
+            })},
+        std::tuple{
+            "copy",
+            per_pixel([&](auto point, int, int) {
+                dest.set_pixel(point, source.pixel(point));
+            }),
+            time_pixel_passes([&]() { copy(source.pixels(), pixels); })}};
+
+    const double mpixels = static_cast<double>(pattern.size()) / 1e6;
+    std::cout << Wv(PIXEL_BENCHMARK_SIZE) << 'x' << Hv(PIXEL_BENCHMARK_SIZE)
+              << " pixels, ms per pass\n";
+    for (const auto& [name, pixel_ms, view_ms] : passes) {
+        std::cout << name << ": per pixel " << pixel_ms << " ("
+                  << mpixels * 1e3 / pixel_ms << " Mpixels/s), view "
+                  << view_ms << " (" << mpixels * 1e3 / view_ms
+                  << " Mpixels/s), " << pixel_ms / view_ms << "x\n";
+    }
+
+    return true;
+}
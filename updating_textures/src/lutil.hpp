@@ -4,6 +4,7 @@
 #include "lopengl.hpp"
 
 #include <string_view>
+#include <vector>
 
 // screen constants
 constexpr int SCREEN_WIDTH  = 640;
@@ -37,11 +38,26 @@ side-effects: n/a
 */
 bool load_media(std::string_view path);
 
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * DevIL is used by no other thread from now on
+post-conditions:
+    * streams the images at given paths as a looping sequence, shown
+      instead of the circle
+    * reports to console if the first image could not be loaded
+    * returns true if the sequence started
+side-effects: n/a
+*/
+bool load_sequence(const std::vector<std::string_view>& paths);
+
 /*
 pre-conditions: n/a
 post-conditions:
     * does per frame logic
-side-effects: n/a
+    * uploads the next frame of the sequence if it is due
+side-effects:
+    * see lstreaming_texture::update
 */
 void update();
 
@@ -57,4 +73,32 @@ side-effects:
 */
 void render();
 
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initGL succeeded
+post-conditions:
+    * streams generated 1080p and 4K frames for a few seconds each, once
+      uploading from client memory and once through unpack buffers
+    * reports frames shown, dropped and late, upload throughput and
+      latency of every run to console
+    * returns false if a streaming texture could not be created
+side-effects:
+    * see render
+*/
+bool benchmark_streaming();
+
+/*
+pre-conditions:
+    * a valid OpenGL context
+    * initGL succeeded
+post-conditions:
+    * fills, color keys, stripes and copies a 2048x2048 texture through
+      ltexture::pixel/set_pixel, then through pixel views
+    * reports times per pass and speedups to console
+    * returns false if the textures could not be created
+side-effects: n/a
+*/
+bool benchmark_pixels();
+
 #endif // LUTIL_HPP
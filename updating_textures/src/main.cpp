@@ -1,6 +1,7 @@
 #include "lutil.hpp"
 
 #include <cstdlib> // for EXIT_SUCCESS and EXIT_FAILURE
+#include <string_view>
 
 /*
 pre-condition:
@@ -38,7 +39,8 @@ main(int argc, char** args)
         return EXIT_FAILURE;
     }
 
-    auto image_file = argc > 1 ? args[1] : "../textures/circle.png";
+    auto image_file =
+        argc > 1 && args[1][0] != '-' ? args[1] : "../textures/circle.png";
 
     // load media
     if (!load_media(image_file)) {
@@ -46,6 +48,25 @@ main(int argc, char** args)
         return EXIT_FAILURE;
     }
 
+    // --stream-benchmark compares uploads of generated 1080p and 4K frames
+    // with and without unpack buffers, then exits
+    if (argc == 2 && std::string_view(args[1]) == "--stream-benchmark") {
+        return benchmark_streaming() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --pixel-benchmark compares per-pixel calls with pixel views, then
+    // exits
+    if (argc == 2 && std::string_view(args[1]) == "--pixel-benchmark") {
+        return benchmark_pixels() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --stream <images...> plays the images as a looping sequence
+    if (argc > 2 && std::string_view(args[1]) == "--stream" &&
+        !load_sequence({args + 2, args + argc})) {
+        std::cerr << "unable to stream sequence\n";
+        return EXIT_FAILURE;
+    }
+
     // set rendering function
     glutDisplayFunc(render);
 